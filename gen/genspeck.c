@@ -21,9 +21,12 @@
  */
 
 // Special-purpose compiler that generates the AVR version of Speck*.
+// With the "--simd" option, it instead generates the SSE2 and AVX2
+// versions of Speck::encryptBlocks() for x86 hosts.
 
 #include <stdio.h>
 #include <stdarg.h>
+#include <string.h>
 
 static int indent = 4;
 
@@ -879,8 +882,174 @@ static void small_dec(void)
     printf("}\n\n");
 }
 
+// Information about a SIMD instruction set for the bulk encryption code.
+typedef struct
+{
+    const char *name;       // Name of the instruction set, "sse2" or "avx2".
+    const char *target;     // Macro for the function's target attribute.
+    const char *type;       // Vector type, "__m128i" or "__m256i".
+    const char *prefix;     // Intrinsic prefix, "_mm" or "_mm256".
+    const char *suffix;     // Suffix for whole-register intrinsics.
+    int lanes;              // Number of 64-bit lanes in a vector.
+    int has_shuffle;        // Non-zero if "shuffle_epi8" is available.
+
+} SimdISA;
+
+static const SimdISA isa_sse2 =
+    {"sse2", "SPECK_SSE2_TARGET", "__m128i", "_mm", "si128", 2, 0};
+static const SimdISA isa_avx2 =
+    {"avx2", "SPECK_AVX2_TARGET", "__m256i", "_mm256", "si256", 4, 1};
+
+// Number of x/y register pairs to process in parallel.  Two independent
+// chains are enough to hide the latency of the add/rotate/xor sequence.
+#define SIMD_PAIRS 2
+
+// Print a byte shuffle mask that permutes the bytes of every 64-bit lane.
+static void simd_shuffle_mask(const SimdISA *isa, const char *name,
+                              const int perm[8])
+{
+    int lane, posn;
+    indent_printf("const %s %s = %s_setr_epi8\n", isa->type, name, isa->prefix);
+    indent_printf("    (");
+    for (lane = 0; lane < isa->lanes; ++lane) {
+        if (lane != 0 && (lane % 2) == 0) {
+            printf(",\n");
+            indent_printf("     ");
+        } else if (lane != 0) {
+            printf(", ");
+        }
+        for (posn = 0; posn < 8; ++posn) {
+            if (posn != 0)
+                printf(", ");
+            printf("%d", perm[posn] + (lane % 2) * 8);
+        }
+    }
+    printf(");\n");
+}
+
+// Byte-swap every 64-bit lane of a register, in place.
+static void simd_bswap(const SimdISA *isa, const char *reg)
+{
+    if (isa->has_shuffle) {
+        indent_printf("%s = %s_shuffle_epi8(%s, bswap);\n",
+                      reg, isa->prefix, reg);
+    } else {
+        indent_printf("%s = %s_or_%s(%s_slli_epi16(%s, 8), "
+                      "%s_srli_epi16(%s, 8));\n",
+                      reg, isa->prefix, isa->suffix,
+                      isa->prefix, reg, isa->prefix, reg);
+        indent_printf("%s = %s_shufflelo_epi16(%s, 0x1B);\n",
+                      reg, isa->prefix, reg);
+        indent_printf("%s = %s_shufflehi_epi16(%s, 0x1B);\n",
+                      reg, isa->prefix, reg);
+    }
+}
+
+// Generates a function that encrypts SIMD_PAIRS * lanes blocks at once.
+//
+// Each block is two big-endian 64-bit words x and y.  After byte-swapping,
+// the words are transposed so that one register holds the x words of
+// "lanes" blocks and its partner holds the matching y words.  Every
+// round then applies to all blocks at once with the round key broadcast
+// across the lanes.  For AVX2 the unpack operations work within 128-bit
+// halves, which permutes the blocks across lanes, but the inverse unpack
+// on output restores the original order.
+static void simd_enc(const SimdISA *isa)
+{
+    static const int bswap_perm[8] = {7, 6, 5, 4, 3, 2, 1, 0};
+    static const int rot8_perm[8] = {1, 2, 3, 4, 5, 6, 7, 0};
+    int blocks = SIMD_PAIRS * isa->lanes;
+    int regs = SIMD_PAIRS * 2;
+    int bytes = isa->lanes * 8;
+    int pair, reg;
+    const char *p = isa->prefix;
+    const char *sfx = isa->suffix;
+
+    printf("%s static void speckEncrypt%d_%s\n",
+           isa->target, blocks, isa->name);
+    printf("    (uint8_t *output, const uint8_t *input,\n");
+    printf("     const uint64_t *k, uint8_t rounds)\n");
+    printf("{\n");
+    indent_printf("// Automatically generated by the genspeck tool.\n");
+    if (isa->has_shuffle) {
+        simd_shuffle_mask(isa, "bswap", bswap_perm);
+        simd_shuffle_mask(isa, "rot8", rot8_perm);
+    }
+
+    // Load the blocks, convert them into host byte order, and transpose.
+    for (reg = 0; reg < regs; ++reg) {
+        indent_printf("%s a%d = %s_loadu_%s((const %s *)(input + %d));\n",
+                      isa->type, reg, p, sfx, isa->type, reg * bytes);
+    }
+    for (reg = 0; reg < regs; ++reg) {
+        char name[8];
+        sprintf(name, "a%d", reg);
+        simd_bswap(isa, name);
+    }
+    for (pair = 0; pair < SIMD_PAIRS; ++pair) {
+        indent_printf("%s x%d = %s_unpacklo_epi64(a%d, a%d);\n",
+                      isa->type, pair, p, pair * 2, pair * 2 + 1);
+        indent_printf("%s y%d = %s_unpackhi_epi64(a%d, a%d);\n",
+                      isa->type, pair, p, pair * 2, pair * 2 + 1);
+    }
+
+    // Perform all encryption rounds:
+    //     x = (rightRotate8(x) + y) ^ k[round];
+    //     y = leftRotate3(y) ^ x;
+    indent_printf("for (; rounds > 0; --rounds, ++k) {\n");
+    indent += 4;
+    indent_printf("%s s = %s_set1_epi64x((long long)(*k));\n", isa->type, p);
+    for (pair = 0; pair < SIMD_PAIRS; ++pair) {
+        if (isa->has_shuffle) {
+            indent_printf("x%d = %s_shuffle_epi8(x%d, rot8);\n",
+                          pair, p, pair);
+        } else {
+            indent_printf("x%d = %s_or_%s(%s_srli_epi64(x%d, 8), "
+                          "%s_slli_epi64(x%d, 56));\n",
+                          pair, p, sfx, p, pair, p, pair);
+        }
+    }
+    for (pair = 0; pair < SIMD_PAIRS; ++pair) {
+        indent_printf("x%d = %s_xor_%s(%s_add_epi64(x%d, y%d), s);\n",
+                      pair, p, sfx, p, pair, pair);
+    }
+    for (pair = 0; pair < SIMD_PAIRS; ++pair) {
+        indent_printf("y%d = %s_or_%s(%s_slli_epi64(y%d, 3), "
+                      "%s_srli_epi64(y%d, 61));\n",
+                      pair, p, sfx, p, pair, p, pair);
+    }
+    for (pair = 0; pair < SIMD_PAIRS; ++pair)
+        indent_printf("y%d = %s_xor_%s(y%d, x%d);\n", pair, p, sfx, pair, pair);
+    indent -= 4;
+    indent_printf("}\n");
+
+    // Transpose back, convert into big-endian, and store the blocks.
+    for (pair = 0; pair < SIMD_PAIRS; ++pair) {
+        indent_printf("a%d = %s_unpacklo_epi64(x%d, y%d);\n",
+                      pair * 2, p, pair, pair);
+        indent_printf("a%d = %s_unpackhi_epi64(x%d, y%d);\n",
+                      pair * 2 + 1, p, pair, pair);
+    }
+    for (reg = 0; reg < regs; ++reg) {
+        char name[8];
+        sprintf(name, "a%d", reg);
+        simd_bswap(isa, name);
+    }
+    for (reg = 0; reg < regs; ++reg) {
+        indent_printf("%s_storeu_%s((%s *)(output + %d), a%d);\n",
+                      p, sfx, isa->type, reg * bytes, reg);
+    }
+    printf("}\n\n");
+}
+
 int main(int argc, char *argv[])
 {
+    if (argc > 1 && !strcmp(argv[1], "--simd")) {
+        simd_enc(&isa_sse2);
+        simd_enc(&isa_avx2);
+        return 0;
+    }
+
     full_setkey();
     full_enc();
     full_dec();
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2015 Southern Storm Software, Pty Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+// Replays recorded noise samples through NoiseHealthTest and reports the
+// detection results and the cost per sample.  Each file is a sequence of
+// raw 8-bit samples, such as the data that a NoiseSource passes to output().
+// With no files, synthetic good, stuck and biased noise is replayed instead.
+//
+// Usage: noise-replay [-e bits] [-r rct] [-a apt] [file ...]
+
+#include "NoiseHealthTest.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+static int entropy = 8;
+static int rctCutoff = 0;
+static int aptCutoff = 0;
+static volatile uint8_t sink;
+
+static double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void replay(const char *name, const std::vector<uint8_t> &samples)
+{
+    NoiseHealthTest health;
+    health.setEntropy(entropy);
+    if (rctCutoff || aptCutoff) {
+        health.setCutoffs(rctCutoff ? rctCutoff : health.rctCutoff(),
+                          aptCutoff ? aptCutoff : health.aptCutoff());
+    }
+
+    // Detection pass: count the failing samples and note the first one.
+    size_t rctFails = 0;
+    size_t aptFails = 0;
+    long first = -1;
+    for (size_t posn = 0; posn < samples.size(); ++posn) {
+        uint8_t result = health.update(samples[posn]);
+        if (result & NOISE_HEALTH_RCT)
+            ++rctFails;
+        if (result & NOISE_HEALTH_APT)
+            ++aptFails;
+        if (result && first < 0)
+            first = (long)posn;
+    }
+
+    // Timing pass: replay the whole buffer until enough time has elapsed.
+    double start = now();
+    double elapsed;
+    size_t total = 0;
+    do {
+        health.reset();
+        sink |= health.update(samples.data(), samples.size());
+        total += samples.size();
+        elapsed = now() - start;
+    } while (elapsed < 0.2 && !samples.empty());
+
+    printf("%s: %lu samples, RCT cutoff %d, APT cutoff %d\n", name,
+           (unsigned long)samples.size(), health.rctCutoff(),
+           health.aptCutoff());
+    printf("    RCT failures: %lu, APT failures: %lu, first failure: %ld\n",
+           (unsigned long)rctFails, (unsigned long)aptFails, first);
+    if (total)
+        printf("    %.2f ns per sample\n", elapsed * 1e9 / total);
+}
+
+static uint32_t seed = 0x12345678UL;
+
+static uint8_t nextSample()
+{
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return (uint8_t)(seed >> 24);
+}
+
+static void synthetic()
+{
+    std::vector<uint8_t> samples(1 << 20);
+    size_t posn;
+
+    for (posn = 0; posn < samples.size(); ++posn)
+        samples[posn] = nextSample();
+    replay("good", samples);
+
+    for (posn = samples.size() / 2; posn < samples.size(); ++posn)
+        samples[posn] = 0x55;
+    replay("stuck after 512K", samples);
+
+    for (posn = 0; posn < samples.size(); ++posn) {
+        uint8_t sample = nextSample();
+        samples[posn] = (sample < 0x40) ? 0 : sample;
+    }
+    replay("25% zeroes", samples);
+}
+
+int main(int argc, char *argv[])
+{
+    int opt;
+    while ((opt = getopt(argc, argv, "e:r:a:")) != -1) {
+        if (opt == 'e') {
+            entropy = atoi(optarg);
+        } else if (opt == 'r') {
+            rctCutoff = atoi(optarg);
+        } else if (opt == 'a') {
+            aptCutoff = atoi(optarg);
+        } else {
+            fprintf(stderr, "Usage: %s [-e bits] [-r rct] [-a apt] [file ...]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+
+    if (optind >= argc) {
+        synthetic();
+        return 0;
+    }
+
+    for (; optind < argc; ++optind) {
+        FILE *file = fopen(argv[optind], "rb");
+        if (!file) {
+            perror(argv[optind]);
+            return 1;
+        }
+        std::vector<uint8_t> samples;
+        uint8_t buffer[4096];
+        size_t len;
+        while ((len = fread(buffer, 1, sizeof(buffer), file)) > 0)
+            samples.insert(samples.end(), buffer, buffer + len);
+        fclose(file);
+        replay(argv[optind], samples);
+    }
+    return 0;
+}
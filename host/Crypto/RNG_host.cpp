@@ -21,40 +21,112 @@
  */
 
 #include "RNG.h"
+#include "NoiseSource.h"
+#include "NoiseHarvester.h"
 #include "Crypto.h"
 #include "ChaCha.h"
 #include <string.h>
+#include <stdlib.h>
 #if defined(__linux__)
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <stdio.h>
-#include <stdlib.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#if defined(__GLIBC__) && \
+        (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 25))
+#include <sys/random.h>
+#define RNG_HAVE_GETRANDOM 1
+#endif
 #endif
 
 // Host emulation for the RNG class, using the native random number generator.
 
 #define RNG_ROUNDS          20
 #define RNG_REKEY_BLOCKS    16
-#define RNG_MORE_ENTROPY    16384
+#define RNG_MORE_ENTROPY    16384   // Reseed after this many bytes.
+#define RNG_RESEED_TIME     60      // Reseed after this many seconds.
+#define RNG_RETRY_ENTROPY   1024    // Retry interval after a failed reseed.
 
 static const char tagRNG[16] = {
     'e', 'x', 'p', 'a', 'n', 'd', ' ', '3',
     '2', '-', 'b', 'y', 't', 'e', ' ', 'k'
 };
 
+// Per-thread generator state.  Every thread that calls RNG.rand() gets
+// its own ChaCha20 state so that no locking is required on the shared
+// global RNG object.  The key is seeded lazily from the operating system
+// on the first request because the entropy timer starts at zero.
+struct RNGThreadState
+{
+    RNGThreadState();
+    ~RNGThreadState();
+
+    void rekey();
+#if RNG_BUFFER_BLOCKS > 0
+    void refill();
+    void discardBuffer();
+#endif
+    void reset();
+    void reseed();
+    void mix(const uint8_t *data, size_t len);
+    void checkReseedTime();
+
+    uint32_t block[16];
+    uint32_t stream[16];
+#if RNG_BUFFER_BLOCKS > 0
+    uint32_t buffer[RNG_BUFFER_BLOCKS * 16];
+    uint16_t bufferPosn;
+#endif
+    bool seeded;
+    bool failed;
+    unsigned long timer;
+    unsigned long forks;
+    unsigned long reseedTime;
+};
+
+static thread_local RNGThreadState rngState;
+
+// Number of times that this process has been created by fork().  A thread
+// whose state was seeded under a different count is running in a child
+// that inherited a copy of its parent's key and must reseed before use.
+// Only the child handler writes this, while it is the sole thread.
+static unsigned long rngForks = 0;
+
+#if defined(__linux__)
+
+static void rngAfterFork()
+{
+    ++rngForks;
+}
+
+static struct RNGForkHandler
+{
+    RNGForkHandler() { pthread_atfork(0, 0, rngAfterFork); }
+} rngForkHandler;
+
+#endif
+
+#if RNG_HARVEST_THREAD
+// Background thread for polling the noise sources.  Declared before
+// the RNG object so that it is destroyed after RNG's destructor has
+// stopped the thread.
+static NoiseHarvester harvester;
+#endif
+
 RNGClass::RNGClass()
-    : timer(0)
+    : count(0)
 {
-    memcpy(block, tagRNG, sizeof(tagRNG));
-    memset(block + 4, 0, 48);
 }
 
 RNGClass::~RNGClass()
 {
-    clean(block);
-    clean(stream);
+#if RNG_HARVEST_THREAD
+    harvester.stop();
+#endif
 }
 
 void RNGClass::begin(const char *tag)
@@ -63,84 +135,200 @@ void RNGClass::begin(const char *tag)
 
 void RNGClass::addNoiseSource(NoiseSource &source)
 {
+    #define MAX_NOISE_SOURCES (sizeof(noiseSources) / sizeof(noiseSources[0]))
+    if (count < MAX_NOISE_SOURCES) {
+        noiseSources[count++] = &source;
+        source.added();
+    }
 }
 
 void RNGClass::setAutoSaveTime(uint16_t minutes)
 {
 }
 
-// Get more entropy from the underlying operating system.
-static void getMoreEntropy(uint8_t *data, size_t len)
+// Get the current monotonic time in seconds.
+static unsigned long monotonicSeconds()
+{
+#if defined(__linux__)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long)ts.tv_sec;
+#else
+    return 0;
+#endif
+}
+
+#if defined(__linux__)
+
+// Persistent descriptor for /dev/urandom, used if getrandom() is missing.
+static int urandomFd = -1;
+static pthread_once_t urandomOnce = PTHREAD_ONCE_INIT;
+
+static void openURandom()
+{
+    urandomFd = open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+}
+
+#endif
+
+// Read entropy from the underlying operating system.
+static bool getSystemEntropy(uint8_t *data, size_t len)
 {
 #if defined(__linux__)
-    int fd = open("/dev/urandom", O_RDONLY);
-    if (fd < 0) {
-        perror("/dev/urandom");
-        exit(1);
+#if defined(RNG_HAVE_GETRANDOM)
+    while (len > 0) {
+        ssize_t ret = getrandom(data, len, 0);
+        if (ret < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno != ENOSYS)
+                return false;
+            break; // Kernel is too old; fall back to /dev/urandom.
+        }
+        data += ret;
+        len -= ret;
     }
-    int ret = read(fd, data, len);
-    if (ret != (int)len) {
-        if (ret < 0)
-            perror("/dev/urandom");
-        close(fd);
-        exit(1);
+    if (!len)
+        return true;
+#endif
+    pthread_once(&urandomOnce, openURandom);
+    if (urandomFd < 0)
+        return false;
+    while (len > 0) {
+        ssize_t ret = read(urandomFd, data, len);
+        if (ret < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        } else if (ret == 0) {
+            return false;
+        }
+        data += ret;
+        len -= ret;
     }
-    close(fd);
+    return true;
 #else
     #warning "TODO: No random entropy on this system!"
-    memset(data, 0xAA, len);
+    return false;
 #endif
 }
 
+// Report the first entropy failure in the process on stderr.
+static void reportEntropyFailure()
+{
+#if defined(__linux__)
+    static bool reported = false;
+    if (!reported) {
+        reported = true;
+        perror("RNG: cannot read entropy from the operating system");
+    }
+#endif
+}
+
+// Keep track of the number of bytes we have generated so that
+// we can fetch more entropy from the operating system if necessary.
+static inline void consumeEntropy(unsigned long &timer, size_t size)
+{
+    if (timer >= size)
+        timer -= size;
+    else
+        timer = 0;
+}
+
 void RNGClass::rand(uint8_t *data, size_t len)
 {
+    RNGThreadState &state = rngState;
+
+    // Discard the inherited state if we are in a freshly forked child.
+    if (state.forks != rngForks) {
+        state.reset();
+        state.forks = rngForks;
+    }
+
+#if RNG_BUFFER_BLOCKS > 0
+    // Serve small requests from the fast-key-erasure buffer.
+    if (len <= (sizeof(state.buffer) - 48)) {
+        if (len > (sizeof(state.buffer) - state.bufferPosn)) {
+            state.checkReseedTime();
+            if (!state.timer)
+                state.reseed();
+            state.refill();
+        }
+        uint8_t *buf = ((uint8_t *)state.buffer) + state.bufferPosn;
+        memcpy(data, buf, len);
+        clean(buf, len);
+        state.bufferPosn += len;
+        consumeEntropy(state.timer, len);
+        return;
+    }
+#endif
+
     // Generate the random data.
     uint8_t count = 0;
+    state.checkReseedTime();
     while (len > 0) {
         // Get more entropy from the operating system if necessary.
-        if (!timer) {
-            getMoreEntropy((uint8_t *)(block + 4), 48);
-            rekey();
-            timer = RNG_MORE_ENTROPY;
+        if (!state.timer) {
+            state.reseed();
+            state.rekey();
         }
 
         // Force a rekey if we have generated too many blocks in this request.
         if (count >= RNG_REKEY_BLOCKS) {
-            rekey();
-            count = 1;
+            state.rekey();
+            count = 0;
+        }
+
+        size_t size;
+        if (len >= 64) {
+            // Generate as many whole blocks as we can directly into the
+            // return buffer before the next rekey or reseed is due.
+            size_t blocks = len / 64;
+            if (blocks > (size_t)(RNG_REKEY_BLOCKS - count))
+                blocks = RNG_REKEY_BLOCKS - count;
+            if (blocks > (state.timer + 63) / 64)
+                blocks = (state.timer + 63) / 64;
+            ChaCha::hashCoreBlocks(data, state.block, RNG_ROUNDS, blocks);
+            count += blocks;
+            size = blocks * 64;
         } else {
+            // Increment the low counter word and generate the final block.
             ++count;
+            ++(state.block[12]);
+            ChaCha::hashCore(state.stream, state.block, RNG_ROUNDS);
+            memcpy(data, state.stream, len);
+            size = len;
         }
-
-        // Increment the low counter word and generate a new keystream block.
-        ++(block[12]);
-        ChaCha::hashCore(stream, block, RNG_ROUNDS);
-
-        // Copy the data to the return buffer.
-        size_t size = (len < 64) ? len : 64;
-        memcpy(data, stream, size);
         data += size;
         len -= size;
 
-        // Keep track of the number of bytes we have generated so that
-        // we can fetch more entropy from the operating system if necessary.
-        if (timer >= size)
-            timer -= size;
-        else
-            timer = 0;
+        consumeEntropy(state.timer, size);
     }
 
     // Force a rekey after every request.
-    rekey();
+    state.rekey();
 }
 
 bool RNGClass::available(size_t len) const
 {
-    return true;
+    // False if the last attempt to reseed this thread from the
+    // operating system failed.
+    return !rngState.failed;
 }
 
 void RNGClass::stir(const uint8_t *data, size_t len, unsigned int credit)
 {
+#if RNG_HARVEST_THREAD
+    // Noise from the harvester thread is queued for loop() to mix in.
+    if (NoiseHarvester::onHarvestThread()) {
+        harvester.push(data, len, credit);
+        return;
+    }
+#endif
+
+    // Mix the data into the calling thread's state.  The operating
+    // system is our entropy source, so there is no credit to track.
+    rngState.mix(data, len);
 }
 
 void RNGClass::save()
@@ -149,17 +337,174 @@ void RNGClass::save()
 
 void RNGClass::loop()
 {
+#if RNG_HARVEST_THREAD
+    if (harvester.running()) {
+        drainHarvest();
+        return;
+    }
+#endif
+    for (uint8_t posn = 0; posn < count; ++posn)
+        noiseSources[posn]->stir();
 }
 
 void RNGClass::destroy()
 {
+#if RNG_HARVEST_THREAD
+    stopHarvesting();
+#endif
+
+    // Only the calling thread's state can be safely destroyed.  It will
+    // be reseeded from the operating system on the next request.
+    rngState.reset();
+}
+
+#if RNG_HARVEST_THREAD
+
+bool RNGClass::startHarvesting(unsigned long interval)
+{
+    return harvester.start(noiseSources, count, interval);
 }
 
-void RNGClass::rekey()
+void RNGClass::stopHarvesting()
+{
+    harvester.stop();
+    drainHarvest();
+}
+
+void RNGClass::drainHarvest()
+{
+    uint8_t data[48];
+    unsigned int credit;
+    size_t len;
+    while ((len = harvester.pop(data, credit)) != 0)
+        stir(data, len, credit);
+    clean(data);
+}
+
+#endif
+
+RNGThreadState::RNGThreadState()
+    : seeded(false)
+    , failed(false)
+    , timer(0)
+    , forks(rngForks)
+    , reseedTime(0)
+{
+    memcpy(block, tagRNG, sizeof(tagRNG));
+    memset(block + 4, 0, 48);
+#if RNG_BUFFER_BLOCKS > 0
+    bufferPosn = sizeof(buffer);
+#endif
+}
+
+RNGThreadState::~RNGThreadState()
+{
+    clean(block);
+    clean(stream);
+#if RNG_BUFFER_BLOCKS > 0
+    clean(buffer);
+#endif
+}
+
+void RNGThreadState::rekey()
 {
     ++(block[12]);
     ChaCha::hashCore(stream, block, RNG_ROUNDS);
     memcpy(block + 4, stream, 48);
 }
 
+#if RNG_BUFFER_BLOCKS > 0
+
+void RNGThreadState::refill()
+{
+    // Generate a multi-block keystream, then immediately use the first
+    // 48 bytes as the new key and erase them from the buffer.
+    ChaCha::hashCoreBlocks((uint8_t *)buffer, block, RNG_ROUNDS,
+                           RNG_BUFFER_BLOCKS);
+    memcpy(block + 4, buffer, 48);
+    clean(buffer, 48);
+    bufferPosn = 48;
+}
+
+void RNGThreadState::discardBuffer()
+{
+    clean(buffer);
+    bufferPosn = sizeof(buffer);
+}
+
+#endif
+
+void RNGThreadState::reset()
+{
+    // Forget the key and force a fresh seed from the operating system.
+    clean(block + 4, 48);
+    clean(stream);
+#if RNG_BUFFER_BLOCKS > 0
+    discardBuffer();
+#endif
+    seeded = false;
+    timer = 0;
+}
+
+void RNGThreadState::reseed()
+{
+    // Fetch a fresh seed from the operating system for every reseed.
+    // Seeds are not fetched ahead of time because they would reveal
+    // the future keys to anyone who can read this thread's state.
+    uint8_t seed[48];
+    if (!getSystemEntropy(seed, sizeof(seed))) {
+        clean(seed);
+        reportEntropyFailure();
+
+        // The key of a thread that has never been seeded is all zeroes
+        // apart from any stir() data, so it must not produce output.
+        if (!seeded)
+            abort();
+
+        // The key already holds entropy from an earlier seed.  Keep
+        // running on it and try again soon.  available() reports the
+        // failure in the meantime.
+        failed = true;
+        timer = RNG_RETRY_ENTROPY;
+        reseedTime = monotonicSeconds();
+        return;
+    }
+
+    // Mix the seed into the key rather than replacing it so that
+    // existing entropy is never lost.
+    uint8_t *key = (uint8_t *)(block + 4);
+    for (uint8_t posn = 0; posn < 48; ++posn)
+        key[posn] ^= seed[posn];
+    clean(seed);
+    seeded = true;
+    failed = false;
+    timer = RNG_MORE_ENTROPY;
+    reseedTime = monotonicSeconds();
+}
+
+void RNGThreadState::mix(const uint8_t *data, size_t len)
+{
+    // XOR the data into the key in 48 byte chunks and rekey after each.
+    while (len > 0) {
+        size_t templen = (len < 48) ? len : 48;
+        uint8_t *key = (uint8_t *)(block + 4);
+        for (size_t posn = 0; posn < templen; ++posn)
+            key[posn] ^= data[posn];
+        rekey();
+        data += templen;
+        len -= templen;
+    }
+#if RNG_BUFFER_BLOCKS > 0
+    // Buffered output was generated before the new data was mixed in.
+    discardBuffer();
+#endif
+}
+
+void RNGThreadState::checkReseedTime()
+{
+    // Force a reseed if too much time has passed since the last one.
+    if (timer && (monotonicSeconds() - reseedTime) >= RNG_RESEED_TIME)
+        timer = 0;
+}
+
 RNGClass RNG;
@@ -166,6 +166,58 @@ unsigned long millis()
     return tv.tv_sec * 1000UL + tv.tv_nsec / 1000000UL;
 }
 
+void delay(unsigned long ms)
+{
+    struct timespec tv;
+    tv.tv_sec = ms / 1000UL;
+    tv.tv_nsec = (ms % 1000UL) * 1000000UL;
+    nanosleep(&tv, 0);
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+}
+
+static AnalogFeed analogFeed = 0;
+static AnalogInterrupt analogHandler = 0;
+static uint8_t analogPin = 0;
+
+void analogSetFeed(AnalogFeed feed)
+{
+    analogFeed = feed;
+}
+
+int analogRead(uint8_t pin)
+{
+    // Floating inputs read as mid-scale when there is no feed.
+    if (!analogFeed)
+        return 512;
+    return (*analogFeed)(pin) & 0x03FF;
+}
+
+void analogStartFreeRunning(uint8_t pin, AnalogInterrupt handler)
+{
+    analogPin = pin;
+    analogHandler = handler;
+}
+
+void analogStopFreeRunning()
+{
+    analogHandler = 0;
+}
+
+void analogConvert(unsigned count)
+{
+    while (count > 0 && analogHandler) {
+        (*analogHandler)(analogRead(analogPin));
+        --count;
+    }
+}
+
 int main(int argc, char *argv[])
 {
     // At the moment, just run the setup() function.
@@ -64,5 +64,33 @@ extern SerialClass Serial;
 
 unsigned long micros();
 unsigned long millis();
+void delay(unsigned long ms);
+
+#define INPUT   0
+#define OUTPUT  1
+#define LOW     0
+#define HIGH    1
+
+#define A0      14
+#define A1      15
+#define A2      16
+#define A3      17
+#define A4      18
+#define A5      19
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int analogRead(uint8_t pin);
+
+// Emulation of the analog-to-digital converter so that analog noise
+// sources can be regression tested on the host.  The feed function
+// supplies the value of each conversion.  In free-running mode the
+// conversions are delivered to the interrupt handler by analogConvert().
+typedef int (*AnalogFeed)(uint8_t pin);
+typedef void (*AnalogInterrupt)(int value);
+void analogSetFeed(AnalogFeed feed);
+void analogStartFreeRunning(uint8_t pin, AnalogInterrupt handler);
+void analogStopFreeRunning();
+void analogConvert(unsigned count);
 
 #endif
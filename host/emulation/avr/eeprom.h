@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2016 Southern Storm Software, Pty Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef EMUL_AVR_EEPROM_H
+#define EMUL_AVR_EEPROM_H
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <string.h>
+
+// Emulation of the avr-libc EEPROM API, backed by memory.  The contents
+// start out erased (all 0xFF) and the number of writes to each address
+// is tracked so that tests can check wear levelling.
+
+#ifndef E2END
+#define E2END 1023
+#endif
+
+struct EmulatedEEPROM
+{
+    uint8_t data[E2END + 1];
+    unsigned long writes[E2END + 1];
+
+    EmulatedEEPROM() { reset(); }
+
+    void reset()
+    {
+        memset(data, 0xFF, sizeof(data));
+        memset(writes, 0, sizeof(writes));
+    }
+};
+
+inline EmulatedEEPROM &eeprom_emulation()
+{
+    static EmulatedEEPROM eeprom;
+    return eeprom;
+}
+
+inline bool eeprom_is_ready()
+{
+    return true;
+}
+
+inline uint8_t eeprom_read_byte(const uint8_t *addr)
+{
+    return eeprom_emulation().data[(size_t)addr];
+}
+
+inline void eeprom_write_byte(uint8_t *addr, uint8_t value)
+{
+    EmulatedEEPROM &eeprom = eeprom_emulation();
+    eeprom.data[(size_t)addr] = value;
+    ++(eeprom.writes[(size_t)addr]);
+}
+
+inline void eeprom_update_byte(uint8_t *addr, uint8_t value)
+{
+    if (eeprom_read_byte(addr) != value)
+        eeprom_write_byte(addr, value);
+}
+
+inline void eeprom_read_block(void *dst, const void *src, size_t len)
+{
+    for (size_t posn = 0; posn < len; ++posn) {
+        ((uint8_t *)dst)[posn] =
+            eeprom_read_byte(((const uint8_t *)src) + posn);
+    }
+}
+
+inline void eeprom_write_block(const void *src, void *dst, size_t len)
+{
+    for (size_t posn = 0; posn < len; ++posn) {
+        eeprom_write_byte(((uint8_t *)dst) + posn,
+                          ((const uint8_t *)src)[posn]);
+    }
+}
+
+#endif
@@ -541,7 +541,7 @@ limb_t BigNumberUtil::sub(limb_t *result, const limb_t *x,
  * \param y Points to the second value to multiply.
  * \param ycount The number of limbs in \a y.
  *
- * \sa mul_P()
+ * \sa mul_P(), mulKaratsuba()
  */
 void BigNumberUtil::mul(limb_t *result, const limb_t *x, size_t xcount,
                         const limb_t *y, size_t ycount)
@@ -580,6 +580,127 @@ void BigNumberUtil::mul(limb_t *result, const limb_t *x, size_t xcount,
     }
 }
 
+// Adds "x" into "r" and propagates the carry through the rest of "r".
+static limb_t addInPlace(limb_t *r, size_t rsize, const limb_t *x, size_t xsize)
+{
+    dlimb_t carry = 0;
+    rsize -= xsize;
+    while (xsize > 0) {
+        carry += *r;
+        carry += *x++;
+        *r++ = (limb_t)carry;
+        carry >>= LIMB_BITS;
+        --xsize;
+    }
+    while (rsize > 0) {
+        carry += *r;
+        *r++ = (limb_t)carry;
+        carry >>= LIMB_BITS;
+        --rsize;
+    }
+    return (limb_t)carry;
+}
+
+// Subtracts "x" from "r" and propagates the borrow through the rest of "r".
+static void subInPlace(limb_t *r, size_t rsize, const limb_t *x, size_t xsize)
+{
+    dlimb_t borrow = 0;
+    rsize -= xsize;
+    while (xsize > 0) {
+        borrow = ((dlimb_t)(*r)) - (*x++) - ((borrow >> LIMB_BITS) & 0x01);
+        *r++ = (limb_t)borrow;
+        --xsize;
+    }
+    while (rsize > 0) {
+        borrow = ((dlimb_t)(*r)) - ((borrow >> LIMB_BITS) & 0x01);
+        *r++ = (limb_t)borrow;
+        --rsize;
+    }
+}
+
+// Adds "x & mask" into "r" and returns the carry out.
+static limb_t addMasked(limb_t *r, const limb_t *x, size_t size, limb_t mask)
+{
+    dlimb_t carry = 0;
+    while (size > 0) {
+        carry += *r;
+        carry += (*x++ & mask);
+        *r++ = (limb_t)carry;
+        carry >>= LIMB_BITS;
+        --size;
+    }
+    return (limb_t)carry;
+}
+
+/**
+ * \brief Multiplies two big numbers of the same size using Karatsuba's method.
+ *
+ * \param result The result of the multiplication.  The array must be
+ * 2 * \a size limbs in size and must not overlap with \a x, \a y,
+ * or \a scratch.
+ * \param x Points to the first value to multiply.
+ * \param y Points to the second value to multiply.  This can be the
+ * same as \a x.
+ * \param size The number of limbs in \a x and \a y.
+ * \param scratch Scratch space for intermediate values, which must be
+ * at least BIGNUMBER_KARATSUBA_SCRATCH(\a size) limbs in size.
+ *
+ * Operands of BIGNUMBER_KARATSUBA_THRESHOLD limbs or more are split
+ * into two halves, replacing one large product with three half-sized
+ * products.  The halves are split again while they are still above the
+ * threshold, and smaller products are computed with mul().
+ *
+ * The multiplication is performed in constant time for a given \a size.
+ * Intermediate values are left in \a scratch and it is the caller's
+ * responsibility to clean it afterwards if necessary.
+ *
+ * \sa mul()
+ */
+void BigNumberUtil::mulKaratsuba(limb_t *result, const limb_t *x,
+                                 const limb_t *y, size_t size,
+                                 limb_t *scratch)
+{
+    // Small operands are faster with the schoolbook method.
+    if (size < BIGNUMBER_KARATSUBA_THRESHOLD || size < 2) {
+        mul(result, x, size, y, size);
+        return;
+    }
+
+    // Split x and y into x0 + x1 * B^low and y0 + y1 * B^low.
+    size_t low = size / 2;
+    size_t high = size - low;
+    limb_t *xsum = scratch;
+    limb_t *ysum = scratch + high;
+    limb_t *mid = scratch + high * 2;
+    limb_t *next = mid + high * 2 + 1;
+
+    // Put x0 * y0 into the low half of the result and x1 * y1 into the
+    // high half.  The recursive calls can use all of the scratch space.
+    mulKaratsuba(result, x, y, low, scratch);
+    mulKaratsuba(result + low * 2, x + low, y + low, high, scratch);
+
+    // Compute x0 + x1 and y0 + y1, keeping the carries out.
+    memcpy(xsum, x + low, high * sizeof(limb_t));
+    limb_t xcarry = addInPlace(xsum, high, x, low);
+    memcpy(ysum, y + low, high * sizeof(limb_t));
+    limb_t ycarry = addInPlace(ysum, high, y, low);
+
+    // Multiply the sums, including the carry bits.  The full product
+    // is (xsum + xcarry * B^high) * (ysum + ycarry * B^high), where the
+    // cross terms are added in with masks to avoid data-dependent branches.
+    mulKaratsuba(mid, xsum, ysum, high, next);
+    limb_t top = xcarry & ycarry;
+    top += addMasked(mid + high, ysum, high, (~xcarry) + 1);
+    top += addMasked(mid + high, xsum, high, (~ycarry) + 1);
+    mid[high * 2] = top;
+
+    // Subtract x0 * y0 and x1 * y1 to get the middle term and add it
+    // into the result.  The final carry out is always zero.
+    subInPlace(mid, high * 2 + 1, result, low * 2);
+    subInPlace(mid, high * 2 + 1, result + low * 2, high * 2);
+    addInPlace(result + low, size * 2 - low, mid, high * 2 + 1);
+}
+
 /**
  * \brief Reduces \a x modulo \a y using subtraction.
  *
@@ -767,3 +888,276 @@ limb_t BigNumberUtil::isZero(const limb_t *x, size_t size)
     }
     return (limb_t)(((((dlimb_t)1) << LIMB_BITS) - word) >> LIMB_BITS);
 }
+
+// Extracts a bit from an exponent in RAM or program memory.
+static limb_t exponentBit(const limb_t *e, size_t bit, bool progMem)
+{
+    limb_t word;
+    if (progMem)
+        word = pgm_read_limb(&(e[bit / LIMB_BITS]));
+    else
+        word = e[bit / LIMB_BITS];
+    return (word >> (bit % LIMB_BITS)) & 0x01;
+}
+
+// Common implementation of pow(), pow_P(), powResume() and powResume_P().
+// If "started" is true, then the exponentiation continues on from the
+// value that is already in "result".
+static void powWindow(limb_t *result, const limb_t *x, const limb_t *e,
+                      size_t ebits, size_t size, BigNumberMulFunc mul,
+                      BigNumberSquareFunc square, limb_t *table,
+                      uint8_t window, bool progMem, bool started)
+{
+    size_t index, len;
+    uint8_t value;
+
+    // Precompute the odd powers x, x^3, x^5, ... in the table.  x^2 is
+    // held in the last entry until that entry is overwritten with the
+    // highest odd power, so that "result" is not disturbed.
+    memcpy(table, x, size * sizeof(limb_t));
+    if (window > 1) {
+        size_t last = (((size_t)1) << (window - 1)) - 1;
+        square(table + last * size, x);
+        for (index = 1; index <= last; ++index)
+            mul(table + index * size, table + (index - 1) * size,
+                table + last * size);
+    }
+
+    // Scan the exponent from the most significant bit down, looking for
+    // windows of up to "window" bits that start and end with a 1 bit.
+    index = ebits;
+    while (index > 0) {
+        if (!exponentBit(e, index - 1, progMem)) {
+            if (started)
+                square(result, result);
+            --index;
+            continue;
+        }
+        len = window;
+        if (len > index)
+            len = index;
+        while (!exponentBit(e, index - len, progMem))
+            --len;
+        value = 0;
+        while (len > 0) {
+            --index;
+            --len;
+            value = (value << 1) | (uint8_t)exponentBit(e, index, progMem);
+            if (started)
+                square(result, result);
+        }
+        if (started) {
+            mul(result, result, table + (value >> 1) * size);
+        } else {
+            memcpy(result, table + (value >> 1) * size, size * sizeof(limb_t));
+            started = true;
+        }
+    }
+
+    // If the exponent is zero, then the result is 1.
+    if (!started) {
+        memset(result, 0, size * sizeof(limb_t));
+        result[0] = 1;
+    }
+}
+
+/**
+ * \brief Raises a field element to a power using a sliding window.
+ *
+ * \param result The result of the exponentiation, which must be \a size
+ * limbs in size and must not overlap with \a x or \a table.
+ * \param x The value to raise, which must be \a size limbs in size.
+ * \param e Points to the exponent, starting with the least significant limb.
+ * \param ebits The number of bits in the exponent.
+ * \param size The size of field elements in limbs.
+ * \param mul Multiplies two field elements.  The result must be allowed
+ * to be the same array as either of the inputs.
+ * \param square Squares a field element.  The result must be allowed
+ * to be the same array as the input.
+ * \param table Table of 2^(\a window - 1) field elements of \a size limbs
+ * each, which is used to hold the odd powers of \a x.
+ * \param window The size of the window in bits, between 1 and 8.
+ *
+ * The number of multiplications and squarings depends only upon the
+ * value of \a e, so this function runs in constant time with respect to
+ * \a x when \a e is a publicly-known value such as p - 2.  It should not
+ * be used with secret exponents.
+ *
+ * Larger windows reduce the number of multiplications at the cost of a
+ * larger table.  A window size of 4 or 5 is usually best for exponents
+ * of a few hundred bits.  On exit, \a table will contain powers of \a x
+ * that the caller may need to clean.
+ *
+ * \sa pow_P(), powChain_P()
+ */
+void BigNumberUtil::pow(limb_t *result, const limb_t *x, const limb_t *e,
+                        size_t ebits, size_t size, BigNumberMulFunc mul,
+                        BigNumberSquareFunc square, limb_t *table,
+                        uint8_t window)
+{
+    powWindow(result, x, e, ebits, size, mul, square, table, window,
+              false, false);
+}
+
+/**
+ * \brief Raises a field element to a power using a sliding window, where
+ * the exponent is in program memory.
+ *
+ * \param result The result of the exponentiation, which must be \a size
+ * limbs in size and must not overlap with \a x or \a table.
+ * \param x The value to raise, which must be \a size limbs in size.
+ * \param e Points to the exponent, starting with the least significant limb.
+ * This must point into program memory.
+ * \param ebits The number of bits in the exponent.
+ * \param size The size of field elements in limbs.
+ * \param mul Multiplies two field elements.
+ * \param square Squares a field element.
+ * \param table Table of 2^(\a window - 1) field elements of \a size limbs
+ * each, which is used to hold the odd powers of \a x.
+ * \param window The size of the window in bits, between 1 and 8.
+ *
+ * See pow() for more information on the parameters.
+ *
+ * \sa pow(), powChain_P()
+ */
+void BigNumberUtil::pow_P(limb_t *result, const limb_t *x, const limb_t *e,
+                          size_t ebits, size_t size, BigNumberMulFunc mul,
+                          BigNumberSquareFunc square, limb_t *table,
+                          uint8_t window)
+{
+    powWindow(result, x, e, ebits, size, mul, square, table, window,
+              true, false);
+}
+
+/**
+ * \brief Continues an exponentiation from an existing value using a
+ * sliding window.
+ *
+ * \param result On entry, the value to continue from.  On exit, that value
+ * raised to the power of 2^\a ebits and multiplied by \a x to the power
+ * of \a e.  It must be \a size limbs in size and must not overlap with
+ * \a x or \a table.
+ * \param x The value to raise, which must be \a size limbs in size.
+ * \param e Points to the exponent, starting with the least significant limb.
+ * \param ebits The number of bits in the exponent.
+ * \param size The size of field elements in limbs.
+ * \param mul Multiplies two field elements.
+ * \param square Squares a field element.
+ * \param table Table of 2^(\a window - 1) field elements of \a size limbs
+ * each, which is used to hold the odd powers of \a x.
+ * \param window The size of the window in bits, between 1 and 8.
+ *
+ * This is used to finish an exponentiation whose top bits were handled
+ * some other way, such as by an addition chain.  Each bit of \a e costs
+ * one squaring of \a result, plus one multiplication for each window.
+ *
+ * See pow() for more information on the parameters.
+ *
+ * \sa pow(), powResume_P()
+ */
+void BigNumberUtil::powResume(limb_t *result, const limb_t *x, const limb_t *e,
+                              size_t ebits, size_t size, BigNumberMulFunc mul,
+                              BigNumberSquareFunc square, limb_t *table,
+                              uint8_t window)
+{
+    powWindow(result, x, e, ebits, size, mul, square, table, window,
+              false, true);
+}
+
+/**
+ * \brief Continues an exponentiation from an existing value using a
+ * sliding window, where the exponent is in program memory.
+ *
+ * \param result On entry, the value to continue from.  On exit, that value
+ * raised to the power of 2^\a ebits and multiplied by \a x to the power
+ * of \a e.
+ * \param x The value to raise, which must be \a size limbs in size.
+ * \param e Points to the exponent, starting with the least significant limb.
+ * This must point into program memory.
+ * \param ebits The number of bits in the exponent.
+ * \param size The size of field elements in limbs.
+ * \param mul Multiplies two field elements.
+ * \param square Squares a field element.
+ * \param table Table of 2^(\a window - 1) field elements of \a size limbs
+ * each, which is used to hold the odd powers of \a x.
+ * \param window The size of the window in bits, between 1 and 8.
+ *
+ * See powResume() for more information on the parameters.
+ *
+ * \sa powResume(), pow_P()
+ */
+void BigNumberUtil::powResume_P(limb_t *result, const limb_t *x,
+                                const limb_t *e, size_t ebits, size_t size,
+                                BigNumberMulFunc mul,
+                                BigNumberSquareFunc square, limb_t *table,
+                                uint8_t window)
+{
+    powWindow(result, x, e, ebits, size, mul, square, table, window,
+              true, true);
+}
+
+/**
+ * \brief Raises a field element to a power using an addition chain.
+ *
+ * \param regs The registers that the addition chain operates on.
+ * \a regs[0] is the result, \a regs[1] is the value to raise,
+ * and the remaining entries are temporaries.
+ * \param chain The steps in the addition chain, ending with
+ * BIGNUMBER_CHAIN_END.  This must point into program memory.
+ * \param mul Multiplies two field elements.  The result must be allowed
+ * to be the same array as either of the inputs.
+ * \param square Squares a field element.  The result must be allowed
+ * to be the same array as the input.
+ *
+ * Addition chains are the fastest way to raise values to fixed powers
+ * such as p - 2 for inversion and (p + 1) / 4 for square roots.  They are
+ * written at compile time using the BIGNUMBER_CHAIN_SQUARE() and
+ * BIGNUMBER_CHAIN_MUL() macros:
+ *
+ * \code
+ * // Raise x to the power of 2^4 - 1 using one temporary.
+ * static uint8_t const chain[] PROGMEM = {
+ *     BIGNUMBER_CHAIN_SQUARE(0, 1, 1),     // r = x^2
+ *     BIGNUMBER_CHAIN_MUL(0, 0, 1),        // r = x^3
+ *     BIGNUMBER_CHAIN_SQUARE(2, 0, 2),     // t = x^12
+ *     BIGNUMBER_CHAIN_MUL(0, 0, 2),        // r = x^15
+ *     BIGNUMBER_CHAIN_END
+ * };
+ * limb_t t[NUM_LIMBS];
+ * limb_t *regs[3] = {result, (limb_t *)x, t};
+ * BigNumberUtil::powChain_P(regs, chain, mul, square);
+ * \endcode
+ *
+ * BIGNUMBER_CHAIN_SQUARE(dest, src, count) squares \a src \a count times
+ * and puts the result into \a dest.  The \a count must be between 1 and
+ * 255.  BIGNUMBER_CHAIN_MUL(dest, x, y) multiplies \a x by \a y and
+ * puts the result into \a dest.
+ *
+ * The sequence of operations is fixed by the chain, so this function
+ * runs in constant time with respect to the value being raised.
+ *
+ * \sa pow_P()
+ */
+void BigNumberUtil::powChain_P(limb_t * const *regs, const uint8_t *chain,
+                               BigNumberMulFunc mul,
+                               BigNumberSquareFunc square)
+{
+    uint8_t op, arg1, arg2;
+    for (;;) {
+        op = pgm_read_byte(chain);
+        if (op == BIGNUMBER_CHAIN_END)
+            break;
+        arg1 = pgm_read_byte(chain + 1);
+        arg2 = pgm_read_byte(chain + 2);
+        chain += 3;
+        if ((op & 0xF0) == 0x10) {
+            square(regs[op & 0x0F], regs[arg1]);
+            while (arg2 > 1) {
+                square(regs[op & 0x0F], regs[op & 0x0F]);
+                --arg2;
+            }
+        } else {
+            mul(regs[op & 0x0F], regs[arg1], regs[arg2]);
+        }
+    }
+}
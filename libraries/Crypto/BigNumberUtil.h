@@ -69,6 +69,54 @@ typedef unsigned __int128 dlimb_t;
 #error "limb_t must be 8, 16, 32, or 64 bits in size"
 #endif
 
+// Operand size in limbs at which BigNumberUtil::mulKaratsuba() stops
+// using the schoolbook method and splits the operands in half.
+#ifndef BIGNUMBER_KARATSUBA_THRESHOLD
+#define BIGNUMBER_KARATSUBA_THRESHOLD 16
+#endif
+
+// Number of limbs of scratch space that BigNumberUtil::mulKaratsuba()
+// needs for operands of "size" limbs.  Each level of recursion that
+// splits its operands needs 4 * ceil(n / 2) + 1 limbs for the half sums
+// and the middle product, and the levels below it reuse the rest.
+// Valid for up to (BIGNUMBER_KARATSUBA_THRESHOLD - 1) * 1024 limbs.
+#define BIGNUMBER_KARATSUBA_HALF(n) (((n) + 1) / 2)
+#define BIGNUMBER_KARATSUBA_LEVEL(n) \
+    (((n) >= BIGNUMBER_KARATSUBA_THRESHOLD && (n) >= 2) ? \
+        (4 * BIGNUMBER_KARATSUBA_HALF(n) + 1) : 0)
+#define BIGNUMBER_KARATSUBA_SCRATCH2(n) \
+    (BIGNUMBER_KARATSUBA_LEVEL(n) + \
+     BIGNUMBER_KARATSUBA_LEVEL(BIGNUMBER_KARATSUBA_HALF(n)))
+#define BIGNUMBER_KARATSUBA_SCRATCH4(n) \
+    (BIGNUMBER_KARATSUBA_SCRATCH2(n) + \
+     BIGNUMBER_KARATSUBA_SCRATCH2(BIGNUMBER_KARATSUBA_HALF( \
+        BIGNUMBER_KARATSUBA_HALF(n))))
+#define BIGNUMBER_KARATSUBA_SCRATCH8(n) \
+    (BIGNUMBER_KARATSUBA_SCRATCH4(n) + \
+     BIGNUMBER_KARATSUBA_SCRATCH4(BIGNUMBER_KARATSUBA_HALF( \
+        BIGNUMBER_KARATSUBA_HALF(BIGNUMBER_KARATSUBA_HALF( \
+        BIGNUMBER_KARATSUBA_HALF(n))))))
+#define BIGNUMBER_KARATSUBA_SCRATCH(size) \
+    (BIGNUMBER_KARATSUBA_SCRATCH8(size) + \
+     BIGNUMBER_KARATSUBA_SCRATCH2(BIGNUMBER_KARATSUBA_HALF( \
+        BIGNUMBER_KARATSUBA_HALF(BIGNUMBER_KARATSUBA_HALF( \
+        BIGNUMBER_KARATSUBA_HALF(BIGNUMBER_KARATSUBA_HALF( \
+        BIGNUMBER_KARATSUBA_HALF(BIGNUMBER_KARATSUBA_HALF( \
+        BIGNUMBER_KARATSUBA_HALF(size))))))))))
+
+// Field multiplication and squaring callbacks for exponentiation.
+typedef void (*BigNumberMulFunc)(limb_t *result, const limb_t *x, const limb_t *y);
+typedef void (*BigNumberSquareFunc)(limb_t *result, const limb_t *x);
+
+// Steps in an addition chain for BigNumberUtil::powChain_P().  Each step
+// names registers by index: 0 is the result, 1 is the base, and 2 onwards
+// are temporaries.  Up to 16 registers can be used.
+#define BIGNUMBER_CHAIN_SQUARE(dest, src, count) \
+    (0x10 | (dest)), (src), (count)
+#define BIGNUMBER_CHAIN_MUL(dest, x, y) \
+    (0x20 | (dest)), (x), (y)
+#define BIGNUMBER_CHAIN_END 0x00
+
 class BigNumberUtil
 {
 public:
@@ -87,6 +135,9 @@ public:
                       const limb_t *y, size_t size);
     static void mul(limb_t *result, const limb_t *x, size_t xcount,
                     const limb_t *y, size_t ycount);
+    static void mulKaratsuba(limb_t *result, const limb_t *x,
+                             const limb_t *y, size_t size,
+                             limb_t *scratch);
     static void reduceQuick(limb_t *result, const limb_t *x,
                             const limb_t *y, size_t size);
 
@@ -101,6 +152,25 @@ public:
 
     static limb_t isZero(const limb_t *x, size_t size);
 
+    static void pow(limb_t *result, const limb_t *x, const limb_t *e,
+                    size_t ebits, size_t size, BigNumberMulFunc mul,
+                    BigNumberSquareFunc square, limb_t *table,
+                    uint8_t window);
+    static void pow_P(limb_t *result, const limb_t *x, const limb_t *e,
+                      size_t ebits, size_t size, BigNumberMulFunc mul,
+                      BigNumberSquareFunc square, limb_t *table,
+                      uint8_t window);
+    static void powResume(limb_t *result, const limb_t *x, const limb_t *e,
+                          size_t ebits, size_t size, BigNumberMulFunc mul,
+                          BigNumberSquareFunc square, limb_t *table,
+                          uint8_t window);
+    static void powResume_P(limb_t *result, const limb_t *x, const limb_t *e,
+                            size_t ebits, size_t size, BigNumberMulFunc mul,
+                            BigNumberSquareFunc square, limb_t *table,
+                            uint8_t window);
+    static void powChain_P(limb_t * const *regs, const uint8_t *chain,
+                           BigNumberMulFunc mul, BigNumberSquareFunc square);
+
 private:
     // Constructor and destructor are private - cannot instantiate this class.
     BigNumberUtil() {}
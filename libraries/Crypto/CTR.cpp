@@ -27,7 +27,7 @@
 /**
  * \class CTRCommon CTR.h <CTR.h>
  * \brief Concrete base class to assist with implementing CTR mode for
- * 128-bit block ciphers.
+ * 64-bit and 128-bit block ciphers.
  *
  * Reference: http://en.wikipedia.org/wiki/Block_cipher_mode_of_operation
  *
@@ -43,6 +43,7 @@ CTRCommon::CTRCommon()
     : blockCipher(0)
     , posn(16)
     , counterStart(0)
+    , blockLen(16)
 {
 }
 
@@ -61,15 +62,16 @@ size_t CTRCommon::keySize() const
 
 size_t CTRCommon::ivSize() const
 {
-    return 16;
+    return blockLen;
 }
 
 /**
  * \brief Sets the counter size for the IV.
  *
  * \param size The number of bytes on the end of the counter block
- * that are relevant when incrementing, between 1 and 16.
- * \return Returns false if the \a size value is not between 1 and 16.
+ * that are relevant when incrementing, between 1 and the block size.
+ * \return Returns false if the \a size value is not between 1 and
+ * the block size.
  *
  * When the counter is incremented during encrypt(), only the last
  * \a size bytes are considered relevant.  This can be useful
@@ -78,23 +80,23 @@ size_t CTRCommon::ivSize() const
  * should explicitly generate a new initial counter value and key long
  * before the \a size bytes overflow and wrap around.
  *
- * By default, the counter size is 16 which is the same as the block size
+ * By default, the counter size is the same as the block size
  * of the underlying block cipher.
  *
  * \sa setIV()
  */
 bool CTRCommon::setCounterSize(size_t size)
 {
-    if (size < 1 || size > 16)
+    if (size < 1 || size > blockLen)
         return false;
-    counterStart = 16 - size;
+    counterStart = blockLen - size;
     return true;
 }
 
 bool CTRCommon::setKey(const uint8_t *key, size_t len)
 {
     // Verify the cipher's block size, just in case.
-    if (blockCipher->blockSize() != 16)
+    if (blockLen != 8 && blockLen != 16)
         return false;
 
     // Set the key on the underlying block cipher.
@@ -105,9 +107,11 @@ bool CTRCommon::setKey(const uint8_t *key, size_t len)
  * \brief Sets the initial counter value to use for future encryption and
  * decryption operations.
  *
- * \param iv The initial counter value which must contain exactly 16 bytes.
- * \param len The length of the counter value, which mut be 16.
- * \return Returns false if \a len is not exactly 16.
+ * \param iv The initial counter value which must be the same size
+ * as the block, usually 16 bytes.
+ * \param len The length of the counter value, which must be the same
+ * as the block size.
+ * \return Returns false if \a len is not the same as the block size.
  *
  * The precise method to generate the initial counter is not defined by
  * this class.  Usually higher level protocols like SSL/TLS and SSH
@@ -118,17 +122,17 @@ bool CTRCommon::setKey(const uint8_t *key, size_t len)
  */
 bool CTRCommon::setIV(const uint8_t *iv, size_t len)
 {
-    if (len != 16)
+    if (len != blockLen)
         return false;
     memcpy(counter, iv, len);
-    posn = 16;
+    posn = blockLen;
     return true;
 }
 
 void CTRCommon::encrypt(uint8_t *output, const uint8_t *input, size_t len)
 {
     while (len > 0) {
-        if (posn >= 16) {
+        if (posn >= blockLen) {
             // Generate a new encrypted counter block.
             blockCipher->encryptBlock(state, counter);
             posn = 0;
@@ -138,7 +142,7 @@ void CTRCommon::encrypt(uint8_t *output, const uint8_t *input, size_t len)
             // We iterate through the entire counter region even
             // if we could stop earlier because a byte is non-zero.
             uint16_t temp = 1;
-            uint8_t index = 16;
+            uint8_t index = blockLen;
             while (index > counterStart) {
                 --index;
                 temp += counter[index];
@@ -146,7 +150,7 @@ void CTRCommon::encrypt(uint8_t *output, const uint8_t *input, size_t len)
                 temp >>= 8;
             }
         }
-        uint8_t templen = 16 - posn;
+        uint8_t templen = blockLen - posn;
         if (templen > len)
             templen = len;
         len -= templen;
@@ -167,7 +171,7 @@ void CTRCommon::clear()
     blockCipher->clear();
     clean(counter);
     clean(state);
-    posn = 16;
+    posn = blockLen;
 }
 
 /**
@@ -175,16 +179,17 @@ void CTRCommon::clear()
  * \brief Sets the block cipher to use for this CTR object.
  *
  * \param cipher The block cipher to use to implement CTR mode,
- * which must have a block size of 16 bytes (128 bits).
+ * which must have a block size of 8 or 16 bytes (64 or 128 bits).
  *
  * \note This class only works with block ciphers whose block size is
- * 16 bytes (128 bits).  If the \a cipher has a different block size,
- * then setKey() will fail and return false.
+ * 8 or 16 bytes (64 or 128 bits).  If the \a cipher has a different
+ * block size, then setKey() will fail and return false.
  */
 
 /**
  * \class CTR CTR.h <CTR.h>
- * \brief Implementation of the Counter (CTR) mode for 128-bit block ciphers.
+ * \brief Implementation of the Counter (CTR) mode for 64-bit and 128-bit
+ * block ciphers.
  *
  * Counter mode converts a block cipher into a stream cipher.  The specific
  * block cipher is passed as the template parameter T and the key is
@@ -216,5 +221,5 @@ void CTRCommon::clear()
 
 /**
  * \fn CTR::CTR()
- * \brief Constructs a new CTR object for the 128-bit block cipher T.
+ * \brief Constructs a new CTR object for the block cipher T.
  */
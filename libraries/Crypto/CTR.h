@@ -46,7 +46,11 @@ public:
 
 protected:
     CTRCommon();
-    void setBlockCipher(BlockCipher *cipher) { blockCipher = cipher; }
+    void setBlockCipher(BlockCipher *cipher)
+    {
+        blockCipher = cipher;
+        blockLen = (uint8_t)cipher->blockSize();
+    }
 
 private:
     BlockCipher *blockCipher;
@@ -54,6 +58,7 @@ private:
     uint8_t state[16];
     uint8_t posn;
     uint8_t counterStart;
+    uint8_t blockLen;
 };
 
 template <typename T>
@@ -49,6 +49,8 @@ public:
     void clear();
 
     static void hashCore(uint32_t *output, const uint32_t *input, uint8_t rounds);
+    static void hashCoreBlocks(uint8_t *output, uint32_t *input,
+                               uint8_t rounds, size_t count);
 
 private:
     uint8_t block[64];
@@ -1490,43 +1490,45 @@ void Curve25519::cmove(limb_t select, limb_t *x, const limb_t *y)
  */
 void Curve25519::pow250(limb_t *result, const limb_t *x)
 {
-    limb_t t1[NUM_LIMBS_256BIT];
-    uint8_t i, j;
-
     // The big-endian hexadecimal expansion of (2^250 - 1) is:
     // 03FFFFFF FFFFFFFF FFFFFFFF FFFFFFFF FFFFFFFF FFFFFFFF FFFFFFFF FFFFFFFF
     //
     // The naive implementation needs to do 2 multiplications per 1 bit and
-    // 1 multiplication per 0 bit.  We can improve upon this by creating a
-    // pattern 0000000001 ... 0000000001.  If we square and multiply the
-    // pattern by itself we can turn the pattern into the partial results
-    // 0000000011 ... 0000000011, 0000000111 ... 0000000111, etc.
-    // This averages out to about 1.1 multiplications per 1 bit instead of 2.
-
-    // Build a pattern of 250 bits in length of repeated copies of 0000000001.
-    #define RECIP_GROUP_SIZE 10
-    #define RECIP_GROUP_BITS 250    // Must be a multiple of RECIP_GROUP_SIZE.
-    square(t1, x);
-    for (j = 0; j < (RECIP_GROUP_SIZE - 1); ++j)
-        square(t1, t1);
-    mul(result, t1, x);
-    for (i = 0; i < ((RECIP_GROUP_BITS / RECIP_GROUP_SIZE) - 2); ++i) {
-        for (j = 0; j < RECIP_GROUP_SIZE; ++j)
-            square(t1, t1);
-        mul(result, result, t1);
-    }
-
-    // Multiply bit-shifted versions of the 0000000001 pattern into
-    // the result to "fill in" the gaps in the pattern.
-    square(t1, result);
-    mul(result, result, t1);
-    for (j = 0; j < (RECIP_GROUP_SIZE - 2); ++j) {
-        square(t1, t1);
-        mul(result, result, t1);
-    }
+    // 1 multiplication per 0 bit.  Instead we use an addition chain that
+    // builds up runs of 1 bits of increasing length.  If a(n) is x raised
+    // to the power of (2^n - 1), then a(m + n) = a(m) ^ (2^n) * a(n).
+    // The whole chain needs 249 squarings and 10 multiplications.
+    static uint8_t const chain[] PROGMEM = {
+        BIGNUMBER_CHAIN_SQUARE(0, 1, 1),    // r = a(1) ^ 2
+        BIGNUMBER_CHAIN_MUL(0, 0, 1),       // r = a(2)
+        BIGNUMBER_CHAIN_SQUARE(2, 0, 2),
+        BIGNUMBER_CHAIN_MUL(0, 2, 0),       // r = a(4)
+        BIGNUMBER_CHAIN_SQUARE(0, 0, 1),
+        BIGNUMBER_CHAIN_MUL(0, 0, 1),       // r = a(5)
+        BIGNUMBER_CHAIN_SQUARE(2, 0, 5),
+        BIGNUMBER_CHAIN_MUL(3, 2, 0),       // t2 = a(10)
+        BIGNUMBER_CHAIN_SQUARE(2, 3, 10),
+        BIGNUMBER_CHAIN_MUL(0, 2, 3),       // r = a(20)
+        BIGNUMBER_CHAIN_SQUARE(2, 0, 20),
+        BIGNUMBER_CHAIN_MUL(0, 2, 0),       // r = a(40)
+        BIGNUMBER_CHAIN_SQUARE(0, 0, 10),
+        BIGNUMBER_CHAIN_MUL(3, 0, 3),       // t2 = a(50)
+        BIGNUMBER_CHAIN_SQUARE(2, 3, 50),
+        BIGNUMBER_CHAIN_MUL(0, 2, 3),       // r = a(100)
+        BIGNUMBER_CHAIN_SQUARE(2, 0, 100),
+        BIGNUMBER_CHAIN_MUL(0, 2, 0),       // r = a(200)
+        BIGNUMBER_CHAIN_SQUARE(0, 0, 50),
+        BIGNUMBER_CHAIN_MUL(0, 0, 3),       // r = a(250)
+        BIGNUMBER_CHAIN_END
+    };
+    limb_t t1[NUM_LIMBS_256BIT];
+    limb_t t2[NUM_LIMBS_256BIT];
+    limb_t *regs[4] = {result, (limb_t *)x, t1, t2};
+    BigNumberUtil::powChain_P(regs, chain, mul, square);
 
     // Clean up and exit.
     clean(t1);
+    clean(t2);
 }
 
 /**
@@ -27,7 +27,7 @@
 /**
  * \class EAXCommon EAX.h <EAX.h>
  * \brief Concrete base class to assist with implementing EAX for
- * 128-bit block ciphers.
+ * 64-bit and 128-bit block ciphers.
  *
  * References: https://en.wikipedia.org/wiki/EAX_mode,
  * http://web.cs.ucdavis.edu/~rogaway/papers/eax.html
@@ -41,6 +41,7 @@
  * This constructor must be followed by a call to setBlockCipher().
  */
 EAXCommon::EAXCommon()
+    : blockLen(16)
 {
     state.encPosn = 0;
     state.authMode = 0;
@@ -64,8 +65,8 @@ size_t EAXCommon::ivSize() const
 
 size_t EAXCommon::tagSize() const
 {
-    // Tags can be up to 16 bytes in length.
-    return 16;
+    // Tags can be up to the block size in length.
+    return blockLen;
 }
 
 bool EAXCommon::setKey(const uint8_t *key, size_t len)
@@ -90,7 +91,7 @@ bool EAXCommon::setIV(const uint8_t *iv, size_t len)
 
     // Start the hashing context for the authenticated data.
     omac.initNext(state.hash, 1);
-    state.encPosn = 16;
+    state.encPosn = blockLen;
     state.authMode = 1;
 
     // The EAX context is ready to go.
@@ -122,15 +123,15 @@ void EAXCommon::addAuthData(const void *data, size_t len)
 void EAXCommon::computeTag(void *tag, size_t len)
 {
     closeTag();
-    if (len > 16)
-        len = 16;
+    if (len > blockLen)
+        len = blockLen;
     memcpy(tag, state.tag, len);
 }
 
 bool EAXCommon::checkTag(const void *tag, size_t len)
 {
     // Can never match if the expected tag length is too long.
-    if (len > 16)
+    if (len > blockLen)
         return false;
 
     // Compute the final tag and check it.
@@ -151,7 +152,7 @@ void EAXCommon::closeAuthData()
 {
     // Finalise the OMAC hash and XOR it with the final tag.
     omac.finalize(state.hash);
-    for (uint8_t index = 0; index < 16; ++index)
+    for (uint8_t index = 0; index < blockLen; ++index)
         state.tag[index] ^= state.hash[index];
     state.authMode = 0;
 
@@ -172,7 +173,7 @@ void EAXCommon::encryptCTR(uint8_t *output, const uint8_t *input, size_t len)
 {
     while (len > 0) {
         // Do we need to start a new block?
-        if (state.encPosn == 16) {
+        if (state.encPosn == blockLen) {
             // Encrypt the counter to create the next keystream block.
             omac.blockCipher()->encryptBlock(state.stream, state.counter);
             state.encPosn = 0;
@@ -182,7 +183,7 @@ void EAXCommon::encryptCTR(uint8_t *output, const uint8_t *input, size_t len)
             // We iterate through the entire counter region even
             // if we could stop earlier because a byte is non-zero.
             uint16_t temp = 1;
-            uint8_t index = 16;
+            uint8_t index = blockLen;
             while (index > 0) {
                 --index;
                 temp += state.counter[index];
@@ -192,7 +193,7 @@ void EAXCommon::encryptCTR(uint8_t *output, const uint8_t *input, size_t len)
         }
 
         // Encrypt/decrypt the current input block.
-        uint8_t size = 16 - state.encPosn;
+        uint8_t size = blockLen - state.encPosn;
         if (size > len)
             size = (uint8_t)len;
         for (uint8_t index = 0; index < size; ++index)
@@ -213,7 +214,7 @@ void EAXCommon::closeTag()
 
     // Finalise the hash over the ciphertext and XOR with the final tag.
     omac.finalize(state.hash);
-    for (uint8_t index = 0; index < 16; ++index)
+    for (uint8_t index = 0; index < blockLen; ++index)
         state.tag[index] ^= state.hash[index];
 }
 
@@ -222,7 +223,8 @@ void EAXCommon::closeTag()
  * \brief Sets the block cipher to use for this EAX object.
  *
  * \param cipher The block cipher to use to implement EAX mode.
- * This object must have a block size of 128 bits (16 bytes).
+ * This object must have a block size of 128 bits (16 bytes) or
+ * 64 bits (8 bytes).
  */
 
 /**
@@ -234,14 +236,15 @@ void EAXCommon::closeTag()
  *
  * The size of the key is determined by the underlying block cipher T.
  * The IV is recommended to be 128 bits (16 bytes) in length, but other
- * lengths are supported as well.  The default tagSize() is 128 bits
- * (16 bytes) but the EAX specification does allow smaller tag sizes.
+ * lengths are supported as well.  The default tagSize() is the same as
+ * the block size, usually 128 bits (16 bytes), but the EAX specification
+ * does allow smaller tag sizes.
  *
  * The template parameter T must be a concrete subclass of BlockCipher
  * indicating the specific block cipher to use.  The block cipher must
- * have a block size of 128 bits.  For example, the following creates a
- * EAX object using AES256 as the underlying cipher and then uses it
- * to encrypt and authenticate a \c plaintext block:
+ * have a block size of 128 bits or 64 bits.  For example, the following
+ * creates a EAX object using AES256 as the underlying cipher and then
+ * uses it to encrypt and authenticate a \c plaintext block:
  *
  * \code
  * EAX<AES256> eax;
@@ -54,6 +54,7 @@ protected:
     void setBlockCipher(BlockCipher *cipher)
     {
         omac.setBlockCipher(cipher);
+        blockLen = (uint8_t)cipher->blockSize();
     }
 
 private:
@@ -66,6 +67,7 @@ private:
         uint8_t authMode;
     } state;
     OMAC omac;
+    uint8_t blockLen;
 
     void closeAuthData();
     void encryptCTR(uint8_t *output, const uint8_t *input, size_t len);
@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2015 Southern Storm Software, Pty Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "NoiseExtractor.h"
+#include "Crypto.h"
+#include "utility/ProgMemUtil.h"
+
+/**
+ * \class NoiseExtractor NoiseExtractor.h <NoiseExtractor.h>
+ * \brief Von Neumann extractor for packed bits from a noise source.
+ *
+ * Noise sources that produce one raw bit per sample, such as
+ * TransistorNoiseSource and RingOscillatorNoiseSource, pack their samples
+ * into bytes with the earliest sample in the most significant bit.
+ * This class removes the bias from the samples using the Von Neumann
+ * method: each pair of bits is discarded if both bits are the same, or
+ * the second bit of the pair is kept if they are different.
+ *
+ * Rather than considering one bit at a time, the extractor looks up all
+ * four pairs in a byte with a single table access and appends the
+ * surviving bits to the output in one step.  The number of one bits
+ * in the raw samples is counted at the same time so that sources can
+ * track the median of their input signal without a second pass.
+ *
+ * Debiased bits accumulate in a 32-byte buffer until full() returns true.
+ * Extra bits after that point are discarded.
+ *
+ * \sa TransistorNoiseSource, RingOscillatorNoiseSource
+ */
+
+/** @cond */
+
+// Von Neumann extraction of the four bit pairs in a byte.  The high
+// nibble is the number of bits that survive and the low nibble contains
+// the bits themselves, with the first pair in the most significant bit.
+static uint8_t const vonNeumann[256] PROGMEM = {
+    0x00, 0x11, 0x10, 0x00, 0x11, 0x23, 0x22, 0x11,
+    0x10, 0x21, 0x20, 0x10, 0x00, 0x11, 0x10, 0x00,
+    0x11, 0x23, 0x22, 0x11, 0x23, 0x37, 0x36, 0x23,
+    0x22, 0x35, 0x34, 0x22, 0x11, 0x23, 0x22, 0x11,
+    0x10, 0x21, 0x20, 0x10, 0x21, 0x33, 0x32, 0x21,
+    0x20, 0x31, 0x30, 0x20, 0x10, 0x21, 0x20, 0x10,
+    0x00, 0x11, 0x10, 0x00, 0x11, 0x23, 0x22, 0x11,
+    0x10, 0x21, 0x20, 0x10, 0x00, 0x11, 0x10, 0x00,
+    0x11, 0x23, 0x22, 0x11, 0x23, 0x37, 0x36, 0x23,
+    0x22, 0x35, 0x34, 0x22, 0x11, 0x23, 0x22, 0x11,
+    0x23, 0x37, 0x36, 0x23, 0x37, 0x4F, 0x4E, 0x37,
+    0x36, 0x4D, 0x4C, 0x36, 0x23, 0x37, 0x36, 0x23,
+    0x22, 0x35, 0x34, 0x22, 0x35, 0x4B, 0x4A, 0x35,
+    0x34, 0x49, 0x48, 0x34, 0x22, 0x35, 0x34, 0x22,
+    0x11, 0x23, 0x22, 0x11, 0x23, 0x37, 0x36, 0x23,
+    0x22, 0x35, 0x34, 0x22, 0x11, 0x23, 0x22, 0x11,
+    0x10, 0x21, 0x20, 0x10, 0x21, 0x33, 0x32, 0x21,
+    0x20, 0x31, 0x30, 0x20, 0x10, 0x21, 0x20, 0x10,
+    0x21, 0x33, 0x32, 0x21, 0x33, 0x47, 0x46, 0x33,
+    0x32, 0x45, 0x44, 0x32, 0x21, 0x33, 0x32, 0x21,
+    0x20, 0x31, 0x30, 0x20, 0x31, 0x43, 0x42, 0x31,
+    0x30, 0x41, 0x40, 0x30, 0x20, 0x31, 0x30, 0x20,
+    0x10, 0x21, 0x20, 0x10, 0x21, 0x33, 0x32, 0x21,
+    0x20, 0x31, 0x30, 0x20, 0x10, 0x21, 0x20, 0x10,
+    0x00, 0x11, 0x10, 0x00, 0x11, 0x23, 0x22, 0x11,
+    0x10, 0x21, 0x20, 0x10, 0x00, 0x11, 0x10, 0x00,
+    0x11, 0x23, 0x22, 0x11, 0x23, 0x37, 0x36, 0x23,
+    0x22, 0x35, 0x34, 0x22, 0x11, 0x23, 0x22, 0x11,
+    0x10, 0x21, 0x20, 0x10, 0x21, 0x33, 0x32, 0x21,
+    0x20, 0x31, 0x30, 0x20, 0x10, 0x21, 0x20, 0x10,
+    0x00, 0x11, 0x10, 0x00, 0x11, 0x23, 0x22, 0x11,
+    0x10, 0x21, 0x20, 0x10, 0x00, 0x11, 0x10, 0x00
+};
+
+/** @endcond */
+
+/**
+ * \brief Constructs a new Von Neumann extractor with an empty buffer.
+ */
+NoiseExtractor::NoiseExtractor()
+{
+    reset();
+}
+
+/**
+ * \brief Destroys this extractor and cleans up any sensitive data.
+ */
+NoiseExtractor::~NoiseExtractor()
+{
+    clean(buffer);
+    acc = 0;
+}
+
+/**
+ * \brief Extracts debiased bits from a buffer of packed samples.
+ *
+ * \param data Points to the packed samples, 8 samples per byte with the
+ * earliest sample in the most significant bit.
+ * \param len Number of bytes of packed samples in \a data.
+ *
+ * \return Returns the number of one bits in the raw samples.
+ *
+ * \sa full(), data(), size()
+ */
+unsigned NoiseExtractor::extract(const uint8_t *data, size_t len)
+{
+    unsigned ones = 0;
+    while (len > 0) {
+        uint8_t bits = *data++;
+        --len;
+
+        // Count the one bits in parallel.
+        uint8_t count = bits - ((bits >> 1) & 0x55);
+        count = (count & 0x33) + ((count >> 2) & 0x33);
+        ones += (count + (count >> 4)) & 0x0F;
+
+        // Append the bits that survive debiasing to the accumulator.
+        // Only the low 11 bits of the accumulator are significant.
+        uint8_t entry = pgm_read_byte(&(vonNeumann[bits]));
+        uint8_t num = entry >> 4;
+        acc = (acc << num) | (entry & 0x0F);
+        accBits += num;
+        if (accBits >= 8) {
+            accBits -= 8;
+            if (posn < NOISE_EXTRACTOR_SIZE)
+                buffer[posn++] = (uint8_t)(acc >> accBits);
+        }
+    }
+    return ones;
+}
+
+/**
+ * \fn const uint8_t *NoiseExtractor::data() const
+ * \brief Returns a pointer to the debiased output bytes.
+ *
+ * \sa size(), extract()
+ */
+
+/**
+ * \fn size_t NoiseExtractor::size() const
+ * \brief Returns the number of complete bytes of debiased output.
+ *
+ * \sa data(), full()
+ */
+
+/**
+ * \fn bool NoiseExtractor::full() const
+ * \brief Determine if the output buffer is full.
+ *
+ * \sa size(), reset()
+ */
+
+/**
+ * \brief Resets the extractor and discards all output.
+ */
+void NoiseExtractor::reset()
+{
+    clean(buffer);
+    posn = 0;
+    accBits = 0;
+    acc = 0;
+}
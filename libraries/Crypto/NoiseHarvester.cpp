@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2015 Southern Storm Software, Pty Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "NoiseHarvester.h"
+#include "NoiseSource.h"
+#include "Crypto.h"
+#include <string.h>
+
+#if RNG_HARVEST_THREAD
+
+#include <unistd.h>
+
+/**
+ * \class NoiseHarvester NoiseHarvester.h <NoiseHarvester.h>
+ * \brief Polls noise sources from a background thread.
+ *
+ * This class is used internally by \link RNGClass RNG\endlink to
+ * implement \link RNGClass::startHarvesting() RNG.startHarvesting()\endlink
+ * and is not normally used directly by applications.
+ *
+ * The harvester thread calls NoiseSource::stir() on each registered
+ * noise source in turn and then sleeps for the polling interval.
+ * The noise that the sources output is queued in a single-producer,
+ * single-consumer ring buffer without locking.  The thread that calls
+ * \link RNGClass::loop() RNG.loop()\endlink pops the queued noise and
+ * mixes it into the random number pool.  If the ring is full then new
+ * noise is dropped rather than blocking the harvester.
+ *
+ * \sa RNGClass::startHarvesting()
+ */
+
+// Set on the harvester thread so that RNG.stir() knows to queue the
+// noise rather than mixing it into the pool directly.
+static __thread bool harvestThread = false;
+
+/**
+ * \brief Constructs a new noise harvester that is not running.
+ */
+NoiseHarvester::NoiseHarvester()
+    : head(0)
+    , tail(0)
+    , active(false)
+    , stopping(false)
+    , sources(0)
+    , count(0)
+    , interval(0)
+{
+}
+
+/**
+ * \brief Stops the harvester thread and destroys the queued noise.
+ */
+NoiseHarvester::~NoiseHarvester()
+{
+    stop();
+    clean(ring);
+}
+
+/**
+ * \brief Starts the harvester thread.
+ *
+ * \param sources The noise sources to poll.
+ * \param count The number of noise sources.
+ * \param interval The number of milliseconds to sleep between polls.
+ *
+ * \return Returns true if the thread was started, or false if it is
+ * already running or could not be created.
+ *
+ * The list of noise sources must not change while the thread is running.
+ *
+ * \sa stop()
+ */
+bool NoiseHarvester::start(NoiseSource **sources, uint8_t count,
+                           unsigned long interval)
+{
+    if (active)
+        return false;
+    this->sources = sources;
+    this->count = count;
+    this->interval = interval;
+    __atomic_store_n(&stopping, false, __ATOMIC_RELAXED);
+    if (pthread_create(&thread, 0, run, this) != 0)
+        return false;
+    active = true;
+    return true;
+}
+
+/**
+ * \brief Stops the harvester thread and waits for it to exit.
+ *
+ * Noise that was queued before the thread stopped can still be popped.
+ *
+ * \sa start()
+ */
+void NoiseHarvester::stop()
+{
+    if (!active)
+        return;
+    __atomic_store_n(&stopping, true, __ATOMIC_RELAXED);
+    pthread_join(thread, 0);
+    active = false;
+}
+
+/**
+ * \brief Determine if the harvester thread is running.
+ */
+bool NoiseHarvester::running() const
+{
+    return active;
+}
+
+/**
+ * \brief Determine if the caller is running on a harvester thread.
+ */
+bool NoiseHarvester::onHarvestThread()
+{
+    return harvestThread;
+}
+
+/**
+ * \brief Queues noise from the harvester thread.
+ *
+ * \param data Points to the noise data.
+ * \param len Number of bytes of noise data.
+ * \param credit The number of bits of entropy to credit for the data.
+ *
+ * \return Returns false if some of the data was dropped because the
+ * ring is full.
+ *
+ * Data longer than 48 bytes is split across several ring entries,
+ * with the credit capped at 8 bits per byte in each entry.
+ *
+ * This function must only be called by the producer thread.
+ */
+bool NoiseHarvester::push(const uint8_t *data, size_t len, unsigned int credit)
+{
+    // An empty entry would look like an empty ring to pop().
+    if (!len)
+        return true;
+    do {
+        uint8_t posn = head;
+        uint8_t end = __atomic_load_n(&tail, __ATOMIC_ACQUIRE);
+        if ((uint8_t)(posn - end) >= NOISE_HARVEST_SLOTS)
+            return false;
+        Entry &entry = ring[posn & (NOISE_HARVEST_SLOTS - 1)];
+        size_t templen = (len < sizeof(entry.data)) ? len : sizeof(entry.data);
+        unsigned int tempcredit = (credit < templen * 8) ? credit : templen * 8;
+        entry.len = (uint8_t)templen;
+        entry.credit = (uint16_t)tempcredit;
+        memcpy(entry.data, data, templen);
+        __atomic_store_n(&head, (uint8_t)(posn + 1), __ATOMIC_RELEASE);
+        data += templen;
+        len -= templen;
+        credit -= tempcredit;
+    } while (len > 0);
+    return true;
+}
+
+/**
+ * \brief Pops the next entry of queued noise.
+ *
+ * \param data Buffer of at least 48 bytes to receive the noise data.
+ * \param credit Returns the number of bits of entropy to credit.
+ *
+ * \return Returns the number of bytes of noise in \a data, or zero if
+ * the ring is empty.  This function never waits for the producer.
+ *
+ * This function must only be called by the consumer thread.
+ */
+size_t NoiseHarvester::pop(uint8_t *data, unsigned int &credit)
+{
+    uint8_t posn = tail;
+    uint8_t end = __atomic_load_n(&head, __ATOMIC_ACQUIRE);
+    if (posn == end)
+        return 0;
+    Entry &entry = ring[posn & (NOISE_HARVEST_SLOTS - 1)];
+    size_t len = entry.len;
+    credit = entry.credit;
+    memcpy(data, entry.data, len);
+    clean(entry.data);
+    __atomic_store_n(&tail, (uint8_t)(posn + 1), __ATOMIC_RELEASE);
+    return len;
+}
+
+void *NoiseHarvester::run(void *arg)
+{
+    NoiseHarvester *harvester = (NoiseHarvester *)arg;
+    harvestThread = true;
+    while (!__atomic_load_n(&(harvester->stopping), __ATOMIC_RELAXED)) {
+        for (uint8_t posn = 0; posn < harvester->count; ++posn)
+            harvester->sources[posn]->stir();
+        usleep(harvester->interval * 1000UL);
+    }
+    return 0;
+}
+
+#endif
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2015 Southern Storm Software, Pty Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef CRYPTO_NOISEHARVESTER_H
+#define CRYPTO_NOISEHARVESTER_H
+
+#include "RNG.h"
+
+#if RNG_HARVEST_THREAD
+
+#include <pthread.h>
+
+class NoiseSource;
+
+// Number of entries in the harvest ring, which must be a power of two.
+#if !defined(NOISE_HARVEST_SLOTS)
+#define NOISE_HARVEST_SLOTS 16
+#endif
+#if NOISE_HARVEST_SLOTS < 1 || NOISE_HARVEST_SLOTS > 128 || \
+        (NOISE_HARVEST_SLOTS & (NOISE_HARVEST_SLOTS - 1)) != 0
+#error "NOISE_HARVEST_SLOTS must be a power of two between 1 and 128"
+#endif
+
+class NoiseHarvester
+{
+public:
+    NoiseHarvester();
+    ~NoiseHarvester();
+
+    bool start(NoiseSource **sources, uint8_t count, unsigned long interval);
+    void stop();
+    bool running() const;
+
+    static bool onHarvestThread();
+
+    bool push(const uint8_t *data, size_t len, unsigned int credit);
+    size_t pop(uint8_t *data, unsigned int &credit);
+
+private:
+    struct Entry
+    {
+        uint16_t credit;
+        uint8_t len;
+        uint8_t data[48];
+    };
+
+    Entry ring[NOISE_HARVEST_SLOTS];
+    uint8_t head;
+    uint8_t tail;
+    bool active;
+    bool stopping;
+    NoiseSource **sources;
+    uint8_t count;
+    unsigned long interval;
+    pthread_t thread;
+
+    static void *run(void *arg);
+};
+
+#endif
+
+#endif
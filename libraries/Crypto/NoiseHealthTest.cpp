@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2015 Southern Storm Software, Pty Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "NoiseHealthTest.h"
+#include "utility/ProgMemUtil.h"
+
+/**
+ * \class NoiseHealthTest NoiseHealthTest.h <NoiseHealthTest.h>
+ * \brief Continuous health tests for the raw output of a noise source.
+ *
+ * This class implements the Repetition Count Test (RCT) and the Adaptive
+ * Proportion Test (APT) from NIST SP 800-90B, section 4.4.  Each 8-bit
+ * sample is checked as it arrives using a handful of counters, so the
+ * cost per sample is constant and there is no window of samples to
+ * buffer and analyze.
+ *
+ * \li The RCT fails if the same sample value repeats \em rct times in a row,
+ * which detects a noise source that has become stuck.
+ * \li The APT counts how often the first sample of each 512-sample window
+ * appears in that window, and fails if it reaches \em apt occurrences.
+ * This detects a large loss of entropy due to bias.
+ *
+ * The cutoffs depend upon how much entropy each sample is claimed to have.
+ * setEntropy() selects the cutoffs from SP 800-90B for a false positive
+ * rate of 2<sup>-20</sup>, or setCutoffs() can be used to set them directly.
+ *
+ * The tests do not branch on the value of the samples.
+ *
+ * \sa NoiseSource::checkHealth()
+ */
+
+/** @cond */
+
+// Cutoffs for a false positive probability of 2^-20 and 1 to 8 bits of
+// entropy per 8-bit sample, from SP 800-90B sections 4.4.1 and 4.4.2.
+static uint8_t const rctCutoffs[8] PROGMEM = {
+    21, 11, 8, 6, 5, 5, 4, 4
+};
+static uint16_t const aptCutoffs[8] PROGMEM = {
+    311, 177, 103, 62, 39, 25, 18, 13
+};
+
+/** @endcond */
+
+/**
+ * \brief Constructs a new health test, with cutoffs for 8 bits of
+ * entropy per sample.
+ */
+NoiseHealthTest::NoiseHealthTest()
+{
+    setEntropy(8);
+    reset();
+}
+
+/**
+ * \brief Destroys this health test.
+ */
+NoiseHealthTest::~NoiseHealthTest()
+{
+}
+
+/**
+ * \brief Sets the cutoffs for the tests.
+ *
+ * \param rct The Repetition Count Test fails when this many identical
+ * samples are seen in a row.  Must be at least 2.
+ * \param apt The Adaptive Proportion Test fails when the first sample in
+ * a window appears this many times within the window.  Must be at least 2.
+ *
+ * \sa setEntropy(), rctCutoff(), aptCutoff()
+ */
+void NoiseHealthTest::setCutoffs(uint8_t rct, uint16_t apt)
+{
+    rctLimit = rct;
+    aptLimit = apt;
+}
+
+/**
+ * \brief Sets the cutoffs for the tests based on the claimed entropy.
+ *
+ * \param bits The number of bits of entropy in each 8-bit sample,
+ * between 1 and 8.  Values outside this range are clamped.
+ *
+ * \sa setCutoffs()
+ */
+void NoiseHealthTest::setEntropy(uint8_t bits)
+{
+    if (bits < 1)
+        bits = 1;
+    else if (bits > 8)
+        bits = 8;
+    rctLimit = pgm_read_byte(&(rctCutoffs[bits - 1]));
+    aptLimit = pgm_read_word(&(aptCutoffs[bits - 1]));
+}
+
+/**
+ * \fn uint8_t NoiseHealthTest::rctCutoff() const
+ * \brief Returns the cutoff for the Repetition Count Test.
+ *
+ * \sa aptCutoff(), setCutoffs()
+ */
+
+/**
+ * \fn uint16_t NoiseHealthTest::aptCutoff() const
+ * \brief Returns the cutoff for the Adaptive Proportion Test.
+ *
+ * \sa rctCutoff(), setCutoffs()
+ */
+
+/**
+ * \brief Updates the tests with a new sample.
+ *
+ * \param sample The sample from the noise source.
+ *
+ * \return Returns zero if the sample passed both tests, or a combination
+ * of NOISE_HEALTH_RCT and NOISE_HEALTH_APT for the tests that failed.
+ *
+ * A test keeps failing for as long as the condition that triggered it
+ * persists, so the caller should discard the noise from every sample
+ * that fails.
+ */
+uint8_t NoiseHealthTest::update(uint8_t sample)
+{
+    // Repetition Count Test.  "same" is 0xFF if the sample is identical
+    // to the previous one, or 0x00 if not.  The count saturates at 255.
+    uint8_t same = (uint8_t)((((uint16_t)(sample ^ rctSample)) - 1) >> 8);
+    rctCount = ((rctCount + (uint8_t)(rctCount != 0xFF)) & same) |
+               (1 & ~same);
+    rctSample = sample;
+    uint8_t result = (uint8_t)(rctCount >= rctLimit) * NOISE_HEALTH_RCT;
+
+    // Adaptive Proportion Test.  The first sample of each window is the
+    // reference that the rest of the window is compared against.
+    if (aptPosn == 0) {
+        aptSample = sample;
+        aptCount = 1;
+    } else {
+        same = (uint8_t)((((uint16_t)(sample ^ aptSample)) - 1) >> 8);
+        aptCount += same & 1;
+    }
+    if (++aptPosn >= NOISE_HEALTH_WINDOW)
+        aptPosn = 0;
+    result |= (uint8_t)(aptCount >= aptLimit) * NOISE_HEALTH_APT;
+    return result;
+}
+
+/**
+ * \brief Updates the tests with a buffer of samples.
+ *
+ * \param data Points to the samples.
+ * \param len Number of samples in \a data.
+ *
+ * \return Returns zero if all samples passed both tests, or a combination
+ * of NOISE_HEALTH_RCT and NOISE_HEALTH_APT for the tests that failed on
+ * any sample.
+ */
+uint8_t NoiseHealthTest::update(const uint8_t *data, size_t len)
+{
+    uint8_t result = 0;
+    while (len > 0) {
+        result |= update(*data++);
+        --len;
+    }
+    return result;
+}
+
+/**
+ * \brief Resets the tests to start again with the next sample.
+ *
+ * The cutoffs are not changed.
+ */
+void NoiseHealthTest::reset()
+{
+    rctSample = 0;
+    rctCount = 0;
+    aptSample = 0;
+    aptCount = 0;
+    aptPosn = 0;
+}
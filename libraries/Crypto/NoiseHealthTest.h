@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2015 Southern Storm Software, Pty Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef CRYPTO_NOISEHEALTHTEST_H
+#define CRYPTO_NOISEHEALTHTEST_H
+
+#include <inttypes.h>
+#include <stddef.h>
+
+// Number of samples in each Adaptive Proportion Test window.
+#define NOISE_HEALTH_WINDOW     512
+
+// Bits that are returned by NoiseHealthTest::update() on failure.
+#define NOISE_HEALTH_RCT        0x01
+#define NOISE_HEALTH_APT        0x02
+
+class NoiseHealthTest
+{
+public:
+    NoiseHealthTest();
+    ~NoiseHealthTest();
+
+    void setCutoffs(uint8_t rct, uint16_t apt);
+    void setEntropy(uint8_t bits);
+
+    uint8_t rctCutoff() const { return rctLimit; }
+    uint16_t aptCutoff() const { return aptLimit; }
+
+    uint8_t update(uint8_t sample);
+    uint8_t update(const uint8_t *data, size_t len);
+
+    void reset();
+
+private:
+    uint8_t rctSample;
+    uint8_t rctCount;
+    uint8_t rctLimit;
+    uint8_t aptSample;
+    uint16_t aptCount;
+    uint16_t aptPosn;
+    uint16_t aptLimit;
+};
+
+#endif
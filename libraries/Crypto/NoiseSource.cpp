@@ -34,6 +34,7 @@
  * \brief Constructs a new random noise source.
  */
 NoiseSource::NoiseSource()
+    : healthFailed(false)
 {
 }
 
@@ -63,7 +64,10 @@ NoiseSource::~NoiseSource()
  * noise source is not connected.  Noise sources may also periodically
  * recalibrate themselves.
  *
- * \sa stir()
+ * The standard noise sources also report that they are calibrating while
+ * their raw samples are failing the continuous health tests.
+ *
+ * \sa stir(), healthy()
  */
 
 /**
@@ -97,6 +101,36 @@ void NoiseSource::added()
     // Nothing to do here.
 }
 
+/**
+ * \brief Sets the cutoffs for the continuous health tests on this
+ * noise source.
+ *
+ * \param rct The Repetition Count Test fails when this many identical
+ * raw samples are seen in a row.
+ * \param apt The Adaptive Proportion Test fails when the first raw sample
+ * in a window of 512 samples appears this many times within the window.
+ *
+ * By default, the cutoffs are chosen by the noise source from the entropy
+ * that it expects in each raw sample.
+ *
+ * \sa healthy(), checkHealth()
+ */
+void NoiseSource::setHealthCutoffs(uint8_t rct, uint16_t apt)
+{
+    health.setCutoffs(rct, apt);
+}
+
+/**
+ * \fn bool NoiseSource::healthy() const
+ * \brief Determine if the last raw samples from this noise source passed
+ * the continuous health tests.
+ *
+ * \return Returns false if the noise source appears to be stuck or
+ * badly biased and its output is being discarded.
+ *
+ * \sa setHealthCutoffs(), checkHealth()
+ */
+
 /**
  * \brief Called from subclasses to output noise to the global random
  * number pool.
@@ -118,3 +152,39 @@ void NoiseSource::output(const uint8_t *data, size_t len, unsigned int credit)
 {
     RNG.stir(data, len, credit);
 }
+
+/**
+ * \brief Called from subclasses to run the continuous health tests on
+ * raw samples from the noise source.
+ *
+ * \param data Points to the raw samples, before any debiasing.
+ * \param len Number of 8-bit samples in \a data.
+ *
+ * \return Returns true if all of the samples passed the NIST SP 800-90B
+ * Repetition Count and Adaptive Proportion tests, or false if any failed.
+ *
+ * The noise source should discard the entropy that it has collected
+ * from samples that fail.  healthy() will return false until the noise
+ * source produces samples that pass.  Each sample costs constant time,
+ * so this may be called from interrupt context.
+ *
+ * \sa healthy(), setHealthEntropy()
+ */
+bool NoiseSource::checkHealth(const uint8_t *data, size_t len)
+{
+    healthFailed = (health.update(data, len) != 0);
+    return !healthFailed;
+}
+
+/**
+ * \fn void NoiseSource::setHealthEntropy(uint8_t bits)
+ * \brief Sets the default cutoffs for the continuous health tests.
+ *
+ * \param bits The number of bits of entropy in each raw 8-bit sample that
+ * is passed to checkHealth(), between 1 and 8.
+ *
+ * This is called by subclasses at construction time.
+ * setHealthCutoffs() can be used to override the defaults afterwards.
+ *
+ * \sa checkHealth(), NoiseHealthTest::setEntropy()
+ */
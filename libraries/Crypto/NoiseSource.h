@@ -25,6 +25,7 @@
 
 #include <inttypes.h>
 #include <stddef.h>
+#include "NoiseHealthTest.h"
 
 class NoiseSource
 {
@@ -37,8 +38,18 @@ public:
 
     virtual void added();
 
+    void setHealthCutoffs(uint8_t rct, uint16_t apt);
+    bool healthy() const { return !healthFailed; }
+
 protected:
     virtual void output(const uint8_t *data, size_t len, unsigned int credit);
+
+    bool checkHealth(const uint8_t *data, size_t len);
+    void setHealthEntropy(uint8_t bits) { health.setEntropy(bits); }
+
+private:
+    NoiseHealthTest health;
+    volatile bool healthFailed;
 };
 
 #endif
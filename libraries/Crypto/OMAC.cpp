@@ -23,6 +23,7 @@
 #include "OMAC.h"
 #include "GF128.h"
 #include "Crypto.h"
+#include "utility/EndianUtil.h"
 #include <string.h>
 
 /**
@@ -33,6 +34,10 @@
  * as a separate class for the convenience of applications that need
  * message authentication separate from encryption.
  *
+ * Both 128-bit and 64-bit block ciphers are supported.  The hashing
+ * contexts are always 16 bytes in size, but only the first 8 bytes
+ * are used with a 64-bit block cipher.
+ *
  * References: https://en.wikipedia.org/wiki/EAX_mode,
  * http://web.cs.ucdavis.edu/~rogaway/papers/eax.html
  *
@@ -48,6 +53,7 @@
 OMAC::OMAC()
     : _blockCipher(0)
     , posn(0)
+    , blockLen(16)
 {
 }
 
@@ -73,7 +79,8 @@ OMAC::~OMAC()
  * \brief Sets the block cipher to use for this OMAC object.
  *
  * \param cipher The block cipher to use to implement OMAC.
- * This object must have a block size of 128 bits (16 bytes).
+ * This object must have a block size of 128 bits (16 bytes) or
+ * 64 bits (8 bytes).
  *
  * \sa blockCipher()
  */
@@ -103,6 +110,7 @@ void OMAC::initFirst(uint8_t omac[16])
     // Start the OMAC context.  We assume that the data that follows
     // will be at least 1 byte in length so that we can encrypt the
     // zeroes now to derive the B value.
+    blockLen = (uint8_t)(_blockCipher->blockSize());
     memset(omac, 0, 16);
     _blockCipher->encryptBlock(omac, omac);
     posn = 0;
@@ -110,7 +118,7 @@ void OMAC::initFirst(uint8_t omac[16])
     // Generate the B value from the encrypted block of zeroes.
     // We will need this later when finalising the OMAC hashes.
     memcpy(b, omac, 16);
-    GF128::dblEAX(b);
+    dbl(b);
 }
 
 /**
@@ -126,9 +134,10 @@ void OMAC::initFirst(uint8_t omac[16])
  */
 void OMAC::initNext(uint8_t omac[16], uint8_t tag)
 {
-    memset(omac, 0, 15);
-    omac[15] = tag;
-    posn = 16;
+    blockLen = (uint8_t)(_blockCipher->blockSize());
+    memset(omac, 0, blockLen - 1);
+    omac[blockLen - 1] = tag;
+    posn = blockLen;
 }
 
 /**
@@ -144,13 +153,13 @@ void OMAC::update(uint8_t omac[16], const uint8_t *data, size_t size)
 {
     while (size > 0) {
         // Encrypt the current block if it is already full.
-        if (posn == 16) {
+        if (posn == blockLen) {
             _blockCipher->encryptBlock(omac, omac);
             posn = 0;
         }
 
         // XOR the incoming data with the current block.
-        uint8_t len = 16 - posn;
+        uint8_t len = blockLen - posn;
         if (len > size)
             len = (uint8_t)size;
         for (uint8_t index = 0; index < len; ++index)
@@ -172,18 +181,18 @@ void OMAC::update(uint8_t omac[16], const uint8_t *data, size_t size)
 void OMAC::finalize(uint8_t omac[16])
 {
     // Apply padding if necessary.
-    if (posn != 16) {
+    if (posn != blockLen) {
         // Need padding: XOR with P = 2 * B.
         uint32_t p[4];
         memcpy(p, b, 16);
-        GF128::dblEAX(p);
+        dbl(p);
         omac[posn] ^= 0x80;
-        for (uint8_t index = 0; index < 16; ++index)
+        for (uint8_t index = 0; index < blockLen; ++index)
             omac[index] ^= ((const uint8_t *)p)[index];
         clean(p);
     } else {
         // No padding necessary: XOR with B.
-        for (uint8_t index = 0; index < 16; ++index)
+        for (uint8_t index = 0; index < blockLen; ++index)
             omac[index] ^= ((const uint8_t *)b)[index];
     }
 
@@ -198,3 +207,25 @@ void OMAC::clear()
 {
     clean(b);
 }
+
+/**
+ * \brief Doubles a value in the field for the block size.
+ *
+ * \param V The value to double, and the result.  This array is
+ * assumed to be in big-endian order on entry and exit.
+ *
+ * For 64-bit block ciphers, only the first two words of \a V are
+ * used and the field is GF(2^64) with the reduction constant 0x1B.
+ */
+void OMAC::dbl(uint32_t V[4])
+{
+    if (blockLen == 8) {
+        uint32_t V0 = be32toh(V[0]);
+        uint32_t V1 = be32toh(V[1]);
+        uint32_t mask = (~((V0 >> 31) - 1)) & 0x1B;
+        V[0] = htobe32((V0 << 1) | (V1 >> 31));
+        V[1] = htobe32((V1 << 1) ^ mask);
+    } else {
+        GF128::dblEAX(V);
+    }
+}
@@ -45,6 +45,9 @@ private:
     BlockCipher *_blockCipher;
     uint32_t b[4];
     uint8_t posn;
+    uint8_t blockLen;
+
+    void dbl(uint32_t V[4]);
 };
 
 #endif
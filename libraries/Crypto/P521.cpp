@@ -63,6 +63,14 @@
 #define strict_clean(x)     do { ; } while (0)
 #endif
 
+// Size of the sliding window to use in recipQ().  The table needs
+// 2^(P521_RECIPQ_WINDOW - 1) 521-bit entries, so keep it small on AVR.
+#if defined(__AVR__)
+#define P521_RECIPQ_WINDOW  2
+#else
+#define P521_RECIPQ_WINDOW  4
+#endif
+
 // Expand the partial 9-bit left over limb at the top of a 521-bit number.
 #if BIGNUMBER_LIMB_8BIT
 #define LIMB_PARTIAL(value) ((uint8_t)(value)), \
@@ -911,6 +919,10 @@ void P521::reduceQuick(limb_t *x)
  * \param y The second value to multiply, which must be NUM_LIMBS_521BIT
  * limbs in size.
  *
+ * On platforms where NUM_LIMBS_521BIT is at least
+ * BIGNUMBER_KARATSUBA_THRESHOLD, the multiplication is performed with
+ * BigNumberUtil::mulKaratsuba().
+ *
  * \sa mul()
  */
 void P521::mulNoReduce(limb_t *result, const limb_t *x, const limb_t *y)
@@ -921,6 +933,16 @@ void P521::mulNoReduce(limb_t *result, const limb_t *x, const limb_t *y)
     const limb_t *yy;
     limb_t *rr;
 
+    // Use Karatsuba multiplication if the limbs are small enough that
+    // 521-bit operands are above the threshold.  The test is on constants
+    // so the compiler will discard whichever path is not needed.
+    if (NUM_LIMBS_521BIT >= BIGNUMBER_KARATSUBA_THRESHOLD) {
+        limb_t scratch[BIGNUMBER_KARATSUBA_SCRATCH(NUM_LIMBS_521BIT)];
+        BigNumberUtil::mulKaratsuba(result, x, y, NUM_LIMBS_521BIT, scratch);
+        strict_clean(scratch);
+        return;
+    }
+
     // Multiply the lowest word of x by y.
     carry = 0;
     word = x[0];
@@ -1329,45 +1351,54 @@ void P521::cmove1(limb_t select, limb_t *x)
  */
 void P521::recip(limb_t *result, const limb_t *x)
 {
-    limb_t t1[NUM_LIMBS_521BIT];
-
     // The reciprocal is the same as x ^ (p - 2) where p = 2^521 - 1.
     // The big-endian hexadecimal expansion of (p - 2) is:
     // 01FF FFFFFFF FFFFFFFF ... FFFFFFFF FFFFFFFD
     //
     // The naive implementation needs to do 2 multiplications per 1 bit and
-    // 1 multiplication per 0 bit.  We can improve upon this by creating a
-    // pattern 1111 and then shifting and multiplying to create 11111111,
-    // and then 1111111111111111, and so on for the top 512-bits.
-
-    // Build a 4-bit pattern 1111 in the result.
-    square(result, x);
-    mul(result, result, x);
-    square(result, result);
-    mul(result, result, x);
-    square(result, result);
-    mul(result, result, x);
-
-    // Shift and multiply by increasing powers of two.  This turns
-    // 1111 into 11111111, and then 1111111111111111, and so on.
-    for (size_t power = 4; power <= 256; power <<= 1) {
-        square(t1, result);
-        for (size_t temp = 1; temp < power; ++temp)
-            square(t1, t1);
-        mul(result, result, t1);
-    }
-
-    // Handle the 9 lowest bits of (p - 2), 111111101, from highest to lowest.
-    for (uint8_t index = 0; index < 7; ++index) {
-        square(result, result);
-        mul(result, result, x);
-    }
-    square(result, result);
-    square(result, result);
-    mul(result, result, x);
+    // 1 multiplication per 0 bit.  Instead we use an addition chain that
+    // builds up runs of 1 bits of increasing length.  If a(n) is x raised
+    // to the power of (2^n - 1), then a(m + n) = a(m) ^ (2^n) * a(n).
+    // The top 519 bits are a(519) = a(512) ^ (2^7) * a(7) and then
+    // the 2 lowest bits 01 are handled at the end.
+    static uint8_t const chain[] PROGMEM = {
+        BIGNUMBER_CHAIN_SQUARE(0, 1, 1),
+        BIGNUMBER_CHAIN_MUL(0, 0, 1),       // r = a(2)
+        BIGNUMBER_CHAIN_SQUARE(3, 0, 1),
+        BIGNUMBER_CHAIN_MUL(3, 3, 1),       // t2 = a(3)
+        BIGNUMBER_CHAIN_SQUARE(2, 0, 2),
+        BIGNUMBER_CHAIN_MUL(0, 2, 0),       // r = a(4)
+        BIGNUMBER_CHAIN_SQUARE(2, 0, 3),
+        BIGNUMBER_CHAIN_MUL(3, 2, 3),       // t2 = a(7)
+        BIGNUMBER_CHAIN_SQUARE(2, 0, 4),
+        BIGNUMBER_CHAIN_MUL(0, 2, 0),       // r = a(8)
+        BIGNUMBER_CHAIN_SQUARE(2, 0, 8),
+        BIGNUMBER_CHAIN_MUL(0, 2, 0),       // r = a(16)
+        BIGNUMBER_CHAIN_SQUARE(2, 0, 16),
+        BIGNUMBER_CHAIN_MUL(0, 2, 0),       // r = a(32)
+        BIGNUMBER_CHAIN_SQUARE(2, 0, 32),
+        BIGNUMBER_CHAIN_MUL(0, 2, 0),       // r = a(64)
+        BIGNUMBER_CHAIN_SQUARE(2, 0, 64),
+        BIGNUMBER_CHAIN_MUL(0, 2, 0),       // r = a(128)
+        BIGNUMBER_CHAIN_SQUARE(2, 0, 128),
+        BIGNUMBER_CHAIN_MUL(0, 2, 0),       // r = a(256)
+        BIGNUMBER_CHAIN_SQUARE(2, 0, 128),
+        BIGNUMBER_CHAIN_SQUARE(2, 2, 128),
+        BIGNUMBER_CHAIN_MUL(0, 2, 0),       // r = a(512)
+        BIGNUMBER_CHAIN_SQUARE(0, 0, 7),
+        BIGNUMBER_CHAIN_MUL(0, 0, 3),       // r = a(519)
+        BIGNUMBER_CHAIN_SQUARE(0, 0, 2),
+        BIGNUMBER_CHAIN_MUL(0, 0, 1),       // r = x ^ (p - 2)
+        BIGNUMBER_CHAIN_END
+    };
+    limb_t t1[NUM_LIMBS_521BIT];
+    limb_t t2[NUM_LIMBS_521BIT];
+    limb_t *regs[4] = {result, (limb_t *)x, t1, t2};
+    BigNumberUtil::powChain_P(regs, chain, mul, square);
 
     // Clean up.
     clean(t1);
+    clean(t2);
 }
 
 /**
@@ -1471,35 +1502,41 @@ void P521::recipQ(limb_t *result, const limb_t *x)
         LIMB_PARTIAL(0x1fa)
     };
 
-    // Raise x to the power of q - 2, mod q.  We start with the top
-    // 256 bits which are all-1's, using a similar technique to recip().
+    // Raise x to the power of 2^256 - 1, mod q, using an addition chain
+    // that is similar to the one in recip().
+    static uint8_t const chain[] PROGMEM = {
+        BIGNUMBER_CHAIN_SQUARE(0, 1, 1),
+        BIGNUMBER_CHAIN_MUL(0, 0, 1),       // r = a(2)
+        BIGNUMBER_CHAIN_SQUARE(2, 0, 2),
+        BIGNUMBER_CHAIN_MUL(0, 2, 0),       // r = a(4)
+        BIGNUMBER_CHAIN_SQUARE(2, 0, 4),
+        BIGNUMBER_CHAIN_MUL(0, 2, 0),       // r = a(8)
+        BIGNUMBER_CHAIN_SQUARE(2, 0, 8),
+        BIGNUMBER_CHAIN_MUL(0, 2, 0),       // r = a(16)
+        BIGNUMBER_CHAIN_SQUARE(2, 0, 16),
+        BIGNUMBER_CHAIN_MUL(0, 2, 0),       // r = a(32)
+        BIGNUMBER_CHAIN_SQUARE(2, 0, 32),
+        BIGNUMBER_CHAIN_MUL(0, 2, 0),       // r = a(64)
+        BIGNUMBER_CHAIN_SQUARE(2, 0, 64),
+        BIGNUMBER_CHAIN_MUL(0, 2, 0),       // r = a(128)
+        BIGNUMBER_CHAIN_SQUARE(2, 0, 128),
+        BIGNUMBER_CHAIN_MUL(0, 2, 0),       // r = a(256)
+        BIGNUMBER_CHAIN_END
+    };
     limb_t t1[NUM_LIMBS_521BIT];
-    mulQ(result, x, x);
-    mulQ(result, result, x);
-    mulQ(result, result, result);
-    mulQ(result, result, x);
-    mulQ(result, result, result);
-    mulQ(result, result, x);
-    for (size_t power = 4; power <= 128; power <<= 1) {
-        mulQ(t1, result, result);
-        for (size_t temp = 1; temp < power; ++temp)
-            mulQ(t1, t1, t1);
-        mulQ(result, result, t1);
-    }
-    clean(t1);
+    limb_t *regs[3] = {result, (limb_t *)x, t1};
+    BigNumberUtil::powChain_P(regs, chain, mulQ, squareQ);
 
-    // Deal with the bottom 265 bits from highest to lowest.  Square for
-    // each bit and multiply in x whenever there is a 1 bit.  The timing
-    // is based on the publicly-known constant q - 2, not on the value of x.
-    size_t bit = 265;
-    while (bit > 0) {
-        --bit;
-        mulQ(result, result, result);
-        if (pgm_read_limb(&(P521_q_m2[bit / LIMB_BITS])) &
-                (((limb_t)1) << (bit % LIMB_BITS))) {
-            mulQ(result, result, x);
-        }
-    }
+    // Continue with the bottom 265 bits using a sliding window, which
+    // squares the result once per bit.  The timing is based on the
+    // publicly-known constant q - 2, not on the value of x.
+    limb_t table[NUM_LIMBS_521BIT << (P521_RECIPQ_WINDOW - 1)];
+    BigNumberUtil::powResume_P(result, x, P521_q_m2, 265, NUM_LIMBS_521BIT,
+                               mulQ, squareQ, table, P521_RECIPQ_WINDOW);
+
+    // Clean up.
+    clean(t1);
+    clean(table);
 }
 
 /**
@@ -97,6 +97,10 @@ private:
 
     static void reduceQ(limb_t *result, const limb_t *r);
     static void mulQ(limb_t *result, const limb_t *x, const limb_t *y);
+    static void squareQ(limb_t *result, const limb_t *x)
+    {
+        mulQ(result, x, x);
+    }
     static void recipQ(limb_t *result, const limb_t *x);
 
     static void generateK(uint8_t k[66], const uint8_t hm[66],
@@ -22,6 +22,8 @@
 
 #include "RNG.h"
 #include "NoiseSource.h"
+#include "NoiseHarvester.h"
+#include "SeedJournal.h"
 #include "ChaCha.h"
 #include "Crypto.h"
 #include <Arduino.h>
@@ -52,7 +54,14 @@
 #define RNG_WATCHDOG 1      // Harvest entropy from watchdog jitter.
 #endif
 
-#define RNG_EEPROM_ADDRESS (E2END + 1 - RNGClass::SEED_SIZE)
+// Number of slots in the journal of saved seeds at the end of EEPROM.
+// The default of 1 keeps the seed in the last SEED_SIZE bytes of EEPROM
+// as in earlier versions.  Define a larger value to spread the wear.
+#if !defined(RNG_SEED_SLOTS)
+#define RNG_SEED_SLOTS 1
+#endif
+#define RNG_EEPROM_ADDRESS \
+    (E2END + 1 - RNG_SEED_SLOTS * RNGClass::SEED_SIZE)
 #elif defined(ESP8266)
 // ESP8266 does not have EEPROM but it does have SPI flash memory.
 // It also has a TRNG register for generating "true" random numbers.
@@ -80,6 +89,18 @@
 #warning "no hardware random number source detected for this platform"
 #endif
 
+#if RNG_HARVEST_THREAD
+// Background thread for polling the noise sources.  Declared before
+// the RNG object so that it is destroyed after RNG's destructor has
+// stopped the thread.
+static NoiseHarvester harvester;
+#endif
+
+#if defined(RNG_EEPROM)
+// Journal of saved seeds, written out a byte at a time by loop().
+static SeedJournal journal(RNG_EEPROM_ADDRESS, RNG_SEED_SLOTS);
+#endif
+
 /**
  * \class RNGClass RNG.h <RNG.h>
  * \brief Pseudo random number generator suitable for cryptography.
@@ -143,8 +164,17 @@
  * \endcode
  *
  * The loop() function will automatically save the random number seed on a
- * regular basis to the last SEED_SIZE bytes of EEPROM memory.  By default
- * the seed is saved every hour but this can be changed using setAutoSaveTime().
+ * regular basis to the end of EEPROM memory.  By default the seed is saved
+ * every hour but this can be changed using setAutoSaveTime().
+ *
+ * On AVR platforms, the seed is saved with a sequence number and CRC-8
+ * into the last SEED_SIZE bytes of EEPROM.  Automatic saves are written
+ * one byte at a time on each call to loop() so that saving does not stall
+ * the application.  Defining RNG_SEED_SLOTS to a value greater than 1 when
+ * compiling the library turns this into a journal of that many slots at
+ * the end of EEPROM, so that each save goes to a different part of the
+ * EEPROM.  The journal then uses RNG_SEED_SLOTS * SEED_SIZE bytes, which
+ * the application must not use for its own data.
  *
  * Keep in mind that saving too often may cause the EEPROM to wear out quicker.
  * It is wise to limit saving to once an hour or once a day depending
@@ -181,8 +211,10 @@ RNGClass RNG;
  * \var RNGClass::SEED_SIZE
  * \brief Size of a saved random number seed in EEPROM space.
  *
- * The seed is saved into the last SEED_SIZE bytes of EEPROM memory.
- * The address is dependent upon the size of EEPROM fitted in the device.
+ * The seed is saved into the last SEED_SIZE bytes of EEPROM memory, or
+ * into one of the last RNG_SEED_SLOTS * SEED_SIZE bytes if RNG_SEED_SLOTS
+ * is greater than 1.  The address is dependent upon the size of EEPROM
+ * fitted in the device.
  */
 
 // Number of ChaCha hash rounds to use for random number generation.
@@ -320,6 +352,9 @@ RNGClass::RNGClass()
     , count(0)
     , trngPosn(0)
 {
+#if RNG_BUFFER_BLOCKS > 0
+    bufferPosn = sizeof(buffer);
+#endif
 }
 
 /**
@@ -327,6 +362,9 @@ RNGClass::RNGClass()
  */
 RNGClass::~RNGClass()
 {
+#if RNG_HARVEST_THREAD
+    harvester.stop();
+#endif
 #if defined(RNG_DUE_TRNG)
     // Disable the TRNG in the Arduino Due.
     REG_TRNG_CR = TRNG_CR_KEY(0x524E47);
@@ -351,6 +389,9 @@ RNGClass::~RNGClass()
 #endif
     clean(block);
     clean(stream);
+#if RNG_BUFFER_BLOCKS > 0
+    clean(buffer);
+#endif
 }
 
 #if defined(RNG_DUE_TRNG)
@@ -447,12 +488,10 @@ void RNGClass::begin(const char *tag)
     memcpy_P(block, tagRNG, sizeof(tagRNG));
     memcpy_P(block + 4, initRNG, sizeof(initRNG));
 #if defined(RNG_EEPROM)
-    int address = RNG_EEPROM_ADDRESS;
-    eeprom_read_block(stream, (const void *)address, SEED_SIZE);
-    if (crypto_crc8('S', stream, SEED_SIZE - 1) ==
-            ((const uint8_t *)stream)[SEED_SIZE - 1]) {
+    if (journal.load((uint8_t *)stream)) {
         // We have a saved seed: XOR it with the initialization block.
-        // Note: the CRC-8 value is included.  No point throwing it away.
+        // Note: the sequence number and CRC-8 value are included.
+        // No point throwing them away.
         for (int posn = 0; posn < 12; ++posn)
             block[posn + 4] ^= stream[posn];
     }
@@ -589,11 +628,17 @@ void RNGClass::begin(const char *tag)
               | RTC_RUNSTDBY_bm;      // enabled in standby
 #endif
 
-    // Re-save the seed to obliterate the previous value and to ensure
-    // that if the system is reset without a call to save() that we won't
-    // accidentally generate the same sequence of random data again.
+    // Save a new seed before returning so that if the system is reset
+    // without another call to save(), the next boot will not load the
+    // same seed and generate the same sequence of random data again.
+    // save() waits for the seed to be written to the journal.
     save();
 
+#if RNG_BUFFER_BLOCKS > 0
+    // Throw away anything that was buffered before we had a proper seed.
+    discardBuffer();
+#endif
+
     // The RNG has now been initialized.
     initialized = 1;
 }
@@ -657,6 +702,14 @@ void RNGClass::setAutoSaveTime(uint16_t minutes)
  * generating important values, the available() function can be
  * polled to determine when sufficient entropy is available.
  *
+ * On platforms other than AVR, small requests are served from a buffer
+ * of RNG_BUFFER_BLOCKS keystream blocks in the "fast key erasure" style.
+ * Each time the buffer is refilled, its first 48 bytes immediately become
+ * the new key and are erased from the buffer.  Bytes are also erased as
+ * they are handed out.  A compromise of the state therefore cannot reveal
+ * previous outputs.  The buffer is discarded whenever new data is stirred
+ * into the pool.
+ *
  * \sa available(), stir()
  */
 void RNGClass::rand(uint8_t *data, size_t len)
@@ -672,6 +725,28 @@ void RNGClass::rand(uint8_t *data, size_t len)
     else
         credits -= len * 8;
 
+#if RNG_BUFFER_BLOCKS > 0
+    // Serve small requests from the buffer, refilling it if necessary.
+    // Any pending TRNG data has already been XOR'ed into the state block,
+    // so it will be mixed in at the next refill.
+    if (len <= (sizeof(buffer) - 48)) {
+        if (len > (sizeof(buffer) - bufferPosn)) {
+            if (trngPending) {
+                trngPending = 0;
+                trngPosn = 0;
+            } else {
+                mixTRNG();
+            }
+            refill();
+        }
+        uint8_t *buf = ((uint8_t *)buffer) + bufferPosn;
+        memcpy(data, buf, len);
+        clean(buf, len);
+        bufferPosn += len;
+        return;
+    }
+#endif
+
     // If we have pending TRNG data from the loop() function,
     // then force a stir on the state.  Otherwise mix in some
     // fresh data from the TRNG because it is possible that
@@ -684,30 +759,30 @@ void RNGClass::rand(uint8_t *data, size_t len)
         mixTRNG();
     }
 
-    // Generate the random data.
+    // Generate whole blocks directly into the return buffer, forcing a
+    // rekey if we have generated too many blocks in this request.
     uint8_t count = 0;
-    while (len > 0) {
-        // Force a rekey if we have generated too many blocks in this request.
+    while (len >= 64) {
         if (count >= RNG_REKEY_BLOCKS) {
             rekey();
-            count = 1;
-        } else {
-            ++count;
+            count = 0;
         }
+        size_t blocks = len / 64;
+        if (blocks > (size_t)(RNG_REKEY_BLOCKS - count))
+            blocks = RNG_REKEY_BLOCKS - count;
+        ChaCha::hashCoreBlocks(data, block, RNG_ROUNDS, blocks);
+        count += blocks;
+        data += blocks * 64;
+        len -= blocks * 64;
+    }
 
-        // Increment the low counter word and generate a new keystream block.
+    // Generate the final partial block, if any.
+    if (len > 0) {
+        if (count >= RNG_REKEY_BLOCKS)
+            rekey();
         ++(block[12]);
         ChaCha::hashCore(stream, block, RNG_ROUNDS);
-
-        // Copy the data to the return buffer.
-        if (len < 64) {
-            memcpy(data, stream, len);
-            break;
-        } else {
-            memcpy(data, stream, 64);
-            data += 64;
-            len -= 64;
-        }
+        memcpy(data, stream, len);
     }
 
     // Force a rekey after every request.
@@ -788,6 +863,14 @@ bool RNGClass::available(size_t len) const
  */
 void RNGClass::stir(const uint8_t *data, size_t len, unsigned int credit)
 {
+#if RNG_HARVEST_THREAD
+    // Noise from the harvester thread is queued for loop() to mix in.
+    if (NoiseHarvester::onHarvestThread()) {
+        harvester.push(data, len, credit);
+        return;
+    }
+#endif
+
     // Increase the entropy credit.
     if ((credit / 8) >= len && len)
         credit = len * 8;
@@ -814,6 +897,11 @@ void RNGClass::stir(const uint8_t *data, size_t len, unsigned int credit)
             }
             rekey();
         }
+
+#if RNG_BUFFER_BLOCKS > 0
+        // Buffered output was generated before the new data was mixed in.
+        discardBuffer();
+#endif
     } else {
         // There was no input data, so just force a rekey so we
         // get some mixing of the state even without new data.
@@ -853,22 +941,42 @@ void RNGClass::stir(const uint8_t *data, size_t len, unsigned int credit)
  * random state will be predictable from the seed.  For this reason it is
  * very important to stir() in new noise data at startup.
  *
+ * On AVR platforms, the seed is written to the next slot of the EEPROM
+ * journal before this function returns.  The automatic save in loop()
+ * does not wait.  Instead, subsequent calls to loop() write the slot one
+ * byte per call.  If power is lost before that write finishes and
+ * RNG_SEED_SLOTS is greater than 1, then begin() will use the seed from
+ * the previous save instead.  With a single slot, the partly written seed
+ * fails its CRC-8 check and begin() starts without a saved seed.
+ *
  * \sa loop(), stir()
  */
 void RNGClass::save()
+{
+    saveSeed();
+#if defined(RNG_EEPROM)
+    journal.flush();
+#endif
+}
+
+/**
+ * \brief Generates a new seed and saves it without waiting for slow
+ * storage.
+ *
+ * On AVR platforms, the seed is only staged in the EEPROM journal and
+ * loop() writes it out.
+ */
+void RNGClass::saveSeed()
 {
     // Generate random data from the current state and save
     // that as the seed.  Then force a rekey.
     ++(block[12]);
     ChaCha::hashCore(stream, block, RNG_ROUNDS);
 #if defined(RNG_EEPROM)
-    // We shorten the seed from 48 bytes to 47 to leave room for
-    // the CRC-8 value.  We do this to align the data on an 8-byte
-    // boundary in EERPOM.
-    int address = RNG_EEPROM_ADDRESS;
-    eeprom_write_block(stream, (void *)address, SEED_SIZE - 1);
-    eeprom_write_byte((uint8_t *)(address + SEED_SIZE - 1),
-                      crypto_crc8('S', stream, SEED_SIZE - 1));
+    // We shorten the seed from 48 bytes to 45 to leave room for the
+    // sequence number and CRC-8 value in the journal slot.  The slot
+    // is written out a byte at a time by subsequent calls to loop().
+    journal.save((const uint8_t *)stream);
 #elif defined(RNG_DUE_TRNG)
     unsigned posn;
     ((uint32_t *)(RNG_SEED_ADDR))[0] = crypto_crc8('S', stream, SEED_SIZE);
@@ -899,9 +1007,18 @@ void RNGClass::save()
  */
 void RNGClass::loop()
 {
-    // Stir in the entropy from all registered noise sources.
-    for (uint8_t posn = 0; posn < count; ++posn)
-        noiseSources[posn]->stir();
+#if RNG_HARVEST_THREAD
+    // If the noise sources are being polled in the background, then
+    // mix in whatever they have produced so far.  Otherwise poll them.
+    if (harvester.running()) {
+        drainHarvest();
+    } else
+#endif
+    {
+        // Stir in the entropy from all registered noise sources.
+        for (uint8_t posn = 0; posn < count; ++posn)
+            noiseSources[posn]->stir();
+    }
 
 #if defined(RNG_DUE_TRNG)
     // If there is data available from the Arudino Due's TRNG, then XOR
@@ -1012,7 +1129,12 @@ void RNGClass::loop()
 
     // Save the seed if the auto-save timer has expired.
     if ((millis() - timer) >= timeout)
-        save();
+        saveSeed();
+
+#if defined(RNG_EEPROM)
+    // Write the next byte of any seed that is being saved.
+    journal.poll();
+#endif
 }
 
 /**
@@ -1036,12 +1158,16 @@ void RNGClass::loop()
  */
 void RNGClass::destroy()
 {
+#if RNG_HARVEST_THREAD
+    stopHarvesting();
+#endif
     clean(block);
     clean(stream);
+#if RNG_BUFFER_BLOCKS > 0
+    discardBuffer();
+#endif
 #if defined(RNG_EEPROM)
-    int address = RNG_EEPROM_ADDRESS;
-    for (int posn = 0; posn < SEED_SIZE; ++posn)
-        eeprom_write_byte((uint8_t *)(address + posn), 0xFF);
+    journal.erase();
 #elif defined(RNG_DUE_TRNG)
     for (unsigned posn = 0; posn < (RNG_FLASH_PAGE_SIZE / 4); ++posn)
         ((uint32_t *)(RNG_SEED_ADDR))[posn] = 0xFFFFFFFF;
@@ -1057,6 +1183,63 @@ void RNGClass::destroy()
     initialized = 0;
 }
 
+#if RNG_HARVEST_THREAD
+
+/**
+ * \brief Starts polling the noise sources from a background thread.
+ *
+ * \param interval The number of milliseconds to sleep between polls.
+ *
+ * \return Returns true if the thread was started, or false if it is
+ * already running or could not be created.
+ *
+ * Normally loop() polls the noise sources by calling NoiseSource::stir()
+ * on each one, which adds the cost of collecting noise to the application's
+ * main loop.  Once this function is called, a separate thread polls the
+ * noise sources on its own schedule and queues the noise in a lock-free
+ * ring buffer.  Each call to loop() then mixes the queued noise into the
+ * random number pool without waiting for the thread.
+ *
+ * Add all noise sources with addNoiseSource() before calling this
+ * function, and call loop() from only one thread.
+ *
+ * This function is only available on platforms with POSIX threads,
+ * which is indicated by RNG_HARVEST_THREAD being non-zero.
+ *
+ * \sa stopHarvesting(), loop()
+ */
+bool RNGClass::startHarvesting(unsigned long interval)
+{
+    return harvester.start(noiseSources, count, interval);
+}
+
+/**
+ * \brief Stops polling the noise sources from a background thread.
+ *
+ * Any noise that was queued by the thread is mixed into the random
+ * number pool before this function returns.  After this, loop() will
+ * poll the noise sources itself.
+ *
+ * \sa startHarvesting()
+ */
+void RNGClass::stopHarvesting()
+{
+    harvester.stop();
+    drainHarvest();
+}
+
+void RNGClass::drainHarvest()
+{
+    uint8_t data[48];
+    unsigned int credit;
+    size_t len;
+    while ((len = harvester.pop(data, credit)) != 0)
+        stir(data, len, credit);
+    clean(data);
+}
+
+#endif
+
 /**
  * \brief Rekeys the random number generator.
  */
@@ -1078,6 +1261,38 @@ void RNGClass::rekey()
     block[13] ^= micros();
 }
 
+#if RNG_BUFFER_BLOCKS > 0
+
+/**
+ * \brief Refills the output buffer with fresh keystream data.
+ *
+ * The first 48 bytes of the new keystream replace the key and are then
+ * erased from the buffer, so the state that generated the rest of the
+ * buffer no longer exists.
+ */
+void RNGClass::refill()
+{
+    for (uint8_t index = 0; index < RNG_BUFFER_BLOCKS; ++index) {
+        ++(block[12]);
+        ChaCha::hashCore(buffer + index * 16, block, RNG_ROUNDS);
+    }
+    memcpy(block + 4, buffer, 48);
+    clean(buffer, 48);
+    bufferPosn = 48;
+    block[13] ^= micros();
+}
+
+/**
+ * \brief Erases any unused data in the output buffer.
+ */
+void RNGClass::discardBuffer()
+{
+    clean(buffer);
+    bufferPosn = sizeof(buffer);
+}
+
+#endif
+
 /**
  * \brief Mix in fresh data from the TRNG when rand() is called.
  */
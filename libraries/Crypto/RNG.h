@@ -28,6 +28,26 @@
 
 class NoiseSource;
 
+// Number of ChaCha20 blocks in the fast-key-erasure output buffer.
+// Set to zero to disable buffering of small requests.
+#if !defined(RNG_BUFFER_BLOCKS)
+#if defined(__AVR__)
+#define RNG_BUFFER_BLOCKS 0
+#else
+#define RNG_BUFFER_BLOCKS 4
+#endif
+#endif
+
+// Allow noise sources to be polled from a background thread on
+// platforms with POSIX threads.  Set to zero to disable.
+#if !defined(RNG_HARVEST_THREAD)
+#if defined(HOST_BUILD) || defined(ESP32)
+#define RNG_HARVEST_THREAD 1
+#else
+#define RNG_HARVEST_THREAD 0
+#endif
+#endif
+
 class RNGClass
 {
 public:
@@ -50,9 +70,17 @@ public:
 
     void destroy();
 
+#if RNG_HARVEST_THREAD
+    bool startHarvesting(unsigned long interval = 10);
+    void stopHarvesting();
+#endif
+
     static const int SEED_SIZE = 48;
 
 private:
+    // The host build keeps the generator state for each thread in
+    // RNG_host.cpp, so only the noise sources are stored here.
+#if !defined(HOST_BUILD)
     uint32_t block[16];
     uint32_t stream[16];
     uint16_t credits : 13;
@@ -61,12 +89,27 @@ private:
     uint16_t trngPending : 1;
     unsigned long timer;
     unsigned long timeout;
+#endif
     NoiseSource *noiseSources[4];
     uint8_t count;
+#if !defined(HOST_BUILD)
     uint8_t trngPosn;
+#if RNG_BUFFER_BLOCKS > 0
+    uint32_t buffer[RNG_BUFFER_BLOCKS * 16];
+    uint16_t bufferPosn;
+#endif
 
     void rekey();
     void mixTRNG();
+    void saveSeed();
+#if RNG_BUFFER_BLOCKS > 0
+    void refill();
+    void discardBuffer();
+#endif
+#endif
+#if RNG_HARVEST_THREAD
+    void drainHarvest();
+#endif
 };
 
 /* the STM32 tolkit defines its own RNG symbol, incompatible with the
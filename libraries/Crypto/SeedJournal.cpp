@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2015 Southern Storm Software, Pty Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "SeedJournal.h"
+#include "Crypto.h"
+#include <string.h>
+
+#if SEED_JOURNAL_EEPROM
+
+#include <avr/eeprom.h>
+
+/**
+ * \class SeedJournal SeedJournal.h <SeedJournal.h>
+ * \brief Wear-levelled journal of saved random number seeds in EEPROM.
+ *
+ * This class is used internally by \link RNGClass RNG\endlink to save
+ * the random number seed and is not normally used directly by applications.
+ *
+ * The journal rotates through a fixed number of 48-byte slots, each of
+ * which holds a 16-bit sequence number, 45 bytes of seed data, and a
+ * CRC-8 checksum.  Each save() goes into the slot after the most recent
+ * one, so that every slot sees only a fraction of the writes.  Bytes that
+ * already hold the right value are not rewritten.
+ *
+ * Writes are performed in the background by calling poll(), which writes
+ * at most one byte each time and only if the EEPROM is ready, so that
+ * a save never blocks the caller.  The checksum is written last.  If power
+ * is lost part-way through, then the slot fails its checksum and load()
+ * falls back to the previous slot.
+ *
+ * \sa RNGClass::save()
+ */
+
+/** @cond */
+extern uint8_t crypto_crc8(uint8_t tag, const void *data, unsigned size);
+/** @endcond */
+
+/**
+ * \brief Constructs a new seed journal.
+ *
+ * \param address The EEPROM address of the first slot.
+ * \param slots The number of slots, which must be at least 1.
+ *
+ * The journal occupies \a slots * 48 bytes of EEPROM from \a address.
+ */
+SeedJournal::SeedJournal(int address, uint8_t slots)
+    : posn(SEED_JOURNAL_SLOT_SIZE)
+    , slot(0)
+    , slots(slots)
+    , seq(0)
+    , address(address)
+{
+}
+
+/**
+ * \brief Destroys this seed journal.
+ *
+ * Any write that is in progress is abandoned.
+ */
+SeedJournal::~SeedJournal()
+{
+    clean(buffer);
+}
+
+/**
+ * \brief Loads the newest valid seed from the journal.
+ *
+ * \param seed Returns the contents of the newest valid slot, including
+ * the sequence number and checksum.
+ *
+ * \return Returns false if there is no valid slot in the journal.
+ *
+ * This also positions the journal so that the next save() will go into
+ * the slot after the newest one.
+ */
+bool SeedJournal::load(uint8_t seed[SEED_JOURNAL_SLOT_SIZE])
+{
+    bool found = false;
+    uint16_t newest = 0;
+    for (uint8_t index = 0; index < slots; ++index) {
+        int start = address + index * SEED_JOURNAL_SLOT_SIZE;
+        eeprom_read_block(buffer, (const void *)(size_t)start,
+                          SEED_JOURNAL_SLOT_SIZE);
+        if (crypto_crc8('S', buffer, SEED_JOURNAL_SLOT_SIZE - 1) !=
+                buffer[SEED_JOURNAL_SLOT_SIZE - 1])
+            continue;
+        uint16_t value = buffer[0] | (((uint16_t)(buffer[1])) << 8);
+        if (!found || (int16_t)(value - newest) > 0) {
+            found = true;
+            newest = value;
+            slot = index;
+            memcpy(seed, buffer, SEED_JOURNAL_SLOT_SIZE);
+        }
+    }
+    clean(buffer);
+    posn = SEED_JOURNAL_SLOT_SIZE;
+    if (found) {
+        seq = newest + 1;
+        slot = (slot + 1) % slots;
+    } else {
+        seq = 0;
+        slot = 0;
+    }
+    return found;
+}
+
+/**
+ * \brief Starts saving a new seed into the journal.
+ *
+ * \param seed The seed data to save.
+ *
+ * The seed is copied and written out by later calls to poll().  If a
+ * previous save is still in progress, then it is abandoned and the new
+ * seed is written to the same slot instead.
+ *
+ * \sa poll(), flush()
+ */
+void SeedJournal::save(const uint8_t seed[SEED_JOURNAL_DATA_SIZE])
+{
+    buffer[0] = (uint8_t)seq;
+    buffer[1] = (uint8_t)(seq >> 8);
+    memcpy(buffer + 2, seed, SEED_JOURNAL_DATA_SIZE);
+    buffer[SEED_JOURNAL_SLOT_SIZE - 1] =
+        crypto_crc8('S', buffer, SEED_JOURNAL_SLOT_SIZE - 1);
+    posn = 0;
+}
+
+/**
+ * \brief Writes the next byte of a pending save if the EEPROM is ready.
+ *
+ * \return Returns true if the save is still in progress after this call.
+ *
+ * \sa busy(), flush()
+ */
+bool SeedJournal::poll()
+{
+    if (posn >= SEED_JOURNAL_SLOT_SIZE)
+        return false;
+    if (!eeprom_is_ready())
+        return true;
+    eeprom_update_byte
+        ((uint8_t *)(size_t)(address + slot * SEED_JOURNAL_SLOT_SIZE + posn),
+         buffer[posn]);
+    if (++posn < SEED_JOURNAL_SLOT_SIZE)
+        return true;
+
+    // The slot is complete.  Move on to the next one.
+    clean(buffer);
+    slot = (slot + 1) % slots;
+    ++seq;
+    return false;
+}
+
+/**
+ * \brief Finishes any pending save, waiting for the EEPROM as necessary.
+ *
+ * \sa poll()
+ */
+void SeedJournal::flush()
+{
+    while (poll())
+        ;   // Keep writing until the slot is complete.
+}
+
+/**
+ * \brief Erases all slots in the journal.
+ *
+ * Any pending save is abandoned.  This function waits for the writes
+ * to complete.
+ */
+void SeedJournal::erase()
+{
+    clean(buffer);
+    posn = SEED_JOURNAL_SLOT_SIZE;
+    for (int index = 0; index < slots * SEED_JOURNAL_SLOT_SIZE; ++index)
+        eeprom_update_byte((uint8_t *)(size_t)(address + index), 0xFF);
+    slot = 0;
+    seq = 0;
+}
+
+#endif
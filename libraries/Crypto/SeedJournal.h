@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2015 Southern Storm Software, Pty Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef CRYPTO_SEEDJOURNAL_H
+#define CRYPTO_SEEDJOURNAL_H
+
+#include <inttypes.h>
+#include <stddef.h>
+
+// The journal is implemented on top of the avr-libc EEPROM API, which
+// the host build emulates for testing.
+#if defined(__AVR__) || defined(HOST_BUILD)
+#define SEED_JOURNAL_EEPROM 1
+#else
+#define SEED_JOURNAL_EEPROM 0
+#endif
+
+#if SEED_JOURNAL_EEPROM
+
+// Size of a journal slot: a 2-byte sequence number, 45 bytes of seed
+// data, and a CRC-8 over the rest of the slot.
+#define SEED_JOURNAL_SLOT_SIZE  48
+#define SEED_JOURNAL_DATA_SIZE  45
+
+class SeedJournal
+{
+public:
+    SeedJournal(int address, uint8_t slots);
+    ~SeedJournal();
+
+    bool load(uint8_t seed[SEED_JOURNAL_SLOT_SIZE]);
+    void save(const uint8_t seed[SEED_JOURNAL_DATA_SIZE]);
+
+    bool poll();
+    void flush();
+    bool busy() const { return posn < SEED_JOURNAL_SLOT_SIZE; }
+
+    void erase();
+
+private:
+    uint8_t buffer[SEED_JOURNAL_SLOT_SIZE];
+    uint8_t posn;
+    uint8_t slot;
+    uint8_t slots;
+    uint16_t seq;
+    int address;
+};
+
+#endif
+
+#endif
@@ -27,10 +27,10 @@ This example runs tests on the utility functions in BigNumberUtil.
 #include <Crypto.h>
 #include <BigNumberUtil.h>
 #include <utility/ProgMemUtil.h>
+#include <utility/LimbUtil.h>
 #include <string.h>
 
 #define NUM_SIZE_512BIT (64 / sizeof(limb_t))
-#define LIMB_BITS       (sizeof(limb_t) * 8)
 
 // Convert a decimal string in program memory into a big number.
 void fromString(limb_t *x, size_t xsize, const char *str)
@@ -366,11 +366,404 @@ void testPackUnpack(void)
     }
 }
 
+#define MAX_MUL_LIMBS   48
+
+// Fill a big number with a simple pseudorandom sequence.
+static void fillNumber(limb_t *x, size_t size, uint32_t seed)
+{
+    for (size_t posn = 0; posn < size; ++posn) {
+        limb_t word = 0;
+        for (uint8_t byte = 0; byte < sizeof(limb_t); ++byte) {
+            seed = seed * 1103515245UL + 12345UL;
+            word = (word << 8) | (uint8_t)(seed >> 16);
+        }
+        x[posn] = word;
+    }
+}
+
+// Test Karatsuba multiplication against schoolbook multiplication.
+void testMulKaratsuba(void)
+{
+    static limb_t x[MAX_MUL_LIMBS];
+    static limb_t y[MAX_MUL_LIMBS];
+    static limb_t expected[MAX_MUL_LIMBS * 2];
+    static limb_t actual[MAX_MUL_LIMBS * 2];
+    static limb_t scratch[BIGNUMBER_KARATSUBA_SCRATCH(MAX_MUL_LIMBS) + 8];
+    size_t size;
+    bool ok;
+
+    Serial.print("mulKaratsuba random: ");
+    Serial.flush();
+    ok = true;
+    for (size = 1; size <= MAX_MUL_LIMBS; ++size) {
+        fillNumber(x, size, size);
+        fillNumber(y, size, size * 3 + 1);
+        BigNumberUtil::mul(expected, x, size, y, size);
+        BigNumberUtil::mulKaratsuba(actual, x, y, size, scratch);
+        if (memcmp(actual, expected, size * 2 * sizeof(limb_t)) != 0)
+            ok = false;
+        BigNumberUtil::mul(expected, x, size, x, size);
+        BigNumberUtil::mulKaratsuba(actual, x, x, size, scratch);
+        if (memcmp(actual, expected, size * 2 * sizeof(limb_t)) != 0)
+            ok = false;
+    }
+    if (ok)
+        Serial.println("ok");
+    else
+        Serial.println("failed");
+
+    // All-ones operands exercise the carries out of the half sums.
+    Serial.print("mulKaratsuba all-ones: ");
+    Serial.flush();
+    ok = true;
+    for (size = 1; size <= MAX_MUL_LIMBS; ++size) {
+        memset(x, 0xFF, size * sizeof(limb_t));
+        memset(y, 0xFF, size * sizeof(limb_t));
+        BigNumberUtil::mul(expected, x, size, y, size);
+        BigNumberUtil::mulKaratsuba(actual, x, y, size, scratch);
+        if (memcmp(actual, expected, size * 2 * sizeof(limb_t)) != 0)
+            ok = false;
+        fillNumber(y, size, size);
+        BigNumberUtil::mul(expected, x, size, y, size);
+        BigNumberUtil::mulKaratsuba(actual, x, y, size, scratch);
+        if (memcmp(actual, expected, size * 2 * sizeof(limb_t)) != 0)
+            ok = false;
+    }
+    if (ok)
+        Serial.println("ok");
+    else
+        Serial.println("failed");
+
+    // Nothing past the advertised amount of scratch space may be touched.
+    Serial.print("mulKaratsuba scratch size: ");
+    Serial.flush();
+    ok = true;
+    for (size = 1; size <= MAX_MUL_LIMBS; ++size) {
+        size_t used = BIGNUMBER_KARATSUBA_SCRATCH(size);
+        fillNumber(x, size, size + 7);
+        fillNumber(y, size, size + 11);
+        memset(scratch, 0xA5, sizeof(scratch));
+        BigNumberUtil::mulKaratsuba(actual, x, y, size, scratch);
+        const uint8_t *guard = (const uint8_t *)(scratch + used);
+        for (size_t posn = 0; posn < 8 * sizeof(limb_t); ++posn) {
+            if (guard[posn] != 0xA5)
+                ok = false;
+        }
+    }
+    if (ok)
+        Serial.println("ok");
+    else
+        Serial.println("failed");
+}
+
+// Small prime field for testing exponentiation: integers modulo 2^32 - 5.
+#define FIELD_PRIME     4294967291UL
+#define FIELD_LIMBS     NUM_LIMBS_BITS(32)
+#define MAX_EXP_BITS    128
+#define MAX_WINDOW      8
+
+static uint32_t fieldGet(const limb_t *x)
+{
+    uint8_t bytes[4];
+    BigNumberUtil::packLE(bytes, 4, x, FIELD_LIMBS);
+    return ((uint32_t)bytes[0]) | (((uint32_t)bytes[1]) << 8) |
+           (((uint32_t)bytes[2]) << 16) | (((uint32_t)bytes[3]) << 24);
+}
+
+static void fieldSet(limb_t *x, uint32_t value)
+{
+    uint8_t bytes[4];
+    bytes[0] = (uint8_t)value;
+    bytes[1] = (uint8_t)(value >> 8);
+    bytes[2] = (uint8_t)(value >> 16);
+    bytes[3] = (uint8_t)(value >> 24);
+    BigNumberUtil::unpackLE(x, FIELD_LIMBS, bytes, 4);
+}
+
+static uint32_t fieldMulValues(uint32_t x, uint32_t y)
+{
+    return (uint32_t)((((uint64_t)x) * y) % FIELD_PRIME);
+}
+
+static void fieldMul(limb_t *result, const limb_t *x, const limb_t *y)
+{
+    fieldSet(result, fieldMulValues(fieldGet(x), fieldGet(y)));
+}
+
+static void fieldSquare(limb_t *result, const limb_t *x)
+{
+    uint32_t value = fieldGet(x);
+    fieldSet(result, fieldMulValues(value, value));
+}
+
+// Reference exponentiation using the square and multiply method.
+static uint32_t fieldPow(uint32_t x, const limb_t *e, size_t ebits)
+{
+    uint32_t result = 1;
+    for (size_t bit = ebits; bit > 0; --bit) {
+        result = fieldMulValues(result, result);
+        if ((e[(bit - 1) / LIMB_BITS] >> ((bit - 1) % LIMB_BITS)) & 1)
+            result = fieldMulValues(result, x);
+    }
+    return result;
+}
+
+static size_t const expBits[] = {0, 1, 2, 7, 31, 32, 64, 100, 128};
+
+// Test pow() with exponents in RAM against the reference.
+void testPow(void)
+{
+    static limb_t e[NUM_LIMBS_BITS(MAX_EXP_BITS)];
+    static limb_t table[(1 << (MAX_WINDOW - 1)) * FIELD_LIMBS];
+    limb_t x[FIELD_LIMBS];
+    limb_t result[FIELD_LIMBS];
+    uint8_t window;
+    bool ok;
+
+    // Any value raised to the power of zero is 1, including zero itself.
+    Serial.print("pow zero exponent: ");
+    Serial.flush();
+    ok = true;
+    memset(e, 0, sizeof(e));
+    for (window = 1; window <= MAX_WINDOW; ++window) {
+        fieldSet(x, 0x12345678);
+        BigNumberUtil::pow(result, x, e, MAX_EXP_BITS, FIELD_LIMBS,
+                           fieldMul, fieldSquare, table, window);
+        if (fieldGet(result) != 1)
+            ok = false;
+        fieldSet(x, 0);
+        BigNumberUtil::pow(result, x, e, 0, FIELD_LIMBS,
+                           fieldMul, fieldSquare, table, window);
+        if (fieldGet(result) != 1)
+            ok = false;
+    }
+    if (ok)
+        Serial.println("ok");
+    else
+        Serial.println("failed");
+
+    // Random exponents of various lengths with every window size.
+    Serial.print("pow random: ");
+    Serial.flush();
+    ok = true;
+    for (size_t index = 0; index < sizeof(expBits) / sizeof(expBits[0]); ++index) {
+        size_t ebits = expBits[index];
+        fillNumber(e, NUM_LIMBS_BITS(MAX_EXP_BITS), ebits + 1);
+        uint32_t base = fieldMulValues(0x9E3779B9UL, ebits + 3);
+        uint32_t expected = fieldPow(base, e, ebits);
+        for (window = 1; window <= MAX_WINDOW; ++window) {
+            fieldSet(x, base);
+            BigNumberUtil::pow(result, x, e, ebits, FIELD_LIMBS,
+                               fieldMul, fieldSquare, table, window);
+            if (fieldGet(result) != expected)
+                ok = false;
+        }
+    }
+    if (ok)
+        Serial.println("ok");
+    else
+        Serial.println("failed");
+}
+
+// Exponents in program memory: p - 2 and a 128-bit value with runs of
+// both zero and one bits.
+static limb_t const expInverse[] PROGMEM = {
+    LIMB_PAIR(0xFFFFFFF9, 0x00000000)
+};
+static limb_t const expMixed[] PROGMEM = {
+    LIMB_PAIR(0x000000F1, 0xFFFF0000),
+    LIMB_PAIR(0x80000001, 0x0123ABCD)
+};
+
+// Test pow_P() with exponents in program memory.
+void testPowP(void)
+{
+    static limb_t table[(1 << (MAX_WINDOW - 1)) * FIELD_LIMBS];
+    limb_t e[NUM_LIMBS_BITS(128)];
+    limb_t x[FIELD_LIMBS];
+    limb_t result[FIELD_LIMBS];
+    uint8_t window;
+    bool ok;
+
+    // x^(p - 2) is the multiplicative inverse of x.
+    Serial.print("pow_P inverse: ");
+    Serial.flush();
+    ok = true;
+    for (window = 1; window <= MAX_WINDOW; ++window) {
+        uint32_t base = fieldMulValues(0x2545F491UL, window);
+        fieldSet(x, base);
+        BigNumberUtil::pow_P(result, x, expInverse, 32, FIELD_LIMBS,
+                             fieldMul, fieldSquare, table, window);
+        if (fieldMulValues(fieldGet(result), base) != 1)
+            ok = false;
+    }
+    if (ok)
+        Serial.println("ok");
+    else
+        Serial.println("failed");
+
+    // Compare against the reference with the exponent copied into RAM.
+    Serial.print("pow_P mixed: ");
+    Serial.flush();
+    ok = true;
+    memcpy_P(e, expMixed, sizeof(e));
+    for (window = 1; window <= MAX_WINDOW; ++window) {
+        uint32_t base = fieldMulValues(0x6C078965UL, window + 1);
+        fieldSet(x, base);
+        BigNumberUtil::pow_P(result, x, expMixed, 128, FIELD_LIMBS,
+                             fieldMul, fieldSquare, table, window);
+        if (fieldGet(result) != fieldPow(base, e, 128))
+            ok = false;
+    }
+    if (ok)
+        Serial.println("ok");
+    else
+        Serial.println("failed");
+}
+
+// Test powResume() and powResume_P(), which continue on from the value
+// that is already in the result.
+void testPowResume(void)
+{
+    static limb_t e[NUM_LIMBS_BITS(MAX_EXP_BITS)];
+    static limb_t table[(1 << (MAX_WINDOW - 1)) * FIELD_LIMBS];
+    limb_t x[FIELD_LIMBS];
+    limb_t result[FIELD_LIMBS];
+    uint8_t window;
+    bool ok;
+
+    Serial.print("powResume: ");
+    Serial.flush();
+    ok = true;
+    for (size_t index = 0; index < sizeof(expBits) / sizeof(expBits[0]); ++index) {
+        size_t ebits = expBits[index];
+        fillNumber(e, NUM_LIMBS_BITS(MAX_EXP_BITS), ebits + 7);
+        uint32_t base = fieldMulValues(0x41C64E6DUL, ebits + 5);
+        uint32_t start = fieldMulValues(0x2F6B1C53UL, ebits + 11);
+        uint32_t expected = start;
+        for (size_t bit = 0; bit < ebits; ++bit)
+            expected = fieldMulValues(expected, expected);
+        expected = fieldMulValues(expected, fieldPow(base, e, ebits));
+        for (window = 1; window <= MAX_WINDOW; ++window) {
+            fieldSet(x, base);
+            fieldSet(result, start);
+            BigNumberUtil::powResume(result, x, e, ebits, FIELD_LIMBS,
+                                     fieldMul, fieldSquare, table, window);
+            if (fieldGet(result) != expected)
+                ok = false;
+        }
+    }
+    if (ok)
+        Serial.println("ok");
+    else
+        Serial.println("failed");
+
+    Serial.print("powResume_P: ");
+    Serial.flush();
+    ok = true;
+    memcpy_P(e, expMixed, NUM_LIMBS_BITS(128) * sizeof(limb_t));
+    for (window = 1; window <= MAX_WINDOW; ++window) {
+        uint32_t base = fieldMulValues(0x6C078965UL, window + 3);
+        uint32_t start = fieldMulValues(0x5851F42DUL, window);
+        uint32_t expected = start;
+        for (uint8_t bit = 0; bit < 128; ++bit)
+            expected = fieldMulValues(expected, expected);
+        expected = fieldMulValues(expected, fieldPow(base, e, 128));
+        fieldSet(x, base);
+        fieldSet(result, start);
+        BigNumberUtil::powResume_P(result, x, expMixed, 128, FIELD_LIMBS,
+                                   fieldMul, fieldSquare, table, window);
+        if (fieldGet(result) != expected)
+            ok = false;
+    }
+    if (ok)
+        Serial.println("ok");
+    else
+        Serial.println("failed");
+}
+
+// Addition chain for x^(2^4 - 1) from the powChain_P() documentation.
+static uint8_t const chain15[] PROGMEM = {
+    BIGNUMBER_CHAIN_SQUARE(0, 1, 1),
+    BIGNUMBER_CHAIN_MUL(0, 0, 1),
+    BIGNUMBER_CHAIN_SQUARE(2, 0, 2),
+    BIGNUMBER_CHAIN_MUL(0, 0, 2),
+    BIGNUMBER_CHAIN_END
+};
+
+// Addition chain for x^(2^20 - 1) that uses two temporaries.
+static uint8_t const chain20[] PROGMEM = {
+    BIGNUMBER_CHAIN_SQUARE(2, 1, 1),
+    BIGNUMBER_CHAIN_MUL(2, 2, 1),       // t1 = a(2)
+    BIGNUMBER_CHAIN_SQUARE(3, 2, 2),
+    BIGNUMBER_CHAIN_MUL(3, 3, 2),       // t2 = a(4)
+    BIGNUMBER_CHAIN_SQUARE(3, 3, 1),
+    BIGNUMBER_CHAIN_MUL(3, 3, 1),       // t2 = a(5)
+    BIGNUMBER_CHAIN_SQUARE(2, 3, 5),
+    BIGNUMBER_CHAIN_MUL(2, 2, 3),       // t1 = a(10)
+    BIGNUMBER_CHAIN_SQUARE(0, 2, 10),
+    BIGNUMBER_CHAIN_MUL(0, 0, 2),       // r = a(20)
+    BIGNUMBER_CHAIN_END
+};
+
+// Addition chain for x^(2^255) with the largest square count.
+static uint8_t const chain255[] PROGMEM = {
+    BIGNUMBER_CHAIN_SQUARE(0, 1, 255),
+    BIGNUMBER_CHAIN_END
+};
+
+// Test powChain_P() against the reference.
+void testPowChain(void)
+{
+    limb_t e[NUM_LIMBS_BITS(256)];
+    limb_t x[FIELD_LIMBS];
+    limb_t result[FIELD_LIMBS];
+    limb_t t1[FIELD_LIMBS];
+    limb_t t2[FIELD_LIMBS];
+    limb_t *regs[4] = {result, x, t1, t2};
+    uint32_t base = 0xDEADBEEFUL % FIELD_PRIME;
+    bool ok = true;
+
+    Serial.print("powChain_P: ");
+    Serial.flush();
+
+    memset(e, 0, sizeof(e));
+    e[0] = 15;
+    fieldSet(x, base);
+    BigNumberUtil::powChain_P(regs, chain15, fieldMul, fieldSquare);
+    if (fieldGet(result) != fieldPow(base, e, 4))
+        ok = false;
+
+    memset(e, 0, sizeof(e));
+    fieldSet(e, 0x000FFFFFUL);
+    BigNumberUtil::powChain_P(regs, chain20, fieldMul, fieldSquare);
+    if (fieldGet(result) != fieldPow(base, e, 20))
+        ok = false;
+    if (fieldGet(x) != base)
+        ok = false;
+
+    memset(e, 0, sizeof(e));
+    e[255 / LIMB_BITS] = ((limb_t)1) << (255 % LIMB_BITS);
+    BigNumberUtil::powChain_P(regs, chain255, fieldMul, fieldSquare);
+    if (fieldGet(result) != fieldPow(base, e, 256))
+        ok = false;
+
+    if (ok)
+        Serial.println("ok");
+    else
+        Serial.println("failed");
+}
+
 void setup()
 {
     Serial.begin(9600);
 
     testPackUnpack();
+    testMulKaratsuba();
+    testPow();
+    testPowP();
+    testPowResume();
+    testPowChain();
 }
 
 void loop()
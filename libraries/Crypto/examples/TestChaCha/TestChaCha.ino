@@ -301,6 +301,40 @@ void testCipher(ChaCha *cipher, const struct TestVector *test)
         Serial.println("Failed");
 }
 
+// Check that hashCoreBlocks() produces the same output as hashCore().
+void testHashCoreBlocks(uint32_t counter)
+{
+    static uint8_t output[9 * 64];
+    uint32_t input[16];
+    uint32_t expected[16];
+    bool ok = true;
+
+    Serial.print("ChaCha20 hashCoreBlocks ");
+    Serial.print((unsigned long)counter, HEX);
+    Serial.print(" ... ");
+
+    for (uint8_t count = 1; count <= 9; ++count) {
+        for (uint8_t posn = 0; posn < 16; ++posn)
+            input[posn] = 0x01020304UL * (posn + count);
+        input[12] = counter;
+        ChaCha::hashCoreBlocks(output, input, 20, count);
+        if (input[12] != (uint32_t)(counter + count))
+            ok = false;
+        input[12] = counter;
+        for (uint8_t block = 0; block < count; ++block) {
+            ++(input[12]);
+            ChaCha::hashCore(expected, input, 20);
+            if (memcmp(output + block * 64, expected, 64) != 0)
+                ok = false;
+        }
+    }
+
+    if (ok)
+        Serial.println("Passed");
+    else
+        Serial.println("Failed");
+}
+
 void perfCipherSetKey(ChaCha *cipher, const struct TestVector *test)
 {
     unsigned long start;
@@ -405,6 +439,8 @@ void setup()
     testCipher(&chacha, &testVectorChaCha12_256);
     testCipher(&chacha, &testVectorChaCha8_128);
     testCipher(&chacha, &testVectorChaCha8_256);
+    testHashCoreBlocks(0);
+    testHashCoreBlocks(0xFFFFFFFCUL);
 
     Serial.println();
 
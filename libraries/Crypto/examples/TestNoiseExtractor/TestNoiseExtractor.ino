@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2015 Southern Storm Software, Pty Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+/*
+This example runs tests on the NoiseExtractor class to verify that it
+produces the same output as a simple bit-at-a-time Von Neumann extractor.
+*/
+
+#include <Crypto.h>
+#include <NoiseExtractor.h>
+#include <string.h>
+
+NoiseExtractor extractor;
+uint32_t state;
+uint8_t samples[128];
+uint8_t expected[NOISE_EXTRACTOR_SIZE];
+size_t expectedLen;
+unsigned expectedOnes;
+
+// Simple xorshift generator to simulate a noise source.
+uint8_t nextSample()
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return (uint8_t)(state >> 24);
+}
+
+// Reference implementation that debiases one pair of bits at a time.
+void referenceExtract(const uint8_t *data, size_t len)
+{
+    uint8_t bitNum = 0;
+    memset(expected, 0, sizeof(expected));
+    expectedLen = 0;
+    expectedOnes = 0;
+    for (size_t posn = 0; posn < len * 8; posn += 2) {
+        uint8_t first = (data[posn / 8] >> (7 - (posn % 8))) & 1;
+        uint8_t second = (data[posn / 8] >> (6 - (posn % 8))) & 1;
+        expectedOnes += first + second;
+        if (first != second && expectedLen < sizeof(expected)) {
+            expected[expectedLen] = (expected[expectedLen] << 1) | second;
+            if (++bitNum >= 8) {
+                ++expectedLen;
+                bitNum = 0;
+            }
+        }
+    }
+}
+
+void testExtract(const char *name, uint8_t mask, size_t len, size_t step)
+{
+    Serial.print(name);
+    Serial.print(" ... ");
+
+    // Generate samples with varying amounts of bias.
+    for (size_t posn = 0; posn < len; ++posn) {
+        uint8_t sample = nextSample();
+        samples[posn] = sample | (nextSample() & mask);
+    }
+    referenceExtract(samples, len);
+
+    // Feed the samples to the extractor in pieces.
+    unsigned ones = 0;
+    extractor.reset();
+    for (size_t posn = 0; posn < len; posn += step) {
+        size_t size = len - posn;
+        if (size > step)
+            size = step;
+        ones += extractor.extract(samples + posn, size);
+    }
+
+    if (ones == expectedOnes && extractor.size() == expectedLen &&
+            extractor.full() == (expectedLen == NOISE_EXTRACTOR_SIZE) &&
+            memcmp(extractor.data(), expected, expectedLen) == 0) {
+        Serial.println("Passed");
+    } else {
+        Serial.println("Failed");
+    }
+}
+
+void perfExtract()
+{
+    unsigned long start;
+    unsigned long elapsed;
+    int count;
+
+    Serial.print("Extract ... ");
+
+    state = 0x12345678UL;
+    for (count = 0; count < (int)sizeof(samples); ++count)
+        samples[count] = nextSample();
+    start = micros();
+    for (count = 0; count < 500; ++count) {
+        extractor.reset();
+        extractor.extract(samples, sizeof(samples));
+    }
+    elapsed = micros() - start;
+
+    Serial.print(elapsed / (sizeof(samples) * 8 * 500.0));
+    Serial.print("us per sample, ");
+    Serial.print((sizeof(samples) * 8 * 500.0 * 1000000.0) / elapsed);
+    Serial.println(" samples per second");
+}
+
+void setup()
+{
+    Serial.begin(9600);
+
+    Serial.println();
+
+    Serial.print("State Size ...");
+    Serial.println(sizeof(NoiseExtractor));
+    Serial.println();
+
+    Serial.println("Test Vectors:");
+    state = 0x12345678UL;
+    testExtract("Unbiased, 1 byte at a time", 0x00, 64, 1);
+    testExtract("Unbiased, 16 bytes at a time", 0x00, 64, 16);
+    testExtract("Biased", 0x6D, 128, 7);
+    testExtract("Stuck", 0xFF, 128, 128);
+    testExtract("Overflow", 0x00, 128, 32);
+
+    Serial.println();
+
+    Serial.println("Performance Tests:");
+    perfExtract();
+}
+
+void loop()
+{
+}
@@ -0,0 +1,250 @@
+/*
+ * Copyright (C) 2015 Southern Storm Software, Pty Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+This example runs tests on the NoiseHarvester class to verify that noise
+is handed from the harvester thread to the consumer in order and intact,
+and that a full ring drops new noise instead of overwriting queued noise.
+Build it with "make check-tsan" to check the lock-free ring for races.
+*/
+
+#include <Crypto.h>
+#include <RNG.h>
+#include <NoiseSource.h>
+#include <NoiseHarvester.h>
+#include <string.h>
+
+#if RNG_HARVEST_THREAD
+
+NoiseHarvester harvester;
+
+// Fills a 48-byte entry with a pattern that identifies its sequence number.
+void fillEntry(uint8_t *data, uint32_t seq)
+{
+    for (uint8_t posn = 0; posn < 48; ++posn)
+        data[posn] = (uint8_t)(seq * 7 + posn);
+    memcpy(data, &seq, sizeof(seq));
+}
+
+// Checks the pattern in an entry and returns its sequence number.
+bool checkEntry(const uint8_t *data, size_t len, uint32_t &seq)
+{
+    if (len != 48)
+        return false;
+    memcpy(&seq, data, sizeof(seq));
+    for (uint8_t posn = sizeof(seq); posn < 48; ++posn) {
+        if (data[posn] != (uint8_t)(seq * 7 + posn))
+            return false;
+    }
+    return true;
+}
+
+// Fake noise source that queues numbered entries from the harvester thread.
+class FakeNoiseSource : public NoiseSource
+{
+public:
+    FakeNoiseSource() : seq(0), dropped(0), wrongThread(false) {}
+
+    bool calibrating() const { return false; }
+
+    void stir()
+    {
+        uint8_t data[48];
+        if (!NoiseHarvester::onHarvestThread())
+            wrongThread = true;
+        fillEntry(data, seq++);
+        if (!harvester.push(data, sizeof(data), 8))
+            ++dropped;
+    }
+
+    uint32_t seq;
+    uint32_t dropped;
+    bool wrongThread;
+};
+
+FakeNoiseSource source;
+NoiseSource *sources[1] = {&source};
+
+// Pushes and pops on the same thread, including data that must be
+// split across several ring entries.
+void testPushPop()
+{
+    uint8_t data[100];
+    uint8_t out[48];
+    unsigned int credit;
+    bool ok = true;
+
+    Serial.print("Push and pop ... ");
+
+    for (uint8_t posn = 0; posn < sizeof(data); ++posn)
+        data[posn] = posn;
+    if (!harvester.push(data, sizeof(data), 600))
+        ok = false;
+    if (harvester.pop(out, credit) != 48 || credit != 384 ||
+            memcmp(out, data, 48) != 0)
+        ok = false;
+    if (harvester.pop(out, credit) != 48 || credit != 216 ||
+            memcmp(out, data + 48, 48) != 0)
+        ok = false;
+    if (harvester.pop(out, credit) != 4 || credit != 0 ||
+            memcmp(out, data + 96, 4) != 0)
+        ok = false;
+    if (harvester.pop(out, credit) != 0)
+        ok = false;
+
+    // Empty data must not queue an entry that hides the ones behind it.
+    if (!harvester.push(data, 0, 0) || !harvester.push(data, 1, 8))
+        ok = false;
+    if (harvester.pop(out, credit) != 1 || credit != 8 || out[0] != data[0])
+        ok = false;
+    if (harvester.pop(out, credit) != 0)
+        ok = false;
+
+    if (ok)
+        Serial.println("Passed");
+    else
+        Serial.println("Failed");
+}
+
+// Fills the ring and checks that further noise is dropped and that
+// the queued entries survive.
+void testOverflow()
+{
+    uint8_t data[48];
+    unsigned int credit;
+    uint32_t seq;
+    bool ok = true;
+
+    Serial.print("Overflow ... ");
+
+    for (uint32_t posn = 0; posn < NOISE_HARVEST_SLOTS; ++posn) {
+        fillEntry(data, posn);
+        if (!harvester.push(data, sizeof(data), 8))
+            ok = false;
+    }
+    fillEntry(data, NOISE_HARVEST_SLOTS);
+    if (harvester.push(data, sizeof(data), 8))
+        ok = false;
+    for (uint32_t posn = 0; posn < NOISE_HARVEST_SLOTS; ++posn) {
+        size_t len = harvester.pop(data, credit);
+        if (!checkEntry(data, len, seq) || seq != posn || credit != 8)
+            ok = false;
+    }
+    if (harvester.pop(data, credit) != 0)
+        ok = false;
+
+    if (ok)
+        Serial.println("Passed");
+    else
+        Serial.println("Failed");
+}
+
+// Runs the harvester thread against a consumer on this thread and
+// checks that every entry that was not dropped arrives once, in order.
+void testThread()
+{
+    uint8_t data[48];
+    unsigned int credit;
+    uint32_t seq;
+    uint32_t expected = 0;
+    uint32_t received = 0;
+    bool ok = true;
+
+    Serial.print("Harvest thread ... ");
+
+    source.seq = 0;
+    source.dropped = 0;
+    if (!harvester.start(sources, 1, 0) || !harvester.running())
+        ok = false;
+    if (harvester.start(sources, 1, 0))
+        ok = false;     // Second start must fail while running.
+    if (NoiseHarvester::onHarvestThread())
+        ok = false;
+
+    // Drain slowly at first to force some drops, then keep up.
+    unsigned long start = millis();
+    while ((millis() - start) < 200) {
+        size_t len = harvester.pop(data, credit);
+        if (!len) {
+            if ((millis() - start) < 50)
+                delay(1);
+            continue;
+        }
+        if (!checkEntry(data, len, seq) || seq < expected || credit != 8)
+            ok = false;
+        expected = seq + 1;
+        ++received;
+    }
+
+    // Stop the thread and drain the entries that were left behind.
+    harvester.stop();
+    if (harvester.running())
+        ok = false;
+    size_t len;
+    while ((len = harvester.pop(data, credit)) != 0) {
+        if (!checkEntry(data, len, seq) || seq < expected)
+            ok = false;
+        expected = seq + 1;
+        ++received;
+    }
+    if (source.wrongThread)
+        ok = false;
+    if ((received + source.dropped) != source.seq || received == 0)
+        ok = false;
+
+    // The harvester must be able to restart after it was stopped.
+    if (!harvester.start(sources, 1, 1))
+        ok = false;
+    delay(10);
+    harvester.stop();
+    while (harvester.pop(data, credit) != 0)
+        ;   // Discard the noise from the restart.
+
+    if (ok)
+        Serial.println("Passed");
+    else
+        Serial.println("Failed");
+}
+
+#endif
+
+void setup()
+{
+    Serial.begin(9600);
+
+    Serial.println();
+
+#if RNG_HARVEST_THREAD
+    Serial.println("Test Vectors:");
+    testPushPop();
+    testOverflow();
+    testThread();
+#else
+    Serial.println("Noise harvesting is not supported on this platform");
+#endif
+
+    Serial.println();
+}
+
+void loop()
+{
+}
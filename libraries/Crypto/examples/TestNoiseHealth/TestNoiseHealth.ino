@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2015 Southern Storm Software, Pty Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+/*
+This example runs tests on the NoiseHealthTest class to verify that
+stuck and biased noise is detected and that good noise is not.
+*/
+
+#include <Crypto.h>
+#include <NoiseHealthTest.h>
+#include <string.h>
+
+NoiseHealthTest health;
+uint32_t state;
+
+// Simple xorshift generator to simulate a good noise source.
+uint8_t nextSample()
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return (uint8_t)(state >> 24);
+}
+
+// Feeds good samples and checks that neither test fails.
+void testGood(uint8_t entropy)
+{
+    Serial.print("Good noise, ");
+    Serial.print(entropy);
+    Serial.print(" bits ... ");
+
+    health.setEntropy(entropy);
+    health.reset();
+    state = 0x12345678UL;
+    uint8_t result = 0;
+    for (long count = 0; count < 100000L; ++count)
+        result |= health.update(nextSample());
+
+    if (result == 0)
+        Serial.println("Passed");
+    else
+        Serial.println("Failed");
+}
+
+// Feeds good samples, then a stuck value, and checks that the
+// Repetition Count Test fails at exactly the cutoff.
+void testStuck(uint8_t entropy)
+{
+    Serial.print("Stuck noise, ");
+    Serial.print(entropy);
+    Serial.print(" bits ... ");
+
+    health.setEntropy(entropy);
+    health.reset();
+    state = 0x12345678UL;
+    bool ok = true;
+    uint8_t sample = 0;
+    for (int count = 0; count < 100; ++count) {
+        sample = nextSample();
+        if (health.update(sample) != 0)
+            ok = false;
+    }
+    sample ^= 0x80;
+    for (uint8_t count = 1; count < health.rctCutoff(); ++count) {
+        if ((health.update(sample) & NOISE_HEALTH_RCT) != 0)
+            ok = false;
+    }
+    if ((health.update(sample) & NOISE_HEALTH_RCT) == 0)
+        ok = false;
+
+    if (ok)
+        Serial.println("Passed");
+    else
+        Serial.println("Failed");
+}
+
+// Feeds samples where every second one is zero and checks that the
+// Adaptive Proportion Test fails, even though no run is long enough
+// to trip the Repetition Count Test.
+void testBiased()
+{
+    Serial.print("Biased noise ... ");
+
+    health.setEntropy(8);
+    health.reset();
+    state = 0x12345678UL;
+    uint8_t result = 0;
+    for (int count = 0; count < 1024; ++count) {
+        uint8_t sample = 0;
+        if (count & 1)
+            sample = nextSample() | 0x01;
+        result |= health.update(sample);
+    }
+
+    if (result == NOISE_HEALTH_APT)
+        Serial.println("Passed");
+    else
+        Serial.println("Failed");
+}
+
+void perfUpdate()
+{
+    unsigned long start;
+    unsigned long elapsed;
+    uint8_t buffer[128];
+    int count;
+
+    Serial.print("Update ... ");
+
+    state = 0x12345678UL;
+    for (count = 0; count < (int)sizeof(buffer); ++count)
+        buffer[count] = nextSample();
+    health.setEntropy(8);
+    health.reset();
+    start = micros();
+    for (count = 0; count < 500; ++count)
+        health.update(buffer, sizeof(buffer));
+    elapsed = micros() - start;
+
+    Serial.print(elapsed / (sizeof(buffer) * 500.0));
+    Serial.print("us per sample, ");
+    Serial.print((sizeof(buffer) * 500.0 * 1000000.0) / elapsed);
+    Serial.println(" samples per second");
+}
+
+void setup()
+{
+    Serial.begin(9600);
+
+    Serial.println();
+
+    Serial.print("State Size ...");
+    Serial.println(sizeof(NoiseHealthTest));
+    Serial.println();
+
+    Serial.println("Test Vectors:");
+    testGood(8);
+    testGood(4);
+    testGood(1);
+    testStuck(8);
+    testStuck(4);
+    testStuck(1);
+    testBiased();
+
+    Serial.println();
+
+    Serial.println("Performance Tests:");
+    perfUpdate();
+}
+
+void loop()
+{
+}
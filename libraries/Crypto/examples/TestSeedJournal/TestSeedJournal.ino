@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2015 Southern Storm Software, Pty Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+/*
+This example runs tests on the SeedJournal class to verify correct behaviour.
+
+Note: this will overwrite the first 144 bytes of EEPROM on real hardware.
+*/
+
+#include <Crypto.h>
+#include <SeedJournal.h>
+#include <string.h>
+#if defined(HOST_BUILD)
+#include <avr/eeprom.h>
+#endif
+
+#if SEED_JOURNAL_EEPROM
+
+#define TEST_ADDRESS 0
+#define TEST_SLOTS 3
+
+uint8_t seed[SEED_JOURNAL_DATA_SIZE];
+uint8_t loaded[SEED_JOURNAL_SLOT_SIZE];
+
+void makeSeed(uint8_t value)
+{
+    for (uint8_t posn = 0; posn < sizeof(seed); ++posn)
+        seed[posn] = value + posn;
+}
+
+bool loadSeed(uint8_t value)
+{
+    SeedJournal journal(TEST_ADDRESS, TEST_SLOTS);
+    if (!journal.load(loaded))
+        return false;
+    makeSeed(value);
+    return memcmp(loaded + 2, seed, sizeof(seed)) == 0;
+}
+
+void testEmpty()
+{
+    Serial.print("Empty ... ");
+    SeedJournal journal(TEST_ADDRESS, TEST_SLOTS);
+    journal.erase();
+    if (!journal.load(loaded))
+        Serial.println("Passed");
+    else
+        Serial.println("Failed");
+}
+
+void testSave()
+{
+    bool ok = true;
+    Serial.print("Save ... ");
+    SeedJournal journal(TEST_ADDRESS, TEST_SLOTS);
+    journal.load(loaded);
+    for (uint8_t count = 1; count <= 10; ++count) {
+        makeSeed(count);
+        journal.save(seed);
+
+        // The seed is written one byte per poll.
+        for (uint8_t posn = 1; posn < SEED_JOURNAL_SLOT_SIZE; ++posn) {
+            if (!journal.poll() || !journal.busy())
+                ok = false;
+        }
+        if (journal.poll() || journal.busy())
+            ok = false;
+
+        if (!loadSeed(count))
+            ok = false;
+    }
+    if (ok)
+        Serial.println("Passed");
+    else
+        Serial.println("Failed");
+}
+
+void testTornWrite()
+{
+    bool ok = true;
+    Serial.print("Torn Write ... ");
+    SeedJournal journal(TEST_ADDRESS, TEST_SLOTS);
+    if (!journal.load(loaded))
+        ok = false;
+    makeSeed(42);
+    journal.save(seed);
+    for (uint8_t posn = 0; posn < 20; ++posn)
+        journal.poll();
+
+    // Power is lost: the previous seed should be loaded.
+    if (!loadSeed(10))
+        ok = false;
+
+    // Resume after "reboot" and save again.
+    SeedJournal journal2(TEST_ADDRESS, TEST_SLOTS);
+    journal2.load(loaded);
+    makeSeed(43);
+    journal2.save(seed);
+    journal2.flush();
+    if (!loadSeed(43))
+        ok = false;
+
+    if (ok)
+        Serial.println("Passed");
+    else
+        Serial.println("Failed");
+}
+
+// RNG.begin() loads the previous seed and saves a new one before it
+// returns.  If the device is reset before that write completes, then
+// the next boot reloads the same seed and repeats the random output,
+// so begin() must flush the journal rather than leave it to loop().
+void testResetBeforeWrite()
+{
+    bool ok = true;
+    Serial.print("Reset Before Write Completes ... ");
+
+    // Boot with a staged save that is never polled: the reset reloads
+    // the seed that this boot started from.
+    SeedJournal journal(TEST_ADDRESS, TEST_SLOTS);
+    if (!journal.load(loaded))
+        ok = false;
+    makeSeed(60);
+    journal.save(seed);
+    if (!loadSeed(43))
+        ok = false;
+
+    // Boot again and flush the save the way begin() does: an immediate
+    // reset must load the new seed.
+    for (uint8_t count = 61; count <= 64; ++count) {
+        SeedJournal journal2(TEST_ADDRESS, TEST_SLOTS);
+        if (!journal2.load(loaded))
+            ok = false;
+        makeSeed(count);
+        journal2.save(seed);
+        journal2.flush();
+        if (!loadSeed(count))
+            ok = false;
+    }
+
+    if (ok)
+        Serial.println("Passed");
+    else
+        Serial.println("Failed");
+}
+
+#if defined(HOST_BUILD)
+
+void testWearLevelling()
+{
+    bool ok = true;
+    Serial.print("Wear Levelling ... ");
+    eeprom_emulation().reset();
+    SeedJournal journal(TEST_ADDRESS, TEST_SLOTS);
+    journal.load(loaded);
+    for (uint8_t count = 0; count < TEST_SLOTS * 10; ++count) {
+        makeSeed(count);
+        journal.save(seed);
+        journal.flush();
+    }
+
+    // The checksum byte of every slot should have been written equally.
+    for (uint8_t slot = 0; slot < TEST_SLOTS; ++slot) {
+        int address = TEST_ADDRESS + slot * SEED_JOURNAL_SLOT_SIZE +
+                      SEED_JOURNAL_SLOT_SIZE - 1;
+        if (eeprom_emulation().writes[address] > 10)
+            ok = false;
+    }
+    if (!loadSeed(TEST_SLOTS * 10 - 1))
+        ok = false;
+
+    if (ok)
+        Serial.println("Passed");
+    else
+        Serial.println("Failed");
+}
+
+#endif
+
+#endif // SEED_JOURNAL_EEPROM
+
+void setup()
+{
+    Serial.begin(9600);
+
+    Serial.println();
+
+#if SEED_JOURNAL_EEPROM
+    Serial.print("State Size ...");
+    Serial.println(sizeof(SeedJournal));
+    Serial.println();
+
+    Serial.println("Test Vectors:");
+    testEmpty();
+    testSave();
+    testTornWrite();
+    testResetBeforeWrite();
+#if defined(HOST_BUILD)
+    testWearLevelling();
+#endif
+    testEmpty();
+#else
+    Serial.println("SeedJournal is not supported on this platform");
+#endif
+}
+
+void loop()
+{
+}
@@ -28,6 +28,7 @@ correct behaviour.
 #include <Crypto.h>
 #include <CryptoLW.h>
 #include <Ascon128.h>
+#include <Ascon128a.h>
 #include "utility/ProgMemUtil.h"
 
 #define MAX_PLAINTEXT_LEN 43
@@ -131,13 +132,110 @@ static TestVector const testVectorAscon128_5 PROGMEM = {
     .datasize    = 43
 };
 
+// Test vectors for Ascon128a.  The first is from the official known answer
+// tests and the others were generated with the reference Python version.
+static TestVector const testVectorAscon128a_1 PROGMEM = {
+    .name        = "Ascon128a #1",
+    .key         = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                    0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f},
+    .plaintext   = {0},
+    .ciphertext  = {0},
+    .authdata    = {0},
+    .iv          = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                    0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f},
+    .tag         = {0x7a, 0x83, 0x4e, 0x6f, 0x09, 0x21, 0x09, 0x57,
+                    0x06, 0x7b, 0x10, 0xfd, 0x83, 0x1f, 0x00, 0x78},
+    .authsize    = 0,
+    .datasize    = 0
+};
+static TestVector const testVectorAscon128a_2 PROGMEM = {
+    .name        = "Ascon128a #2",
+    .key         = {0xe2, 0x20, 0x5b, 0x87, 0x5f, 0x46, 0xba, 0x51,
+                    0xdc, 0x1a, 0xe4, 0x1c, 0x85, 0xc9, 0x5f, 0x90},
+    .plaintext   = {0x61, 0x73, 0x63, 0x6f, 0x6e},
+    .ciphertext  = {0x32, 0x85, 0xae, 0x53, 0xb8},
+    .authdata    = {0x41, 0x53, 0x43, 0x4f, 0x4e},
+    .iv          = {0x87, 0x2b, 0x6f, 0x29, 0x5f, 0x8f, 0x25, 0x5d,
+                    0xba, 0x22, 0x49, 0x3f, 0x9f, 0x6e, 0x47, 0x6b},
+    .tag         = {0x65, 0x80, 0x2c, 0xd4, 0x3e, 0x7e, 0xd9, 0x54,
+                    0x40, 0xce, 0x18, 0x3f, 0xff, 0xbd, 0xc1, 0x10},
+    .authsize    = 5,
+    .datasize    = 5
+};
+static TestVector const testVectorAscon128a_3 PROGMEM = {
+    .name        = "Ascon128a #3",
+    .key         = {0xd1, 0x5e, 0x26, 0xf2, 0xbf, 0x8b, 0xd1, 0xd7,
+                    0xae, 0xac, 0x91, 0xc7, 0x6d, 0xec, 0x77, 0xc2},
+    .plaintext   = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                    0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f},
+    .ciphertext  = {0xb6, 0x75, 0x19, 0x96, 0x65, 0xdb, 0x8d, 0xe4,
+                    0xd4, 0xc5, 0x81, 0x9e, 0xd2, 0xc9, 0x9b, 0x9c},
+    .authdata    = {0},
+    .iv          = {0x88, 0x15, 0xf5, 0xc8, 0x4e, 0x07, 0x89, 0x59,
+                    0xf1, 0x0b, 0x6b, 0x13, 0x14, 0x2a, 0xff, 0xd0},
+    .tag         = {0xaa, 0x40, 0x95, 0xbb, 0xcc, 0x7f, 0x63, 0x06,
+                    0xa3, 0x9c, 0xac, 0x30, 0xd7, 0x61, 0xdd, 0x57},
+    .authsize    = 0,
+    .datasize    = 16
+};
+static TestVector const testVectorAscon128a_4 PROGMEM = {
+    .name        = "Ascon128a #4",
+    .key         = {0x60, 0x73, 0x82, 0x98, 0xf0, 0xa1, 0x73, 0x3d,
+                    0x20, 0x0a, 0x74, 0x21, 0xa4, 0xe8, 0xfa, 0xaf},
+    .plaintext   = {0x70, 0x6c, 0x61, 0x69, 0x6e, 0x74, 0x65, 0x78,
+                    0x74, 0x20, 0x6d, 0x65, 0x73, 0x73, 0x61, 0x67,
+                    0x65, 0x20, 0x30, 0x31, 0x32, 0x33, 0x34, 0x35,
+                    0x36, 0x37, 0x38, 0x39, 0x61, 0x62, 0x63, 0x64,
+                    0x65, 0x66, 0x30, 0x31, 0x32, 0x33, 0x34, 0x35},
+    .ciphertext  = {0x6c, 0x3d, 0x83, 0xb4, 0xcd, 0xbf, 0xa6, 0x70,
+                    0x39, 0x0b, 0x83, 0xda, 0xe8, 0x4b, 0x6e, 0x3b,
+                    0x0c, 0x71, 0xcb, 0xeb, 0x44, 0x35, 0xe0, 0x2c,
+                    0x51, 0x8f, 0xdb, 0x46, 0x3e, 0x64, 0x3c, 0xa4,
+                    0xa8, 0x61, 0x33, 0x78, 0x9c, 0x23, 0x29, 0x07},
+    .authdata    = {0x61, 0x73, 0x73, 0x6f, 0x63, 0x20, 0x64, 0x61,
+                    0x74, 0x61, 0x20, 0x31, 0x36, 0x20, 0x62, 0x79},
+    .iv          = {0xd0, 0x0b, 0xbe, 0x88, 0x5a, 0x97, 0x91, 0xf7,
+                    0x1f, 0x7b, 0x46, 0xa8, 0x82, 0x74, 0x6e, 0x4c},
+    .tag         = {0xac, 0xc2, 0xb6, 0x13, 0x8d, 0x2f, 0xc5, 0x51,
+                    0x8e, 0x06, 0xe4, 0x3e, 0xe2, 0x54, 0x48, 0x4f},
+    .authsize    = 16,
+    .datasize    = 40
+};
+static TestVector const testVectorAscon128a_5 PROGMEM = {
+    .name        = "Ascon128a #5",
+    .key         = {0x20, 0x86, 0xf5, 0x7d, 0xea, 0x91, 0x6b, 0x89,
+                    0x14, 0x06, 0xff, 0x62, 0x43, 0x17, 0x14, 0x60},
+    .plaintext   = {0x54, 0x68, 0x65, 0x20, 0x72, 0x61, 0x69, 0x6e,
+                    0x20, 0x69, 0x6e, 0x20, 0x73, 0x70, 0x61, 0x69,
+                    0x6e, 0x20, 0x66, 0x61, 0x6c, 0x6c, 0x73, 0x20,
+                    0x6d, 0x61, 0x69, 0x6e, 0x6c, 0x79, 0x20, 0x6f,
+                    0x6e, 0x20, 0x74, 0x68, 0x65, 0x20, 0x70, 0x6c,
+                    0x61, 0x69, 0x6e},
+    .ciphertext  = {0x4e, 0xf1, 0x7c, 0x2b, 0x3e, 0x7f, 0xdb, 0x7a,
+                    0x92, 0x8b, 0x68, 0xd6, 0x45, 0xe2, 0x67, 0x42,
+                    0x20, 0xe1, 0xfd, 0xe1, 0xc9, 0x39, 0x2a, 0x91,
+                    0x84, 0x95, 0x6b, 0x7a, 0x77, 0x75, 0x5d, 0xe2,
+                    0x03, 0x93, 0x3a, 0xb9, 0x65, 0x0c, 0xad, 0x93,
+                    0x9e, 0x73, 0xc9},
+    .authdata    = {0x48, 0x6f, 0x77, 0x20, 0x6e, 0x6f, 0x77, 0x20,
+                    0x62, 0x72, 0x6f, 0x77, 0x6e, 0x20, 0x63, 0x6f,
+                    0x77},
+    .iv          = {0x0e, 0xd9, 0x3f, 0x0b, 0xc6, 0xfa, 0xb4, 0x34,
+                    0x40, 0x2d, 0xa0, 0x52, 0x0c, 0x81, 0x85, 0xd1},
+    .tag         = {0x12, 0xb2, 0x24, 0x81, 0xd3, 0x07, 0x9b, 0x5e,
+                    0xb3, 0x4d, 0x70, 0xac, 0xb1, 0x91, 0xa6, 0x47},
+    .authsize    = 17,
+    .datasize    = 43
+};
+
 TestVector testVector;
 
 Ascon128 acorn;
+Ascon128a ascon128a;
 
 byte buffer[128];
 
-bool testCipher_N(Ascon128 *cipher, const struct TestVector *test, size_t inc)
+bool testCipher_N(AuthenticatedCipher *cipher, const struct TestVector *test, size_t inc)
 {
     size_t posn, len;
     uint8_t tag[16];
@@ -212,7 +310,7 @@ bool testCipher_N(Ascon128 *cipher, const struct TestVector *test, size_t inc)
     return true;
 }
 
-void testCipher(Ascon128 *cipher, const struct TestVector *test)
+void testCipher(AuthenticatedCipher *cipher, const struct TestVector *test)
 {
     bool ok;
 
@@ -236,7 +334,60 @@ void testCipher(Ascon128 *cipher, const struct TestVector *test)
         Serial.println("Failed");
 }
 
-void perfCipherSetKey(Ascon128 *cipher, const struct TestVector *test)
+bool testInPlace_N(AuthenticatedCipher *cipher, const struct TestVector *test, size_t inc)
+{
+    size_t posn, len;
+
+    cipher->clear();
+    cipher->setKey(test->key, 16);
+    cipher->setIV(test->iv, 16);
+
+    // An empty call to addAuthData() must not change the tag, even
+    // when there is no other associated data.
+    cipher->addAuthData(test->authdata, 0);
+    for (posn = 0; posn < test->authsize; posn += inc) {
+        len = test->authsize - posn;
+        if (len > inc)
+            len = inc;
+        cipher->addAuthData(test->authdata + posn, len);
+    }
+
+    memcpy(buffer, test->ciphertext, test->datasize);
+    for (posn = 0; posn < test->datasize; posn += inc) {
+        len = test->datasize - posn;
+        if (len > inc)
+            len = inc;
+        cipher->decrypt(buffer + posn, buffer + posn, len);
+    }
+
+    if (memcmp(buffer, test->plaintext, test->datasize) != 0)
+        return false;
+
+    return cipher->checkTag(test->tag, 16);
+}
+
+void testInPlace(AuthenticatedCipher *cipher, const struct TestVector *test)
+{
+    bool ok;
+
+    memcpy_P(&testVector, test, sizeof(TestVector));
+    test = &testVector;
+
+    Serial.print(test->name);
+    Serial.print(" In-Place ... ");
+
+    ok  = testInPlace_N(cipher, test, test->datasize ? test->datasize : 1);
+    ok &= testInPlace_N(cipher, test, 1);
+    ok &= testInPlace_N(cipher, test, 5);
+    ok &= testInPlace_N(cipher, test, 16);
+
+    if (ok)
+        Serial.println("Passed");
+    else
+        Serial.println("Failed");
+}
+
+void perfCipherSetKey(AuthenticatedCipher *cipher, const struct TestVector *test)
 {
     unsigned long start;
     unsigned long elapsed;
@@ -261,7 +412,7 @@ void perfCipherSetKey(Ascon128 *cipher, const struct TestVector *test)
     Serial.println(" per second");
 }
 
-void perfCipherEncrypt(Ascon128 *cipher, const struct TestVector *test)
+void perfCipherEncrypt(AuthenticatedCipher *cipher, const struct TestVector *test)
 {
     unsigned long start;
     unsigned long elapsed;
@@ -287,7 +438,7 @@ void perfCipherEncrypt(Ascon128 *cipher, const struct TestVector *test)
     Serial.println(" bytes per second");
 }
 
-void perfCipherDecrypt(Ascon128 *cipher, const struct TestVector *test)
+void perfCipherDecrypt(AuthenticatedCipher *cipher, const struct TestVector *test)
 {
     unsigned long start;
     unsigned long elapsed;
@@ -313,7 +464,7 @@ void perfCipherDecrypt(Ascon128 *cipher, const struct TestVector *test)
     Serial.println(" bytes per second");
 }
 
-void perfCipherAddAuthData(Ascon128 *cipher, const struct TestVector *test)
+void perfCipherAddAuthData(AuthenticatedCipher *cipher, const struct TestVector *test)
 {
     unsigned long start;
     unsigned long elapsed;
@@ -340,7 +491,7 @@ void perfCipherAddAuthData(Ascon128 *cipher, const struct TestVector *test)
     Serial.println(" bytes per second");
 }
 
-void perfCipherComputeTag(Ascon128 *cipher, const struct TestVector *test)
+void perfCipherComputeTag(AuthenticatedCipher *cipher, const struct TestVector *test)
 {
     unsigned long start;
     unsigned long elapsed;
@@ -366,7 +517,7 @@ void perfCipherComputeTag(Ascon128 *cipher, const struct TestVector *test)
     Serial.println(" per second");
 }
 
-void perfCipher(Ascon128 *cipher, const struct TestVector *test)
+void perfCipher(AuthenticatedCipher *cipher, const struct TestVector *test)
 {
     perfCipherSetKey(cipher, test);
     perfCipherEncrypt(cipher, test);
@@ -383,6 +534,8 @@ void setup()
 
     Serial.print("State Size ... ");
     Serial.println(sizeof(Ascon128));
+    Serial.print("State Size (128a) ... ");
+    Serial.println(sizeof(Ascon128a));
     Serial.println();
 
     Serial.println("Test Vectors:");
@@ -391,11 +544,27 @@ void setup()
     testCipher(&acorn, &testVectorAscon128_3);
     testCipher(&acorn, &testVectorAscon128_4);
     testCipher(&acorn, &testVectorAscon128_5);
+    testCipher(&ascon128a, &testVectorAscon128a_1);
+    testCipher(&ascon128a, &testVectorAscon128a_2);
+    testCipher(&ascon128a, &testVectorAscon128a_3);
+    testCipher(&ascon128a, &testVectorAscon128a_4);
+    testCipher(&ascon128a, &testVectorAscon128a_5);
+    testInPlace(&acorn, &testVectorAscon128_1);
+    testInPlace(&acorn, &testVectorAscon128_2);
+    testInPlace(&acorn, &testVectorAscon128_3);
+    testInPlace(&acorn, &testVectorAscon128_4);
+    testInPlace(&acorn, &testVectorAscon128_5);
+    testInPlace(&ascon128a, &testVectorAscon128a_1);
+    testInPlace(&ascon128a, &testVectorAscon128a_2);
+    testInPlace(&ascon128a, &testVectorAscon128a_3);
+    testInPlace(&ascon128a, &testVectorAscon128a_4);
+    testInPlace(&ascon128a, &testVectorAscon128a_5);
 
     Serial.println();
 
     Serial.println("Performance Tests:");
     perfCipher(&acorn, &testVectorAscon128_4);
+    perfCipher(&ascon128a, &testVectorAscon128a_4);
 }
 
 void loop()
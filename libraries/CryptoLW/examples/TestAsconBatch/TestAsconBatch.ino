@@ -0,0 +1,361 @@
+/*
+ * Copyright (C) 2018 Southern Storm Software, Pty Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+This example runs tests on the Ascon128Batch implementation to verify
+correct behaviour.
+*/
+
+#include <Crypto.h>
+#include <CryptoLW.h>
+#include <Ascon128.h>
+#include <Ascon128Batch.h>
+#include <string.h>
+
+#define MAX_FRAMES 37
+#define MAX_AUTHDATA_LEN 20
+#define MAX_PLAINTEXT_LEN 70
+
+struct TestVector
+{
+    uint8_t key[16];
+    uint8_t plaintext[8];
+    uint8_t ciphertext[8];
+    uint8_t authdata[8];
+    uint8_t iv[16];
+    uint8_t tag[16];
+    size_t authsize;
+    size_t datasize;
+};
+
+// Test vectors #1 to #4 from TestAscon, processed as a single batch.
+static TestVector const testVectors[4] = {
+    {
+        {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+         0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+        {0x61, 0x73, 0x63, 0x6f, 0x6e},
+        {0x86, 0x88, 0x62, 0x14, 0x0e},
+        {0x41, 0x53, 0x43, 0x4f, 0x4e},
+        {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+         0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+        {0xad, 0x65, 0xf5, 0x94, 0x22, 0x58, 0xda, 0xd5,
+         0x3c, 0xaa, 0x7a, 0x56, 0xf3, 0xa2, 0x92, 0xd8},
+        5,
+        5
+    },
+    {
+        {0x0d, 0x49, 0x29, 0x92, 0x65, 0x8b, 0xd8, 0xa3,
+         0xe4, 0x7b, 0xf9, 0x10, 0xd4, 0xc5, 0x87, 0xad},
+        {0x61},
+        {0xc5},
+        {0},
+        {0x5a, 0xcb, 0x17, 0x2a, 0x1a, 0x93, 0x3d, 0xb1,
+         0x8a, 0x6a, 0x40, 0xac, 0x6e, 0x4c, 0x68, 0xd0},
+        {0x2e, 0x0b, 0xf2, 0xb1, 0xfc, 0xd8, 0x64, 0x69,
+         0x01, 0x1c, 0x4f, 0x8b, 0x78, 0x4a, 0x65, 0x0d},
+        0,
+        1
+    },
+    {
+        {0x91, 0xb3, 0x9d, 0x22, 0xf3, 0xb7, 0x7f, 0x51,
+         0x33, 0x0a, 0xa3, 0xa4, 0xea, 0x38, 0xea, 0xa2},
+        {0},
+        {0},
+        {0x64},
+        {0x2e, 0xec, 0x64, 0x25, 0xb3, 0xec, 0xf0, 0x63,
+         0xb4, 0x3e, 0x29, 0xc7, 0x68, 0x29, 0x3c, 0x49},
+        {0xfd, 0x24, 0x0e, 0x3c, 0x3d, 0xc4, 0x11, 0x0d,
+         0xe1, 0x54, 0x4c, 0xd5, 0x24, 0x18, 0xd9, 0x4c},
+        1,
+        0
+    },
+    {
+        {0x72, 0xfd, 0x18, 0xde, 0xbd, 0xee, 0x86, 0x13,
+         0x4f, 0x7c, 0x44, 0x29, 0x84, 0x37, 0x56, 0x06},
+        {0x70, 0x6c, 0x61, 0x69, 0x6e, 0x74, 0x78, 0x74},
+        {0x91, 0xd0, 0xc3, 0x88, 0xea, 0xc0, 0xe6, 0xd9},
+        {0x61, 0x73, 0x73, 0x64, 0x61, 0x74, 0x31, 0x32},
+        {0x91, 0x5f, 0xf8, 0xff, 0xca, 0xd8, 0xae, 0x1d,
+         0xf4, 0x45, 0xeb, 0x03, 0xe2, 0x18, 0xfd, 0x25},
+        {0x16, 0x69, 0x74, 0xbf, 0xbd, 0x43, 0xd7, 0xa8,
+         0xfe, 0x43, 0xf0, 0xce, 0xe2, 0xdd, 0xb9, 0xf8},
+        8,
+        8
+    }
+};
+
+struct FrameData
+{
+    uint8_t key[16];
+    uint8_t nonce[16];
+    uint8_t ad[MAX_AUTHDATA_LEN];
+    uint8_t plaintext[MAX_PLAINTEXT_LEN];
+    uint8_t ciphertext[MAX_PLAINTEXT_LEN + 16];
+    uint8_t output[MAX_PLAINTEXT_LEN];
+    uint8_t tag[16];
+};
+
+FrameData data[MAX_FRAMES];
+Ascon128Batch::Frame frames[MAX_FRAMES];
+Ascon128 cipher;
+
+// Simple deterministic generator for the test data.
+static uint32_t seed = 0x12345678;
+static uint8_t nextByte()
+{
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return (uint8_t)seed;
+}
+
+void testVectorBatch()
+{
+    uint8_t output[4][8];
+    uint8_t tag[4][16];
+    bool ok = true;
+    uint8_t index;
+
+    Serial.print("Vectors ... ");
+
+    for (index = 0; index < 4; ++index) {
+        const TestVector *test = &testVectors[index];
+        frames[index].key = test->key;
+        frames[index].nonce = test->iv;
+        frames[index].ad = test->authdata;
+        frames[index].adLen = test->authsize;
+        frames[index].input = test->plaintext;
+        frames[index].output = output[index];
+        frames[index].len = test->datasize;
+        frames[index].tag = tag[index];
+        frames[index].valid = false;
+    }
+    Ascon128Batch::seal(frames, 4);
+    for (index = 0; index < 4; ++index) {
+        const TestVector *test = &testVectors[index];
+        if (memcmp(output[index], test->ciphertext, test->datasize) != 0)
+            ok = false;
+        if (memcmp(tag[index], test->tag, 16) != 0)
+            ok = false;
+        if (!frames[index].valid)
+            ok = false;
+    }
+
+    for (index = 0; index < 4; ++index) {
+        const TestVector *test = &testVectors[index];
+        frames[index].input = test->ciphertext;
+        frames[index].tag = (uint8_t *)(test->tag);
+        frames[index].valid = false;
+    }
+    if (!Ascon128Batch::open(frames, 4))
+        ok = false;
+    for (index = 0; index < 4; ++index) {
+        const TestVector *test = &testVectors[index];
+        if (memcmp(output[index], test->plaintext, test->datasize) != 0)
+            ok = false;
+    }
+
+    if (ok)
+        Serial.println("Passed");
+    else
+        Serial.println("Failed");
+}
+
+// Fills the frames with random keys, nonces, and lengths.
+void generateFrames(size_t count)
+{
+    for (size_t index = 0; index < count; ++index) {
+        FrameData *d = &data[index];
+        for (uint8_t posn = 0; posn < 16; ++posn) {
+            d->key[posn] = nextByte();
+            d->nonce[posn] = nextByte();
+        }
+        for (uint8_t posn = 0; posn < MAX_AUTHDATA_LEN; ++posn)
+            d->ad[posn] = nextByte();
+        for (uint8_t posn = 0; posn < MAX_PLAINTEXT_LEN; ++posn)
+            d->plaintext[posn] = nextByte();
+        frames[index].key = d->key;
+        frames[index].nonce = d->nonce;
+        frames[index].ad = d->ad;
+        frames[index].adLen = nextByte() % (MAX_AUTHDATA_LEN + 1);
+        frames[index].input = d->plaintext;
+        frames[index].output = d->output;
+        frames[index].len = nextByte() % (MAX_PLAINTEXT_LEN + 1);
+        frames[index].tag = d->tag;
+        frames[index].valid = false;
+
+        // Make sure that empty associated data and payloads are covered.
+        if ((index % 4) == 2)
+            frames[index].adLen = 0;
+        if ((index % 5) == 3)
+            frames[index].len = 0;
+
+        // Compute the expected ciphertext with the regular cipher.
+        cipher.clear();
+        cipher.setKey(d->key, 16);
+        cipher.setIV(d->nonce, 16);
+        cipher.addAuthData(d->ad, frames[index].adLen);
+        cipher.encrypt(d->ciphertext, d->plaintext, frames[index].len);
+        cipher.computeTag(d->ciphertext + frames[index].len, 16);
+    }
+}
+
+bool testBatchSize(size_t count)
+{
+    size_t index;
+    bool ok = true;
+
+    // Encrypt the frames and compare against the regular cipher.
+    generateFrames(count);
+    Ascon128Batch::seal(frames, count);
+    for (index = 0; index < count; ++index) {
+        FrameData *d = &data[index];
+        size_t len = frames[index].len;
+        if (memcmp(d->output, d->ciphertext, len) != 0)
+            ok = false;
+        if (memcmp(d->tag, d->ciphertext + len, 16) != 0)
+            ok = false;
+        if (!frames[index].valid)
+            ok = false;
+    }
+
+    // Decrypt the frames in-place.
+    for (index = 0; index < count; ++index) {
+        frames[index].input = data[index].output;
+        frames[index].valid = false;
+    }
+    if (!Ascon128Batch::open(frames, count))
+        ok = false;
+    for (index = 0; index < count; ++index) {
+        FrameData *d = &data[index];
+        if (memcmp(d->output, d->plaintext, frames[index].len) != 0)
+            ok = false;
+    }
+
+    // Corrupt every third tag and check that only those frames fail.
+    for (index = 0; index < count; ++index) {
+        FrameData *d = &data[index];
+        memcpy(d->output, d->ciphertext, frames[index].len);
+        if ((index % 3) == 1)
+            d->tag[index % 16] ^= 0x01;
+    }
+    if (Ascon128Batch::open(frames, count) != (count < 2))
+        ok = false;
+    for (index = 0; index < count; ++index) {
+        FrameData *d = &data[index];
+        size_t len = frames[index].len;
+        if ((index % 3) == 1) {
+            if (frames[index].valid)
+                ok = false;
+            for (size_t posn = 0; posn < len; ++posn) {
+                if (d->output[posn] != 0)
+                    ok = false;
+            }
+        } else {
+            if (!frames[index].valid)
+                ok = false;
+            if (memcmp(d->output, d->plaintext, len) != 0)
+                ok = false;
+        }
+    }
+    return ok;
+}
+
+void testBatch(size_t count)
+{
+    Serial.print("Batch of ");
+    Serial.print(count);
+    Serial.print(" ... ");
+    if (testBatchSize(count))
+        Serial.println("Passed");
+    else
+        Serial.println("Failed");
+}
+
+void perfBatch()
+{
+    unsigned long start;
+    unsigned long elapsed;
+    size_t index;
+    int count;
+
+    // Frames of 64 bytes with 8 bytes of associated data.
+    generateFrames(MAX_FRAMES);
+    for (index = 0; index < MAX_FRAMES; ++index) {
+        frames[index].adLen = 8;
+        frames[index].len = 64;
+    }
+
+    Serial.print("Ascon128 64-byte frames ... ");
+    start = micros();
+    for (count = 0; count < 100; ++count) {
+        for (index = 0; index < MAX_FRAMES; ++index) {
+            cipher.setKey(frames[index].key, 16);
+            cipher.setIV(frames[index].nonce, 16);
+            cipher.addAuthData(frames[index].ad, 8);
+            cipher.encrypt(frames[index].output, frames[index].input, 64);
+            cipher.computeTag(frames[index].tag, 16);
+        }
+    }
+    elapsed = micros() - start;
+    Serial.print(elapsed / (MAX_FRAMES * 100.0));
+    Serial.print("us per frame, ");
+    Serial.print((MAX_FRAMES * 100.0 * 1000000.0) / elapsed);
+    Serial.println(" frames per second");
+
+    Serial.print("Ascon128Batch 64-byte frames ... ");
+    start = micros();
+    for (count = 0; count < 100; ++count) {
+        Ascon128Batch::seal(frames, MAX_FRAMES);
+    }
+    elapsed = micros() - start;
+    Serial.print(elapsed / (MAX_FRAMES * 100.0));
+    Serial.print("us per frame, ");
+    Serial.print((MAX_FRAMES * 100.0 * 1000000.0) / elapsed);
+    Serial.println(" frames per second");
+}
+
+void setup()
+{
+    Serial.begin(9600);
+
+    Serial.println();
+
+    Serial.println("Test Vectors:");
+    testVectorBatch();
+    testBatch(1);
+    testBatch(2);
+    testBatch(3);
+    testBatch(4);
+    testBatch(5);
+    testBatch(9);
+    testBatch(MAX_FRAMES);
+
+    Serial.println();
+
+    Serial.println("Performance Tests:");
+    perfBatch();
+}
+
+void loop()
+{
+}
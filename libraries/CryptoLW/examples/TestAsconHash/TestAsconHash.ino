@@ -0,0 +1,455 @@
+/*
+ * Copyright (C) 2018 Southern Storm Software, Pty Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+This example runs tests on the AsconHash, AsconXof, and AsconMAC
+implementations to verify correct behaviour.
+*/
+
+#include <Crypto.h>
+#include <CryptoLW.h>
+#include <AsconHash.h>
+#include <AsconXof.h>
+#include <AsconMAC.h>
+#include <string.h>
+
+#define HASH_SIZE 32
+#define HMAC_BLOCK_SIZE 32
+#define MAX_OUTPUT 64
+
+struct TestVector
+{
+    const char *name;
+    const char *data;
+    uint8_t output[MAX_OUTPUT];
+    size_t outputLen;
+};
+
+// The first vector for each algorithm is Count 1 from the official known
+// answer tests.  The others were generated with a Python model of the
+// algorithms that reproduces the official vectors.
+static TestVector const testVectorAsconHash_1 = {
+    "AsconHash #1",
+    "",
+    {0x73, 0x46, 0xbc, 0x14, 0xf0, 0x36, 0xe8, 0x7a,
+     0xe0, 0x3d, 0x09, 0x97, 0x91, 0x30, 0x88, 0xf5,
+     0xf6, 0x84, 0x11, 0x43, 0x4b, 0x3c, 0xf8, 0xb5,
+     0x4f, 0xa7, 0x96, 0xa8, 0x0d, 0x25, 0x1f, 0x91},
+    32
+};
+static TestVector const testVectorAsconHash_2 = {
+    "AsconHash #2",
+    "abc",
+    {0xd3, 0x7f, 0xe9, 0xf1, 0xd1, 0x0d, 0xbc, 0xfa,
+     0xd8, 0x40, 0x8a, 0x68, 0x04, 0xdb, 0xe9, 0x11,
+     0x24, 0xa8, 0x91, 0x26, 0x93, 0x32, 0x2b, 0xb2,
+     0x3e, 0xc1, 0x70, 0x1e, 0x19, 0xe3, 0xfd, 0x51},
+    32
+};
+static TestVector const testVectorAsconHash_3 = {
+    "AsconHash #3",
+    "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+    {0x71, 0x65, 0xde, 0x39, 0x73, 0x46, 0xe5, 0x5f,
+     0x20, 0x0f, 0xd1, 0x03, 0x19, 0x35, 0x7a, 0x66,
+     0xdd, 0x6e, 0x64, 0x9b, 0xb4, 0x2c, 0x6d, 0xcf,
+     0xef, 0x39, 0x78, 0x85, 0xc5, 0xc4, 0x25, 0x6c},
+    32
+};
+static TestVector const testVectorAsconXof_1 = {
+    "AsconXof #1",
+    "",
+    {0x5d, 0x4c, 0xbd, 0xe6, 0x35, 0x0e, 0xa4, 0xc1,
+     0x74, 0xbd, 0x65, 0xb5, 0xb3, 0x32, 0xf8, 0x40,
+     0x8f, 0x99, 0x74, 0x0b, 0x81, 0xaa, 0x02, 0x73,
+     0x5e, 0xae, 0xfb, 0xcf, 0x0b, 0xa0, 0x33, 0x9e,
+     0xfb, 0x5a, 0x02, 0xc4, 0xcb, 0xb3, 0x33, 0xb8,
+     0x69, 0x0b, 0x43, 0x21, 0x7f, 0x31, 0xde, 0x29,
+     0x37, 0x16, 0x70, 0x2d, 0xc8, 0x3c, 0x0b, 0x8f,
+     0x26, 0x5a, 0xba, 0x4f, 0x33, 0xcd, 0x13, 0x7e},
+    64
+};
+static TestVector const testVectorAsconXof_2 = {
+    "AsconXof #2",
+    "abc",
+    {0xc9, 0x02, 0x13, 0xa9, 0xe9, 0x3b, 0x19, 0x2c,
+     0x1d, 0x47, 0xf8, 0xaa, 0x20, 0x54, 0x5f, 0x6f,
+     0x86, 0x68, 0x65, 0x27, 0x89, 0x6c, 0xb8, 0xd6,
+     0x53, 0x0b, 0xba, 0xe9, 0x55, 0x4e, 0x6d, 0xc5,
+     0x9b, 0x03, 0x7c, 0x84, 0x8e, 0x1c, 0xb3, 0xaa,
+     0x36, 0x9c, 0xf2, 0x97, 0x46, 0x22, 0x64, 0x95,
+     0x93, 0x9c, 0x44, 0x8f, 0xd7, 0xf0, 0xa8, 0xe2,
+     0x77, 0x00, 0x42, 0xbe, 0x2f, 0xf7, 0x89, 0x05},
+    64
+};
+static TestVector const testVectorAsconMAC_1 = {
+    "AsconMAC #1",
+    "",
+    {0xeb, 0x1a, 0xf6, 0x88, 0x82, 0x5d, 0x66, 0xbf,
+     0x2d, 0x53, 0xe1, 0x35, 0xf9, 0x32, 0x33, 0x15},
+    16
+};
+static TestVector const testVectorAsconMAC_2 = {
+    "AsconMAC #2",
+    "abc",
+    {0x72, 0x44, 0xec, 0xb6, 0x73, 0x4d, 0x17, 0xa0,
+     0x90, 0xb2, 0x07, 0x44, 0x04, 0x5f, 0x9e, 0x38},
+    16
+};
+static TestVector const testVectorAsconMAC_3 = {
+    "AsconMAC #3",
+    "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+    {0x8d, 0x20, 0x56, 0x39, 0x28, 0x88, 0xa1, 0x08,
+     0xa0, 0x42, 0x2e, 0x23, 0xf9, 0xad, 0x6e, 0xab},
+    16
+};
+static TestVector const testVectorAsconPRF_1 = {
+    "AsconPRF #1",
+    "abc",
+    {0x83, 0x91, 0x5d, 0xd4, 0xb1, 0x54, 0x14, 0xd1,
+     0xce, 0x2f, 0x16, 0x5d, 0xd0, 0x34, 0x5b, 0x2f,
+     0x45, 0x18, 0x6e, 0xef, 0xb0, 0x76, 0xe2, 0xb9,
+     0x99, 0x4a, 0xb0, 0x80, 0x6d, 0xd9, 0x6a, 0x92,
+     0x27, 0x66, 0x6e, 0xb3, 0xcc, 0x0f, 0xda, 0x56},
+    40
+};
+
+// Key for the MAC and PRF tests.
+static uint8_t const testKey[16] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+};
+
+AsconHash hash;
+AsconXof xof;
+AsconMAC mac;
+
+byte buffer[128];
+
+static const size_t increments[] = {1, 2, 5, 8, 13, 16, 24, 32, 33, 64};
+
+bool testHash_N(const struct TestVector *test, size_t inc)
+{
+    size_t size = strlen(test->data);
+    size_t posn, len;
+    uint8_t value[HASH_SIZE];
+
+    hash.reset();
+    for (posn = 0; posn < size; posn += inc) {
+        len = size - posn;
+        if (len > inc)
+            len = inc;
+        hash.update(test->data + posn, len);
+    }
+    hash.finalize(value, sizeof(value));
+    return memcmp(value, test->output, sizeof(value)) == 0;
+}
+
+void testHash(const struct TestVector *test)
+{
+    bool ok;
+
+    Serial.print(test->name);
+    Serial.print(" ... ");
+
+    ok = testHash_N(test, strlen(test->data) + 1);
+    for (size_t index = 0; index < sizeof(increments) / sizeof(size_t); ++index)
+        ok &= testHash_N(test, increments[index]);
+
+    if (ok)
+        Serial.println("Passed");
+    else
+        Serial.println("Failed");
+}
+
+bool testXof_N(const struct TestVector *test, size_t inc)
+{
+    size_t size = strlen(test->data);
+    size_t posn, len;
+    uint8_t value[MAX_OUTPUT];
+
+    xof.reset();
+    for (posn = 0; posn < size; posn += inc) {
+        len = size - posn;
+        if (len > inc)
+            len = inc;
+        xof.update(test->data + posn, len);
+    }
+    for (posn = 0; posn < test->outputLen; posn += inc) {
+        len = test->outputLen - posn;
+        if (len > inc)
+            len = inc;
+        xof.extend(value + posn, len);
+    }
+    if (memcmp(value, test->output, test->outputLen) != 0)
+        return false;
+
+    // Use the XOF to encrypt a buffer of zeroes and check the output.
+    xof.reset();
+    xof.update(test->data, size);
+    memset(value, 0, sizeof(value));
+    for (posn = 0; posn < test->outputLen; posn += inc) {
+        len = test->outputLen - posn;
+        if (len > inc)
+            len = inc;
+        xof.encrypt(value + posn, value + posn, len);
+    }
+    return memcmp(value, test->output, test->outputLen) == 0;
+}
+
+void testXof(const struct TestVector *test)
+{
+    bool ok;
+
+    Serial.print(test->name);
+    Serial.print(" ... ");
+
+    ok = testXof_N(test, test->outputLen);
+    for (size_t index = 0; index < sizeof(increments) / sizeof(size_t); ++index)
+        ok &= testXof_N(test, increments[index]);
+
+    if (ok)
+        Serial.println("Passed");
+    else
+        Serial.println("Failed");
+}
+
+bool testMAC_N(const struct TestVector *test, bool prf, size_t inc)
+{
+    size_t size = strlen(test->data);
+    size_t posn, len;
+    uint8_t value[MAX_OUTPUT];
+
+    if (prf)
+        mac.resetPRF(testKey);
+    else
+        mac.reset(testKey);
+    for (posn = 0; posn < size; posn += inc) {
+        len = size - posn;
+        if (len > inc)
+            len = inc;
+        mac.update(test->data + posn, len);
+    }
+    mac.finalize(value, test->outputLen);
+    return memcmp(value, test->output, test->outputLen) == 0;
+}
+
+void testMAC(const struct TestVector *test, bool prf)
+{
+    bool ok;
+
+    Serial.print(test->name);
+    Serial.print(" ... ");
+
+    ok = testMAC_N(test, prf, strlen(test->data) + 1);
+    for (size_t index = 0; index < sizeof(increments) / sizeof(size_t); ++index)
+        ok &= testMAC_N(test, prf, increments[index]);
+
+    if (ok)
+        Serial.println("Passed");
+    else
+        Serial.println("Failed");
+}
+
+// Very simple method for hashing a HMAC inner or outer key.
+void hashKey(const uint8_t *key, size_t keyLen, uint8_t pad)
+{
+    size_t posn;
+    uint8_t buf;
+    uint8_t result[HASH_SIZE];
+    if (keyLen <= HMAC_BLOCK_SIZE) {
+        hash.reset();
+        for (posn = 0; posn < HMAC_BLOCK_SIZE; ++posn) {
+            if (posn < keyLen)
+                buf = key[posn] ^ pad;
+            else
+                buf = pad;
+            hash.update(&buf, 1);
+        }
+    } else {
+        hash.reset();
+        hash.update(key, keyLen);
+        hash.finalize(result, HASH_SIZE);
+        hash.reset();
+        for (posn = 0; posn < HMAC_BLOCK_SIZE; ++posn) {
+            if (posn < HASH_SIZE)
+                buf = result[posn] ^ pad;
+            else
+                buf = pad;
+            hash.update(&buf, 1);
+        }
+    }
+}
+
+void testHMAC(size_t keyLen)
+{
+    uint8_t result[HASH_SIZE];
+
+    Serial.print("HMAC-AsconHash keysize=");
+    Serial.print(keyLen);
+    Serial.print(" ... ");
+
+    // Construct the expected result with a simple HMAC implementation.
+    memset(buffer, (uint8_t)keyLen, keyLen);
+    hashKey(buffer, keyLen, 0x36);
+    memset(buffer, 0xBA, sizeof(buffer));
+    hash.update(buffer, sizeof(buffer));
+    hash.finalize(result, HASH_SIZE);
+    memset(buffer, (uint8_t)keyLen, keyLen);
+    hashKey(buffer, keyLen, 0x5C);
+    hash.update(result, HASH_SIZE);
+    hash.finalize(result, HASH_SIZE);
+
+    // Now use the library to compute the HMAC.
+    hash.resetHMAC(buffer, keyLen);
+    memset(buffer, 0xBA, sizeof(buffer));
+    hash.update(buffer, sizeof(buffer));
+    memset(buffer, (uint8_t)keyLen, keyLen);
+    hash.finalizeHMAC(buffer, keyLen, buffer, HASH_SIZE);
+
+    // Check the result.
+    if (!memcmp(result, buffer, HASH_SIZE))
+        Serial.println("Passed");
+    else
+        Serial.println("Failed");
+}
+
+void perfHash()
+{
+    unsigned long start;
+    unsigned long elapsed;
+    int count;
+
+    Serial.print("AsconHash ... ");
+
+    for (size_t posn = 0; posn < sizeof(buffer); ++posn)
+        buffer[posn] = (uint8_t)posn;
+
+    hash.reset();
+    start = micros();
+    for (count = 0; count < 500; ++count) {
+        hash.update(buffer, sizeof(buffer));
+    }
+    elapsed = micros() - start;
+
+    Serial.print(elapsed / (sizeof(buffer) * 500.0));
+    Serial.print("us per byte, ");
+    Serial.print((sizeof(buffer) * 500.0 * 1000000.0) / elapsed);
+    Serial.println(" bytes per second");
+}
+
+void perfXof()
+{
+    unsigned long start;
+    unsigned long elapsed;
+    int count;
+
+    Serial.print("AsconXof Extend ... ");
+
+    xof.reset();
+    xof.update("abc", 3);
+    start = micros();
+    for (count = 0; count < 500; ++count) {
+        xof.extend(buffer, sizeof(buffer));
+    }
+    elapsed = micros() - start;
+
+    Serial.print(elapsed / (sizeof(buffer) * 500.0));
+    Serial.print("us per byte, ");
+    Serial.print((sizeof(buffer) * 500.0 * 1000000.0) / elapsed);
+    Serial.println(" bytes per second");
+}
+
+void perfMAC()
+{
+    unsigned long start;
+    unsigned long elapsed;
+    int count;
+
+    Serial.print("AsconMAC ... ");
+
+    for (size_t posn = 0; posn < sizeof(buffer); ++posn)
+        buffer[posn] = (uint8_t)posn;
+
+    mac.reset(testKey);
+    start = micros();
+    for (count = 0; count < 500; ++count) {
+        mac.update(buffer, sizeof(buffer));
+    }
+    elapsed = micros() - start;
+
+    Serial.print(elapsed / (sizeof(buffer) * 500.0));
+    Serial.print("us per byte, ");
+    Serial.print((sizeof(buffer) * 500.0 * 1000000.0) / elapsed);
+    Serial.println(" bytes per second");
+
+    Serial.print("HMAC-AsconHash ... ");
+
+    hash.resetHMAC(testKey, sizeof(testKey));
+    start = micros();
+    for (count = 0; count < 500; ++count) {
+        hash.update(buffer, sizeof(buffer));
+    }
+    elapsed = micros() - start;
+
+    Serial.print(elapsed / (sizeof(buffer) * 500.0));
+    Serial.print("us per byte, ");
+    Serial.print((sizeof(buffer) * 500.0 * 1000000.0) / elapsed);
+    Serial.println(" bytes per second");
+}
+
+void setup()
+{
+    Serial.begin(9600);
+
+    Serial.println();
+
+    Serial.print("State Size ...");
+    Serial.println(sizeof(AsconHash));
+    Serial.println();
+
+    Serial.println("Test Vectors:");
+    testHash(&testVectorAsconHash_1);
+    testHash(&testVectorAsconHash_2);
+    testHash(&testVectorAsconHash_3);
+    testXof(&testVectorAsconXof_1);
+    testXof(&testVectorAsconXof_2);
+    testMAC(&testVectorAsconMAC_1, false);
+    testMAC(&testVectorAsconMAC_2, false);
+    testMAC(&testVectorAsconMAC_3, false);
+    testMAC(&testVectorAsconPRF_1, true);
+    testHMAC(0);
+    testHMAC(1);
+    testHMAC(HASH_SIZE);
+    testHMAC(HMAC_BLOCK_SIZE + 1);
+    testHMAC(sizeof(buffer));
+
+    Serial.println();
+
+    Serial.println("Performance Tests:");
+    perfHash();
+    perfXof();
+    perfMAC();
+}
+
+void loop()
+{
+}
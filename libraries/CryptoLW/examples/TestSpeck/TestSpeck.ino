@@ -76,6 +76,11 @@ SpeckTiny speckTiny;
 
 byte buffer[16];
 
+#define MAX_BLOCKS 15
+
+byte blocks[MAX_BLOCKS * 16];
+byte expected[MAX_BLOCKS * 16];
+
 void testCipher(BlockCipher *cipher, const struct TestVector *test, size_t keySize, bool decryption = true)
 {
     crypto_feed_watchdog();
@@ -101,6 +106,56 @@ void testCipher(BlockCipher *cipher, const struct TestVector *test, size_t keySi
         Serial.println("Failed");
 }
 
+void testEncryptBlocks(Speck *cipher, const struct TestVector *test, size_t keySize)
+{
+    size_t count, posn;
+    bool ok = true;
+
+    crypto_feed_watchdog();
+
+    Serial.print(test->name);
+    Serial.print(" Encrypt Blocks ... ");
+    cipher->setKey(test->key, keySize);
+    for (count = 1; count <= MAX_BLOCKS && ok; ++count) {
+        for (posn = 0; posn < count * 16; ++posn)
+            blocks[posn] = (byte)(posn * 7 + count);
+        memcpy(blocks, test->plaintext, 16);
+        for (posn = 0; posn < count; ++posn)
+            cipher->encryptBlock(expected + posn * 16, blocks + posn * 16);
+        cipher->encryptBlocks(blocks, blocks, count);
+        if (memcmp(blocks, expected, count * 16) != 0 ||
+                memcmp(blocks, test->ciphertext, 16) != 0)
+            ok = false;
+    }
+    if (ok)
+        Serial.println("Passed");
+    else
+        Serial.println("Failed");
+}
+
+void perfEncryptBlocks(Speck *cipher, const struct TestVector *test, size_t keySize)
+{
+    unsigned long start;
+    unsigned long elapsed;
+    int count;
+
+    crypto_feed_watchdog();
+
+    Serial.print(test->name);
+    Serial.print(" Encrypt Blocks ... ");
+    cipher->setKey(test->key, keySize);
+    memset(blocks, 0xAA, sizeof(blocks));
+    start = micros();
+    for (count = 0; count < 500; ++count) {
+        cipher->encryptBlocks(blocks, blocks, MAX_BLOCKS);
+    }
+    elapsed = micros() - start;
+    Serial.print(elapsed / (500.0 * sizeof(blocks)));
+    Serial.print("us per byte, ");
+    Serial.print((500.0 * sizeof(blocks) * 1000000.0) / elapsed);
+    Serial.println(" bytes per second");
+}
+
 void perfCipher(BlockCipher *cipher, const struct TestVector *test, size_t keySize, bool decryption = true)
 {
     unsigned long start;
@@ -172,6 +227,9 @@ void setup()
     testCipher(&speck, &testVectorSpeck128, 16);
     testCipher(&speck, &testVectorSpeck192, 24);
     testCipher(&speck, &testVectorSpeck256, 32);
+    testEncryptBlocks(&speck, &testVectorSpeck128, 16);
+    testEncryptBlocks(&speck, &testVectorSpeck192, 24);
+    testEncryptBlocks(&speck, &testVectorSpeck256, 32);
 
     Serial.println();
 
@@ -193,6 +251,10 @@ void setup()
     perfCipher(&speck, &testVectorSpeck128, 16);
     perfCipher(&speck, &testVectorSpeck192, 24);
     perfCipher(&speck, &testVectorSpeck256, 32);
+    perfEncryptBlocks(&speck, &testVectorSpeck128, 16);
+    perfEncryptBlocks(&speck, &testVectorSpeck192, 24);
+    perfEncryptBlocks(&speck, &testVectorSpeck256, 32);
+    Serial.println();
 
     Serial.println("SpeckSmall Performance Tests:");
     perfCipher(&speckSmall, &testVectorSpeck128, 16);
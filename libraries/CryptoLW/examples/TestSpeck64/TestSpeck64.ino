@@ -0,0 +1,362 @@
+/*
+ * Copyright (C) 2018 Southern Storm Software, Pty Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+This example runs tests on the Speck64 implementation to verify correct
+behaviour, including its use with the CTR and EAX block cipher modes.
+*/
+
+#include <Crypto.h>
+#include <CryptoLW.h>
+#include <Speck64.h>
+#include <Speck64Tiny.h>
+#include <CTR.h>
+#include <EAX.h>
+#include <string.h>
+
+struct TestVector
+{
+    const char *name;
+    byte key[16];
+    byte plaintext[8];
+    byte ciphertext[8];
+};
+
+// Define the test vectors from http://eprint.iacr.org/2013/404
+static TestVector const testVectorSpeck64_96 = {
+    .name        = "Speck-64-96-ECB",
+    .key         = {0x13, 0x12, 0x11, 0x10, 0x0b, 0x0a, 0x09, 0x08,
+                    0x03, 0x02, 0x01, 0x00},
+    .plaintext   = {0x74, 0x61, 0x46, 0x20, 0x73, 0x6e, 0x61, 0x65},
+    .ciphertext  = {0x9f, 0x79, 0x52, 0xec, 0x41, 0x75, 0x94, 0x6c}
+};
+static TestVector const testVectorSpeck64_128 = {
+    .name        = "Speck-64-128-ECB",
+    .key         = {0x1b, 0x1a, 0x19, 0x18, 0x13, 0x12, 0x11, 0x10,
+                    0x0b, 0x0a, 0x09, 0x08, 0x03, 0x02, 0x01, 0x00},
+    .plaintext   = {0x3b, 0x72, 0x65, 0x74, 0x74, 0x75, 0x43, 0x2d},
+    .ciphertext  = {0x8c, 0x6f, 0xa5, 0x48, 0x45, 0x4e, 0x02, 0x8b}
+};
+
+static uint8_t const iv[8] = {
+    0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xff
+};
+
+// EAX-Speck64-128 known-answer vector, generated with an independent
+// Python model of EAX over Speck64 with 64-bit blocks: the key bytes are
+// i * 7 + 1, the nonce is a0..ac, the authenticated data is 00..12,
+// and the plaintext bytes are 0x30 + i.
+static uint8_t const eaxKey[16] = {
+    0x01, 0x08, 0x0f, 0x16, 0x1d, 0x24, 0x2b, 0x32,
+    0x39, 0x40, 0x47, 0x4e, 0x55, 0x5c, 0x63, 0x6a
+};
+static uint8_t const eaxNonce[13] = {
+    0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7,
+    0xa8, 0xa9, 0xaa, 0xab, 0xac
+};
+static uint8_t const eaxAuthData[19] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+    0x10, 0x11, 0x12
+};
+static uint8_t const eaxPlaintext[37] = {
+    0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37,
+    0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f,
+    0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47,
+    0x48, 0x49, 0x4a, 0x4b, 0x4c, 0x4d, 0x4e, 0x4f,
+    0x50, 0x51, 0x52, 0x53, 0x54
+};
+static uint8_t const eaxCiphertext[37] = {
+    0xbe, 0x6e, 0x59, 0x6b, 0xc4, 0xb5, 0x21, 0x1f,
+    0x36, 0x69, 0x8e, 0x24, 0x74, 0x60, 0x67, 0x2d,
+    0xab, 0x02, 0x98, 0xa8, 0xb0, 0xa1, 0xde, 0x3f,
+    0x20, 0x51, 0x14, 0xb2, 0x8d, 0xa7, 0x06, 0xd0,
+    0xd8, 0x3f, 0x7b, 0x09, 0xa0
+};
+static uint8_t const eaxTag[8] = {
+    0x9b, 0x77, 0x35, 0x6e, 0x3a, 0xf6, 0xf8, 0xbd
+};
+
+#define MAX_DATA_LEN 40
+
+Speck64 speck64;
+Speck64Tiny speck64Tiny;
+CTR<Speck64> ctrSpeck64;
+EAX<Speck64> eaxSpeck64;
+EAX<Speck64Tiny> eaxSpeck64Tiny;
+
+byte buffer[MAX_DATA_LEN];
+byte expected[MAX_DATA_LEN];
+byte plaintext[MAX_DATA_LEN];
+byte tag[8];
+byte tag2[8];
+
+void testCipher(BlockCipher *cipher, const struct TestVector *test, size_t keySize, bool decryption = true)
+{
+    crypto_feed_watchdog();
+
+    Serial.print(test->name);
+    Serial.print(" Encryption ... ");
+    cipher->setKey(test->key, keySize);
+    cipher->encryptBlock(buffer, test->plaintext);
+    if (memcmp(buffer, test->ciphertext, 8) == 0)
+        Serial.println("Passed");
+    else
+        Serial.println("Failed");
+
+    if (!decryption)
+        return;
+
+    Serial.print(test->name);
+    Serial.print(" Decryption ... ");
+    cipher->decryptBlock(buffer, test->ciphertext);
+    if (memcmp(buffer, test->plaintext, 8) == 0)
+        Serial.println("Passed");
+    else
+        Serial.println("Failed");
+}
+
+void testCTR(const struct TestVector *test, size_t keySize)
+{
+    uint8_t counter[8];
+    size_t posn, index;
+
+    crypto_feed_watchdog();
+
+    Serial.print(test->name);
+    Serial.print(" CTR ... ");
+
+    // Generate the expected keystream one block at a time, with the
+    // counter wrapping around in the last byte of the IV.
+    speck64.setKey(test->key, keySize);
+    memcpy(counter, iv, 8);
+    for (posn = 0; posn < MAX_DATA_LEN; posn += 8) {
+        speck64.encryptBlock(expected + posn, counter);
+        for (index = 8; index > 0; ) {
+            if (++(counter[--index]) != 0)
+                break;
+        }
+    }
+
+    // CTR mode on a zero plaintext should produce the same keystream.
+    memset(plaintext, 0, sizeof(plaintext));
+    ctrSpeck64.setKey(test->key, keySize);
+    if (ctrSpeck64.ivSize() != 8 || !ctrSpeck64.setIV(iv, 8)) {
+        Serial.println("Failed");
+        return;
+    }
+    ctrSpeck64.encrypt(buffer, plaintext, 3);
+    ctrSpeck64.encrypt(buffer + 3, plaintext + 3, MAX_DATA_LEN - 3);
+    if (memcmp(buffer, expected, MAX_DATA_LEN) == 0)
+        Serial.println("Passed");
+    else
+        Serial.println("Failed");
+}
+
+void testEAX(const struct TestVector *test, size_t keySize)
+{
+    size_t posn;
+    bool ok = true;
+
+    crypto_feed_watchdog();
+
+    Serial.print(test->name);
+    Serial.print(" EAX ... ");
+
+    for (posn = 0; posn < MAX_DATA_LEN; ++posn)
+        plaintext[posn] = (byte)(posn * 3 + 1);
+
+    // Encrypt with the full-schedule version of the cipher.
+    eaxSpeck64.setKey(test->key, keySize);
+    eaxSpeck64.setIV(iv, sizeof(iv));
+    eaxSpeck64.addAuthData(test->plaintext, 8);
+    eaxSpeck64.encrypt(expected, plaintext, MAX_DATA_LEN);
+    if (eaxSpeck64.tagSize() != 8)
+        ok = false;
+    eaxSpeck64.computeTag(tag, sizeof(tag));
+
+    // The tiny version must produce the same ciphertext and tag.
+    eaxSpeck64Tiny.setKey(test->key, keySize);
+    eaxSpeck64Tiny.setIV(iv, sizeof(iv));
+    eaxSpeck64Tiny.addAuthData(test->plaintext, 8);
+    eaxSpeck64Tiny.encrypt(buffer, plaintext, MAX_DATA_LEN);
+    eaxSpeck64Tiny.computeTag(tag2, sizeof(tag2));
+    if (memcmp(buffer, expected, MAX_DATA_LEN) != 0 ||
+            memcmp(tag, tag2, sizeof(tag)) != 0)
+        ok = false;
+
+    // Decrypt and check the tag.
+    eaxSpeck64.setKey(test->key, keySize);
+    eaxSpeck64.setIV(iv, sizeof(iv));
+    eaxSpeck64.addAuthData(test->plaintext, 8);
+    eaxSpeck64.decrypt(buffer, expected, MAX_DATA_LEN);
+    if (!eaxSpeck64.checkTag(tag, sizeof(tag)) ||
+            memcmp(buffer, plaintext, MAX_DATA_LEN) != 0)
+        ok = false;
+
+    // A tampered tag must be rejected.
+    tag[0] ^= 0x01;
+    eaxSpeck64.setIV(iv, sizeof(iv));
+    eaxSpeck64.addAuthData(test->plaintext, 8);
+    eaxSpeck64.decrypt(buffer, expected, MAX_DATA_LEN);
+    if (eaxSpeck64.checkTag(tag, sizeof(tag)))
+        ok = false;
+
+    if (ok)
+        Serial.println("Passed");
+    else
+        Serial.println("Failed");
+}
+
+void testEAXVector(AuthenticatedCipher *cipher, const char *name)
+{
+    bool ok = true;
+
+    crypto_feed_watchdog();
+
+    Serial.print(name);
+    Serial.print(" ... ");
+
+    // Encrypt in two pieces to exercise partial keystream blocks.
+    cipher->setKey(eaxKey, sizeof(eaxKey));
+    cipher->setIV(eaxNonce, sizeof(eaxNonce));
+    cipher->addAuthData(eaxAuthData, sizeof(eaxAuthData));
+    cipher->encrypt(buffer, eaxPlaintext, 5);
+    cipher->encrypt(buffer + 5, eaxPlaintext + 5, sizeof(eaxPlaintext) - 5);
+    cipher->computeTag(tag, sizeof(tag));
+    if (memcmp(buffer, eaxCiphertext, sizeof(eaxCiphertext)) != 0 ||
+            memcmp(tag, eaxTag, sizeof(eaxTag)) != 0)
+        ok = false;
+
+    cipher->setKey(eaxKey, sizeof(eaxKey));
+    cipher->setIV(eaxNonce, sizeof(eaxNonce));
+    cipher->addAuthData(eaxAuthData, sizeof(eaxAuthData));
+    cipher->decrypt(buffer, eaxCiphertext, sizeof(eaxCiphertext));
+    if (!cipher->checkTag(eaxTag, sizeof(eaxTag)) ||
+            memcmp(buffer, eaxPlaintext, sizeof(eaxPlaintext)) != 0)
+        ok = false;
+
+    if (ok)
+        Serial.println("Passed");
+    else
+        Serial.println("Failed");
+}
+
+void perfCipher(BlockCipher *cipher, const struct TestVector *test, size_t keySize, bool decryption = true)
+{
+    unsigned long start;
+    unsigned long elapsed;
+    int count;
+
+    crypto_feed_watchdog();
+
+    Serial.print(test->name);
+    Serial.print(" Set Key ... ");
+    start = micros();
+    for (count = 0; count < 10000; ++count) {
+        cipher->setKey(test->key, keySize);
+    }
+    elapsed = micros() - start;
+    Serial.print(elapsed / 10000.0);
+    Serial.print("us per operation, ");
+    Serial.print((10000.0 * 1000000.0) / elapsed);
+    Serial.println(" per second");
+
+    Serial.print(test->name);
+    Serial.print(" Encrypt ... ");
+    start = micros();
+    for (count = 0; count < 10000; ++count) {
+        cipher->encryptBlock(buffer, buffer);
+    }
+    elapsed = micros() - start;
+    Serial.print(elapsed / (10000.0 * 8.0));
+    Serial.print("us per byte, ");
+    Serial.print((8.0 * 10000.0 * 1000000.0) / elapsed);
+    Serial.println(" bytes per second");
+
+    if (!decryption) {
+        Serial.println();
+        return;
+    }
+
+    Serial.print(test->name);
+    Serial.print(" Decrypt ... ");
+    start = micros();
+    for (count = 0; count < 10000; ++count) {
+        cipher->decryptBlock(buffer, buffer);
+    }
+    elapsed = micros() - start;
+    Serial.print(elapsed / (10000.0 * 8.0));
+    Serial.print("us per byte, ");
+    Serial.print((8.0 * 10000.0 * 1000000.0) / elapsed);
+    Serial.println(" bytes per second");
+
+    Serial.println();
+}
+
+void setup()
+{
+    Serial.begin(9600);
+
+    Serial.println();
+
+    Serial.println("State Sizes:");
+    Serial.print("Speck64 ... ");
+    Serial.println(sizeof(Speck64));
+    Serial.print("Speck64Tiny ... ");
+    Serial.println(sizeof(Speck64Tiny));
+    Serial.println();
+
+    Serial.println("Speck64 Test Vectors:");
+    testCipher(&speck64, &testVectorSpeck64_96, 12);
+    testCipher(&speck64, &testVectorSpeck64_128, 16);
+
+    Serial.println();
+
+    Serial.println("Speck64Tiny Test Vectors:");
+    testCipher(&speck64Tiny, &testVectorSpeck64_96, 12, false);
+    testCipher(&speck64Tiny, &testVectorSpeck64_128, 16, false);
+
+    Serial.println();
+
+    Serial.println("Block Cipher Modes:");
+    testCTR(&testVectorSpeck64_96, 12);
+    testCTR(&testVectorSpeck64_128, 16);
+    testEAX(&testVectorSpeck64_96, 12);
+    testEAX(&testVectorSpeck64_128, 16);
+    testEAXVector(&eaxSpeck64, "EAX-Speck64-128 Vector");
+    testEAXVector(&eaxSpeck64Tiny, "EAX-Speck64Tiny-128 Vector");
+
+    Serial.println();
+
+    Serial.println("Speck64 Performance Tests:");
+    perfCipher(&speck64, &testVectorSpeck64_96, 12);
+    perfCipher(&speck64, &testVectorSpeck64_128, 16);
+
+    Serial.println("Speck64Tiny Performance Tests:");
+    perfCipher(&speck64Tiny, &testVectorSpeck64_96, 12, false);
+    perfCipher(&speck64Tiny, &testVectorSpeck64_128, 16, false);
+}
+
+void loop()
+{
+}
@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2018 Southern Storm Software, Pty Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+This example runs tests on the SpeckCTR implementation to verify
+that it produces the same output as CTR<Speck>.
+*/
+
+#include <Crypto.h>
+#include <CryptoLW.h>
+#include <Speck.h>
+#include <SpeckCTR.h>
+#include <CTR.h>
+#include <string.h>
+
+#define MAX_DATA_LEN 200
+
+static uint8_t const key[32] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+    0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f
+};
+static uint8_t const iv1[16] = {
+    0x70, 0x6f, 0x6f, 0x6e, 0x65, 0x72, 0x2e, 0x20,
+    0x49, 0x6e, 0x20, 0x74, 0x68, 0x6f, 0x73, 0x65
+};
+static uint8_t const iv2[16] = {
+    0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7,
+    0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xff, 0xfb
+};
+
+CTR<Speck> ctrSpeck;
+SpeckCTR speckCTR;
+
+byte plaintext[MAX_DATA_LEN];
+byte expected[MAX_DATA_LEN];
+byte buffer[MAX_DATA_LEN];
+
+bool testSpeckCTR(size_t keySize, const uint8_t *iv, size_t counterSize, size_t inc)
+{
+    size_t posn, len;
+
+    crypto_feed_watchdog();
+
+    ctrSpeck.setKey(key, keySize);
+    ctrSpeck.setCounterSize(counterSize);
+    ctrSpeck.setIV(iv, 16);
+    ctrSpeck.encrypt(expected, plaintext, MAX_DATA_LEN);
+
+    speckCTR.setKey(key, keySize);
+    speckCTR.setCounterSize(counterSize);
+    speckCTR.setIV(iv, 16);
+    for (posn = 0; posn < MAX_DATA_LEN; posn += inc) {
+        len = MAX_DATA_LEN - posn;
+        if (len > inc)
+            len = inc;
+        speckCTR.encrypt(buffer + posn, plaintext + posn, len);
+    }
+    if (memcmp(buffer, expected, MAX_DATA_LEN) != 0)
+        return false;
+
+    speckCTR.setIV(iv, 16);
+    for (posn = 0; posn < MAX_DATA_LEN; posn += inc) {
+        len = MAX_DATA_LEN - posn;
+        if (len > inc)
+            len = inc;
+        speckCTR.decrypt(buffer + posn, buffer + posn, len);
+    }
+    return memcmp(buffer, plaintext, MAX_DATA_LEN) == 0;
+}
+
+void testSpeckCTR(const char *name, const uint8_t *iv, size_t counterSize)
+{
+    static size_t const keySizes[3] = {16, 24, 32};
+    static size_t const incs[6] = {1, 7, 16, 33, 128, MAX_DATA_LEN};
+    bool ok = true;
+    for (uint8_t k = 0; k < 3 && ok; ++k) {
+        for (uint8_t i = 0; i < 6 && ok; ++i)
+            ok = testSpeckCTR(keySizes[k], iv, counterSize, incs[i]);
+    }
+    Serial.print(name);
+    Serial.print(" ... ");
+    if (ok)
+        Serial.println("Passed");
+    else
+        Serial.println("Failed");
+}
+
+void perfCipherEncrypt(const char *name, Cipher *cipher)
+{
+    unsigned long start;
+    unsigned long elapsed;
+    int count;
+
+    crypto_feed_watchdog();
+
+    Serial.print(name);
+    Serial.print(" ... ");
+
+    cipher->setKey(key, 32);
+    cipher->setIV(iv1, 16);
+    start = micros();
+    for (count = 0; count < 500; ++count) {
+        cipher->encrypt(buffer, buffer, sizeof(buffer));
+    }
+    elapsed = micros() - start;
+
+    Serial.print(elapsed / (sizeof(buffer) * 500.0));
+    Serial.print("us per byte, ");
+    Serial.print((sizeof(buffer) * 500.0 * 1000000.0) / elapsed);
+    Serial.println(" bytes per second");
+}
+
+void setup()
+{
+    Serial.begin(9600);
+
+    Serial.println();
+
+    for (size_t posn = 0; posn < MAX_DATA_LEN; ++posn)
+        plaintext[posn] = (byte)(posn * 13 + 5);
+
+    Serial.print("State Size ... ");
+    Serial.println(sizeof(SpeckCTR));
+    Serial.println();
+
+    Serial.println("Test Vectors:");
+    testSpeckCTR("SpeckCTR Counter 16", iv1, 16);
+    testSpeckCTR("SpeckCTR Counter 2 Wrap", iv2, 2);
+    testSpeckCTR("SpeckCTR Counter 16 Carry", iv2, 16);
+
+    Serial.println();
+
+    Serial.println("Performance Tests:");
+    perfCipherEncrypt("CTR<Speck> Encrypt", &ctrSpeck);
+    perfCipherEncrypt("SpeckCTR Encrypt", &speckCTR);
+}
+
+void loop()
+{
+}
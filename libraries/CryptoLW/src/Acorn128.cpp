@@ -448,6 +448,190 @@ static inline uint32_t acornDecrypt32(Acorn128State *state, uint32_t ciphertext)
     return plaintext;
 }
 
+#if defined(CRYPTO_ACORN128_64BIT)
+
+/**
+ * \brief Acorn128 state with each LFSR in a single 64-bit register.
+ *
+ * Bit 0 of each register is the lowest-numbered state bit of its LFSR.
+ */
+typedef struct
+{
+    uint64_t s1;        // LFSR1, 61 bits, 0..60
+    uint64_t s2;        // LFSR2, 46 bits, 61..106
+    uint64_t s3;        // LFSR3, 47 bits, 107..153
+    uint64_t s4;        // LFSR4, 39 bits, 154..192
+    uint64_t s5;        // LFSR5, 37 bits, 193..229
+    uint64_t s6;        // LFSR6, 59 bits, 230..288
+    uint32_t s7;        // Top most 4 bits, 289..292
+
+} Acorn128Regs;
+
+/**
+ * \brief Unpacks the Acorn128 state into 64-bit registers.
+ *
+ * \param regs The registers to unpack into.
+ * \param state The packed state for the Acorn128 cipher.
+ */
+static inline void acornLoadRegs(Acorn128Regs *regs, const Acorn128State *state)
+{
+    regs->s1 = state->s1_l | (((uint64_t)(state->s1_h)) << 32);
+    regs->s2 = state->s2_l | (((uint64_t)(state->s2_h)) << 32);
+    regs->s3 = state->s3_l | (((uint64_t)(state->s3_h)) << 32);
+    regs->s4 = state->s4_l | (((uint64_t)(state->s4_h)) << 32);
+    regs->s5 = state->s5_l | (((uint64_t)(state->s5_h)) << 32);
+    regs->s6 = state->s6_l | (((uint64_t)(state->s6_h)) << 32);
+    regs->s7 = state->s7;
+}
+
+/**
+ * \brief Packs 64-bit registers back into the Acorn128 state.
+ *
+ * \param state The packed state for the Acorn128 cipher.
+ * \param regs The registers to pack.
+ */
+static inline void acornStoreRegs(Acorn128State *state, const Acorn128Regs *regs)
+{
+    state->s1_l = (uint32_t)(regs->s1);
+    state->s1_h = (uint32_t)(regs->s1 >> 32);
+    state->s2_l = (uint32_t)(regs->s2);
+    state->s2_h = (uint16_t)(regs->s2 >> 32);
+    state->s3_l = (uint32_t)(regs->s3);
+    state->s3_h = (uint16_t)(regs->s3 >> 32);
+    state->s4_l = (uint32_t)(regs->s4);
+    state->s4_h = (uint16_t)(regs->s4 >> 32);
+    state->s5_l = (uint32_t)(regs->s5);
+    state->s5_h = (uint16_t)(regs->s5 >> 32);
+    state->s6_l = (uint32_t)(regs->s6);
+    state->s6_h = (uint32_t)(regs->s6 >> 32);
+    state->s7 = (uint8_t)(regs->s7);
+}
+
+/**
+ * \brief Runs 32 steps of Acorn128 on the 64-bit register layout.
+ *
+ * \param regs The registers for the Acorn128 cipher.
+ * \param input The plaintext or ciphertext word.
+ * \param ca The ca constant.
+ * \param cb The cb constant.
+ * \param decrypt Non-zero if \a input is ciphertext rather than plaintext.
+ *
+ * \return The ciphertext or plaintext word.
+ *
+ * This is the same computation as acornEncrypt32() and acornDecrypt32(),
+ * but every tap is a single shift of a register and the state shifts
+ * downwards with a single 64-bit shift and OR per LFSR.
+ */
+static inline uint32_t acornStepRegs
+    (Acorn128Regs *regs, uint32_t input, uint32_t ca, uint32_t cb,
+     uint8_t decrypt)
+{
+    // Extract out various sub-parts of the state as 32-bit words.
+    uint32_t s244 = (uint32_t)(regs->s6 >> 14);
+    uint32_t s235 = (uint32_t)(regs->s6 >> 5);
+    uint32_t s196 = (uint32_t)(regs->s5 >> 3);
+    uint32_t s160 = (uint32_t)(regs->s4 >> 6);
+    uint32_t s111 = (uint32_t)(regs->s3 >> 4);
+    uint32_t s66  = (uint32_t)(regs->s2 >> 5);
+    uint32_t s23  = (uint32_t)(regs->s1 >> 23);
+    uint32_t s12  = (uint32_t)(regs->s1 >> 12);
+
+    // Update the LFSR's.
+    uint32_t s7_l = regs->s7 ^ s235 ^ (uint32_t)(regs->s6);
+    regs->s6 ^= (uint32_t)(s196 ^ regs->s5);
+    regs->s5 ^= (uint32_t)(s160 ^ regs->s4);
+    regs->s4 ^= (uint32_t)(s111 ^ regs->s3);
+    regs->s3 ^= (uint32_t)(s66  ^ regs->s2);
+    regs->s2 ^= (uint32_t)(s23  ^ regs->s1);
+
+    // Generate the next 32 keystream bits.
+    // k = S[12] ^ S[154] ^ maj(S[235], S[61], S[193])
+    //                    ^  ch(S[230], S[111], S[66])
+    uint32_t ks = s12 ^ (uint32_t)(regs->s4) ^
+                  maj(s235, (uint32_t)(regs->s2), (uint32_t)(regs->s5)) ^
+                  ch((uint32_t)(regs->s6), s111, s66);
+    uint32_t output = input ^ ks;
+
+    // Generate the next 32 non-linear feedback bits.
+    // f = S[0] ^ ~S[107] ^ maj(S[244], S[23], S[160])
+    //                    ^ (ca & S[196]) ^ (cb & ks)
+    // f ^= plaintext
+    uint32_t f = (uint32_t)(regs->s1) ^ (~(uint32_t)(regs->s3)) ^
+                 maj(s244, s23, s160) ^ (ca & s196) ^ (cb & ks);
+    f ^= decrypt ? output : input;
+
+    // Shift the state downwards by 32 bits.
+    #define s_shift_regs(name1, name2, shift) \
+        (regs->name1 = (regs->name1 >> 32) | \
+                       (((uint64_t)(uint32_t)(regs->name2)) << (shift)))
+    s7_l ^= (f << 4);
+    regs->s7 = f >> 28;
+    s_shift_regs(s1, s2, 29);
+    s_shift_regs(s2, s3, 14);
+    s_shift_regs(s3, s4, 15);
+    s_shift_regs(s4, s5, 7);
+    s_shift_regs(s5, s6, 5);
+    regs->s6 = (regs->s6 >> 32) | (((uint64_t)s7_l) << 27);
+
+    // Return the output word to the caller.
+    return output;
+}
+
+/**
+ * \brief Encrypts a 64-bit word using Acorn128.
+ *
+ * \param regs The registers for the Acorn128 cipher.
+ * \param plaintext The plaintext word, in little-endian bit order.
+ * \param ca The ca constant.
+ * \param cb The cb constant.
+ *
+ * \return The ciphertext word.
+ *
+ * The LFSR taps only allow 33 steps to be computed in parallel
+ * (S[196] is 34 bits below the update to S[230]), so the 64 steps
+ * are performed as two 32-bit halves without leaving the registers.
+ */
+static inline uint64_t acornEncrypt64
+    (Acorn128Regs *regs, uint64_t plaintext, uint32_t ca, uint32_t cb)
+{
+    uint32_t lo = acornStepRegs(regs, (uint32_t)plaintext, ca, cb, 0);
+    uint32_t hi = acornStepRegs(regs, (uint32_t)(plaintext >> 32), ca, cb, 0);
+    return lo | (((uint64_t)hi) << 32);
+}
+
+/**
+ * \brief Decrypts a 64-bit word using Acorn128.
+ *
+ * \param regs The registers for the Acorn128 cipher.
+ * \param ciphertext The ciphertext word, in little-endian bit order.
+ *
+ * \return The plaintext word.
+ */
+static inline uint64_t acornDecrypt64(Acorn128Regs *regs, uint64_t ciphertext)
+{
+    uint32_t lo = acornStepRegs(regs, (uint32_t)ciphertext, CA_1, CB_0, 1);
+    uint32_t hi = acornStepRegs(regs, (uint32_t)(ciphertext >> 32), CA_1, CB_0, 1);
+    return lo | (((uint64_t)hi) << 32);
+}
+
+/**
+ * \brief Adds 256 bits of padding to the Acorn128 registers.
+ *
+ * \param regs The registers for the Acorn128 cipher.
+ * \param cb The cb constant for the padding block.
+ *
+ * \sa acornPad()
+ */
+static void acornPadRegs(Acorn128Regs *regs, uint32_t cb)
+{
+    acornEncrypt64(regs, 1, CA_1, cb);
+    acornEncrypt64(regs, 0, CA_1, cb);
+    acornEncrypt64(regs, 0, CA_0, cb);
+    acornEncrypt64(regs, 0, CA_0, cb);
+}
+
+#endif // CRYPTO_ACORN128_64BIT
+
 #elif defined(CRYPTO_ACORN128_AVR)
 
 // Import definitions from Acorn128AVR.cpp
@@ -525,6 +709,28 @@ bool Acorn128::setIV(const uint8_t *iv, size_t len)
 
     // Run the cipher for 1792 steps, 32 at a time,
     // which mixes the key and IV into the cipher state.
+#if defined(CRYPTO_ACORN128_64BIT)
+    Acorn128Regs regs;
+    uint64_t k0 = state.k[0] | (((uint64_t)(state.k[1])) << 32);
+    uint64_t k1 = state.k[2] | (((uint64_t)(state.k[3])) << 32);
+    acornLoadRegs(&regs, &state);
+    acornEncrypt64(&regs, k0, CA_1, CB_1);
+    acornEncrypt64(&regs, k1, CA_1, CB_1);
+    acornEncrypt64(&regs, ivwords[0] | (((uint64_t)(ivwords[1])) << 32),
+                   CA_1, CB_1);
+    acornEncrypt64(&regs, ivwords[2] | (((uint64_t)(ivwords[3])) << 32),
+                   CA_1, CB_1);
+    acornEncrypt64(&regs, k0 ^ 0x00000001, CA_1, CB_1);
+    acornEncrypt64(&regs, k1, CA_1, CB_1);
+    for (uint8_t i = 0; i < 11; ++i) {
+        acornEncrypt64(&regs, k0, CA_1, CB_1);
+        acornEncrypt64(&regs, k1, CA_1, CB_1);
+    }
+    acornStoreRegs(&state, &regs);
+    clean(regs);
+    clean(k0);
+    clean(k1);
+#else
     acornEncrypt32(&state, state.k[0], CA_1, CB_1);
     acornEncrypt32(&state, state.k[1], CA_1, CB_1);
     acornEncrypt32(&state, state.k[2], CA_1, CB_1);
@@ -543,6 +749,7 @@ bool Acorn128::setIV(const uint8_t *iv, size_t len)
         acornEncrypt32(&state, state.k[2], CA_1, CB_1);
         acornEncrypt32(&state, state.k[3], CA_1, CB_1);
     }
+#endif
 
     // Clean up and exit.
     clean(ivwords);
@@ -557,6 +764,23 @@ void Acorn128::encrypt(uint8_t *output, const uint8_t *input, size_t len)
         acornPad(&state, CB_1);
         state.authDone = 1;
     }
+#if defined(CRYPTO_ACORN128_64BIT)
+    if (len >= 8) {
+        Acorn128Regs regs;
+        acornLoadRegs(&regs, &state);
+        do {
+            uint64_t temp;
+            memcpy(&temp, input, 8);
+            temp = htole64(acornEncrypt64(&regs, le64toh(temp), CA_1, CB_0));
+            memcpy(output, &temp, 8);
+            input += 8;
+            output += 8;
+            len -= 8;
+        } while (len >= 8);
+        acornStoreRegs(&state, &regs);
+        clean(regs);
+    }
+#endif
     while (len >= 4) {
         uint32_t temp = ((uint32_t)input[0]) |
                        (((uint32_t)input[1]) << 8) |
@@ -583,6 +807,23 @@ void Acorn128::decrypt(uint8_t *output, const uint8_t *input, size_t len)
         acornPad(&state, CB_1);
         state.authDone = 1;
     }
+#if defined(CRYPTO_ACORN128_64BIT)
+    if (len >= 8) {
+        Acorn128Regs regs;
+        acornLoadRegs(&regs, &state);
+        do {
+            uint64_t temp;
+            memcpy(&temp, input, 8);
+            temp = htole64(acornDecrypt64(&regs, le64toh(temp)));
+            memcpy(output, &temp, 8);
+            input += 8;
+            output += 8;
+            len -= 8;
+        } while (len >= 8);
+        acornStoreRegs(&state, &regs);
+        clean(regs);
+    }
+#endif
     while (len >= 4) {
         uint32_t temp = ((uint32_t)input[0]) |
                        (((uint32_t)input[1]) << 8) |
@@ -611,6 +852,21 @@ void Acorn128::addAuthData(const void *data, size_t len)
 
     // Encrypt the auth data with ca = 1, cb = 1.
     const uint8_t *input = (const uint8_t *)data;
+#if defined(CRYPTO_ACORN128_64BIT)
+    if (len >= 8) {
+        Acorn128Regs regs;
+        acornLoadRegs(&regs, &state);
+        do {
+            uint64_t temp;
+            memcpy(&temp, input, 8);
+            acornEncrypt64(&regs, le64toh(temp), CA_1, CB_1);
+            input += 8;
+            len -= 8;
+        } while (len >= 8);
+        acornStoreRegs(&state, &regs);
+        clean(regs);
+    }
+#endif
     while (len >= 4) {
         uint32_t temp = ((uint32_t)input[0]) |
                        (((uint32_t)input[1]) << 8) |
@@ -631,18 +887,40 @@ void Acorn128::addAuthData(const void *data, size_t len)
 void Acorn128::computeTag(void *tag, size_t len)
 {
     // Finalize the data and apply padding.
+    uint32_t temp[4];
+#if defined(CRYPTO_ACORN128_64BIT)
+    Acorn128Regs regs;
+    acornLoadRegs(&regs, &state);
+    if (!state.authDone)
+        acornPadRegs(&regs, CB_1);
+    acornPadRegs(&regs, CB_0);
+
+    // Encrypt 768 zero bits and extract the last 128 for the tag.
+    for (uint8_t i = 0; i < 10; ++i)
+        acornEncrypt64(&regs, 0, CA_1, CB_1);
+    uint64_t tag64[2];
+    tag64[0] = acornEncrypt64(&regs, 0, CA_1, CB_1);
+    tag64[1] = acornEncrypt64(&regs, 0, CA_1, CB_1);
+    acornStoreRegs(&state, &regs);
+    temp[0] = (uint32_t)(tag64[0]);
+    temp[1] = (uint32_t)(tag64[0] >> 32);
+    temp[2] = (uint32_t)(tag64[1]);
+    temp[3] = (uint32_t)(tag64[1] >> 32);
+    clean(regs);
+    clean(tag64);
+#else
     if (!state.authDone)
         acornPad(&state, CB_1);
     acornPad(&state, CB_0);
 
     // Encrypt 768 zero bits and extract the last 128 for the tag.
-    uint32_t temp[4];
     for (uint8_t i = 0; i < 20; ++i)
         acornEncrypt32(&state, 0, CA_1, CB_1);
     temp[0] = acornEncrypt32(&state, 0, CA_1, CB_1);
     temp[1] = acornEncrypt32(&state, 0, CA_1, CB_1);
     temp[2] = acornEncrypt32(&state, 0, CA_1, CB_1);
     temp[3] = acornEncrypt32(&state, 0, CA_1, CB_1);
+#endif
 #if !defined(CRYPTO_LITTLE_ENDIAN)
     temp[0] = htole32(temp[0]);
     temp[1] = htole32(temp[1]);
@@ -35,6 +35,8 @@
 // authors uses 7 uint64_t registers, for a total state size
 // of 448 bits.  This version uses 328 bits for same data and
 // should be efficient on 8-bit and 32-bit microcontrollers.
+// On 64-bit platforms, the LFSR's are unpacked into 64-bit
+// registers for the duration of each bulk operation instead.
 typedef struct
 {
     uint32_t k[4];      // Cached copy of the key for multiple requests.
@@ -60,6 +62,9 @@ typedef struct
 #define CRYPTO_ACORN128_AVR 1
 #else
 #define CRYPTO_ACORN128_DEFAULT 1
+#if defined(__SIZEOF_POINTER__) && __SIZEOF_POINTER__ >= 8
+#define CRYPTO_ACORN128_64BIT 1
+#endif
 #endif
 
 /** @endcond */
@@ -25,6 +25,7 @@
 #include "utility/EndianUtil.h"
 #include "utility/RotateUtil.h"
 #include "utility/ProgMemUtil.h"
+#include "utility/AsconUtil.h"
 #include <string.h>
 
 /**
@@ -102,10 +103,8 @@ bool Ascon128::setKey(const uint8_t *key, size_t len)
     if (len != 16)
         return false;
     memcpy(state.K, key, 16);
-#if defined(CRYPTO_LITTLE_ENDIAN)
-    state.K[0] = be64toh(state.K[0]);
-    state.K[1] = be64toh(state.K[1]);
-#endif
+    state.K[0] = ascon_to_state(be64toh(state.K[0]));
+    state.K[1] = ascon_to_state(be64toh(state.K[1]));
     return true;
 }
 
@@ -116,13 +115,13 @@ bool Ascon128::setIV(const uint8_t *iv, size_t len)
         return false;
 
     // Set up the initial state.
-    state.S[0] = 0x80400C0600000000ULL;
+    state.S[0] = ascon_to_state(0x80400C0600000000ULL);
     state.S[1] = state.K[0];
     state.S[2] = state.K[1];
     memcpy(state.S + 3, iv, 16);
+    state.S[3] = ascon_to_state(be64toh(state.S[3]));
+    state.S[4] = ascon_to_state(be64toh(state.S[4]));
 #if defined(CRYPTO_LITTLE_ENDIAN)
-    state.S[3] = be64toh(state.S[3]);
-    state.S[4] = be64toh(state.S[4]);
     posn = 7;
     authMode = 1;
 #else
@@ -131,7 +130,7 @@ bool Ascon128::setIV(const uint8_t *iv, size_t len)
 #endif
 
     // Permute the state with 12 rounds starting at round 0.
-    permute(0);
+    permute(state.S, 0);
 
     // XOR the end of the state with the original key.
     state.S[3] ^= state.K[0];
@@ -146,9 +145,25 @@ void Ascon128::encrypt(uint8_t *output, const uint8_t *input, size_t len)
     const uint8_t *in = (const uint8_t *)input;
     uint8_t *out = (uint8_t *)output;
     while (len > 0) {
+#if !defined(__AVR__)
+        if (posn == ASCON_BYTE(0) && len >= 8) {
+            // Encrypt an entire block at once using the first word.
+            uint64_t word;
+            memcpy(&word, in, 8);
+            state.S[0] ^= ascon_to_state(be64toh(word));
+            word = htobe64(ascon_from_state(state.S[0]));
+            memcpy(out, &word, 8);
+            in += 8;
+            out += 8;
+            len -= 8;
+            permute(state.S, 6);
+            continue;
+        }
+#endif
+
         // Encrypt the next byte using the first 64-bit word in the state.
-        ((uint8_t *)(state.S))[posn] ^= *in++;
-        *out++ = ((const uint8_t *)(state.S))[posn];
+        ascon_xor_byte(state.S, posn, *in++);
+        *out++ = ascon_get_byte(state.S, posn);
         --len;
 
         // Permute the state for b = 6 rounds at the end of each block.
@@ -156,12 +171,12 @@ void Ascon128::encrypt(uint8_t *output, const uint8_t *input, size_t len)
         if (posn > 0) {
             --posn;
         } else {
-            permute(6);
+            permute(state.S, 6);
             posn = 7;
         }
 #else
         if ((++posn) == 8) {
-            permute(6);
+            permute(state.S, 6);
             posn = 0;
         }
 #endif
@@ -175,9 +190,27 @@ void Ascon128::decrypt(uint8_t *output, const uint8_t *input, size_t len)
     const uint8_t *in = (const uint8_t *)input;
     uint8_t *out = (uint8_t *)output;
     while (len > 0) {
+#if !defined(__AVR__)
+        if (posn == ASCON_BYTE(0) && len >= 8) {
+            // Decrypt an entire block at once using the first word.
+            uint64_t word;
+            memcpy(&word, in, 8);
+            uint64_t c = ascon_to_state(be64toh(word));
+            word = htobe64(ascon_from_state(state.S[0] ^ c));
+            state.S[0] = c;
+            memcpy(out, &word, 8);
+            in += 8;
+            out += 8;
+            len -= 8;
+            permute(state.S, 6);
+            continue;
+        }
+#endif
+
         // Decrypt the next byte using the first 64-bit word in the state.
-        *out++ = ((const uint8_t *)(state.S))[posn] ^ *in;
-        ((uint8_t *)(state.S))[posn] = *in++;
+        uint8_t c = *in++;
+        *out++ = ascon_get_byte(state.S, posn) ^ c;
+        ascon_set_byte(state.S, posn, c);
         --len;
 
         // Permute the state for b = 6 rounds at the end of each block.
@@ -185,12 +218,12 @@ void Ascon128::decrypt(uint8_t *output, const uint8_t *input, size_t len)
         if (posn > 0) {
             --posn;
         } else {
-            permute(6);
+            permute(state.S, 6);
             posn = 7;
         }
 #else
         if ((++posn) == 8) {
-            permute(6);
+            permute(state.S, 6);
             posn = 0;
         }
 #endif
@@ -199,12 +232,25 @@ void Ascon128::decrypt(uint8_t *output, const uint8_t *input, size_t len)
 
 void Ascon128::addAuthData(const void *data, size_t len)
 {
-    if (!authMode)
+    if (!authMode || !len)
         return;
     const uint8_t *in = (const uint8_t *)data;
     while (len > 0) {
+#if !defined(__AVR__)
+        if (posn == ASCON_BYTE(0) && len >= 8) {
+            // Absorb an entire block at once into the first word.
+            uint64_t word;
+            memcpy(&word, in, 8);
+            state.S[0] ^= ascon_to_state(be64toh(word));
+            in += 8;
+            len -= 8;
+            permute(state.S, 6);
+            continue;
+        }
+#endif
+
         // Incorporate the next byte of auth data into the internal state.
-        ((uint8_t *)(state.S))[posn] ^= *in++;
+        ascon_xor_byte(state.S, posn, *in++);
         --len;
 
         // Permute the state for b = 6 rounds at the end of each block.
@@ -212,12 +258,12 @@ void Ascon128::addAuthData(const void *data, size_t len)
         if (posn > 0) {
             --posn;
         } else {
-            permute(6);
+            permute(state.S, 6);
             posn = 7;
         }
 #else
         if ((++posn) == 8) {
-            permute(6);
+            permute(state.S, 6);
             posn = 0;
         }
 #endif
@@ -232,15 +278,15 @@ void Ascon128::computeTag(void *tag, size_t len)
         endAuth();
 
     // Pad the last block, add the original key, and permute the state.
-    ((uint8_t *)(state.S))[posn] ^= 0x80;
+    ascon_xor_byte(state.S, posn, 0x80);
     state.S[1] ^= state.K[0];
     state.S[2] ^= state.K[1];
-    permute(0);
+    permute(state.S, 0);
 
     // Compute the tag and convert it into big-endian in the return buffer.
     uint64_t T[2];
-    T[0] = htobe64(state.S[3] ^ state.K[0]);
-    T[1] = htobe64(state.S[4] ^ state.K[1]);
+    T[0] = htobe64(ascon_from_state(state.S[3] ^ state.K[0]));
+    T[1] = htobe64(ascon_from_state(state.S[4] ^ state.K[1]));
     if (len > 16)
         len = 16;
     memcpy(tag, T, len);
@@ -258,15 +304,15 @@ bool Ascon128::checkTag(const void *tag, size_t len)
         endAuth();
 
     // Pad the last block, add the original key, and permute the state.
-    ((uint8_t *)(state.S))[posn] ^= 0x80;
+    ascon_xor_byte(state.S, posn, 0x80);
     state.S[1] ^= state.K[0];
     state.S[2] ^= state.K[1];
-    permute(0);
+    permute(state.S, 0);
 
     // Compute the tag and convert it into big-endian.
     uint64_t T[2];
-    T[0] = htobe64(state.S[3] ^ state.K[0]);
-    T[1] = htobe64(state.S[4] ^ state.K[1]);
+    T[0] = htobe64(ascon_from_state(state.S[3] ^ state.K[0]));
+    T[1] = htobe64(ascon_from_state(state.S[4] ^ state.K[1]));
     if (len > 16)
         len = 16;
     bool ok = secure_compare(T, tag, len);
@@ -289,21 +335,112 @@ void Ascon128::clear()
 #endif
 }
 
+/** @cond */
+
+#if ASCON_INTERLEAVED
+
+// Round constants for the interleaved form: even bits in the low nibble
+// and odd bits in the high nibble.
+static uint8_t const asconInterleavedRC[12] = {
+    0xCC, 0xC9, 0x9C, 0x99, 0xC6, 0xC3, 0x96, 0x93,
+    0x6C, 0x69, 0x3C, 0x39
+};
+
+#endif
+
+/** @endcond */
+
 #if !defined(__AVR__) || defined(CRYPTO_DOC)
 
 /**
- * \brief Permutes the Ascon128 state.
+ * \brief Permutes an Ascon state.
  *
+ * \param S The five 64-bit words of the state, in host byte order.
  * \param first The first round start permuting at, between 0 and 11.
+ *
+ * This is the permutation that is shared by all members of the Ascon
+ * family.  Passing 0 for \a first performs all 12 rounds, 6 performs
+ * the last 6 rounds, and so on.
+ *
+ * On 32-bit platforms the words of \a S are in the bit-interleaved form
+ * rather than the regular form.  Use the helpers in utility/AsconUtil.h
+ * to absorb data into or squeeze data out of the state.
  */
-void Ascon128::permute(uint8_t first)
+void Ascon128::permute(uint64_t S[5], uint8_t first)
 {
+#if ASCON_INTERLEAVED
+    // The state is in bit-interleaved form, with the even bits of each
+    // word in e[] and the odd bits in o[].
+    uint32_t e[5], o[5];
+    uint32_t t0, t1, t2, t3, t4;
+    uint8_t index;
+    for (index = 0; index < 5; ++index) {
+        e[index] = (uint32_t)(S[index]);
+        o[index] = (uint32_t)(S[index] >> 32);
+    }
+
+    // Bit-sliced s-box applied separately to the even and odd halves.
+    #define ascon_sbox(x0, x1, x2, x3, x4) \
+        do { \
+            x0 ^= x4;   x4 ^= x3;   x2 ^= x1; \
+            t0 = ~x0;   t1 = ~x1;   t2 = ~x2;   t3 = ~x3;   t4 = ~x4; \
+            t0 &= x1;   t1 &= x2;   t2 &= x3;   t3 &= x4;   t4 &= x0; \
+            x0 ^= t1;   x1 ^= t2;   x2 ^= t3;   x3 ^= t4;   x4 ^= t0; \
+            x1 ^= x0;   x0 ^= x4;   x3 ^= x2;   x2 = ~x2; \
+        } while (0)
+
+    while (first < 12) {
+        // Add the round constant to the state.
+        uint8_t rc = asconInterleavedRC[first];
+        e[2] ^= rc & 0x0F;
+        o[2] ^= rc >> 4;
+
+        // Substitution layer.
+        ascon_sbox(e[0], e[1], e[2], e[3], e[4]);
+        ascon_sbox(o[0], o[1], o[2], o[3], o[4]);
+
+        // Linear diffusion layer.  A 64-bit rotation by an even amount
+        // 2k rotates both halves by k.  A rotation by an odd amount 2k+1
+        // swaps the halves, rotating the new even half by k and the new
+        // odd half by k+1.
+        t0 = e[0] ^ rightRotate9(o[0]) ^ rightRotate14(e[0]);
+        t1 = o[0] ^ rightRotate10(e[0]) ^ rightRotate14(o[0]);
+        e[0] = t0;
+        o[0] = t1;
+        t0 = e[1] ^ rightRotate30(o[1]) ^ rightRotate19(o[1]);
+        t1 = o[1] ^ rightRotate31(e[1]) ^ rightRotate20(e[1]);
+        e[1] = t0;
+        o[1] = t1;
+        t0 = e[2] ^ o[2] ^ rightRotate3(e[2]);
+        t1 = o[2] ^ rightRotate1(e[2]) ^ rightRotate3(o[2]);
+        e[2] = t0;
+        o[2] = t1;
+        t0 = e[3] ^ rightRotate5(e[3]) ^ rightRotate8(o[3]);
+        t1 = o[3] ^ rightRotate5(o[3]) ^ rightRotate9(e[3]);
+        e[3] = t0;
+        o[3] = t1;
+        t0 = e[4] ^ rightRotate3(o[4]) ^ rightRotate20(o[4]);
+        t1 = o[4] ^ rightRotate4(e[4]) ^ rightRotate21(e[4]);
+        e[4] = t0;
+        o[4] = t1;
+
+        // Move onto the next round.
+        ++first;
+    }
+    #undef ascon_sbox
+
+    // Store the words back into the state.
+    for (index = 0; index < 5; ++index)
+        S[index] = (((uint64_t)(o[index])) << 32) | e[index];
+    clean(e);
+    clean(o);
+#else
     uint64_t t0, t1, t2, t3, t4;
-    #define x0 state.S[0]
-    #define x1 state.S[1]
-    #define x2 state.S[2]
-    #define x3 state.S[3]
-    #define x4 state.S[4]
+    #define x0 S[0]
+    #define x1 S[1]
+    #define x2 S[2]
+    #define x3 S[3]
+    #define x4 S[4]
     while (first < 12) {
         // Add the round constant to the state.
         x2 ^= ((0x0F - first) << 4) | first;
@@ -331,6 +468,7 @@ void Ascon128::permute(uint8_t first)
     #undef x2
     #undef x3
     #undef x4
+#endif
 }
 
 #endif // !__AVR__
@@ -343,8 +481,8 @@ void Ascon128::endAuth()
     if (authMode == 2) {
         // We had some auth data, so we need to pad and permute the last block.
         // There is no need to do this if there were zero bytes of auth data.
-        ((uint8_t *)(state.S))[posn] ^= 0x80;
-        permute(6);
+        ascon_xor_byte(state.S, posn, 0x80);
+        permute(state.S, 6);
     }
     state.S[4] ^= 1; // Domain separation between auth data and payload data.
     authMode = 0;
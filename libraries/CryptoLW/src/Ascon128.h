@@ -48,6 +48,8 @@ public:
 
     void clear();
 
+    static void permute(uint64_t S[5], uint8_t first);
+
 private:
     struct {
         uint64_t K[2];
@@ -56,7 +58,6 @@ private:
     uint8_t posn;
     uint8_t authMode;
 
-    void permute(uint8_t first);
     void endAuth();
 };
 
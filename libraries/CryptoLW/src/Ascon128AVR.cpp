@@ -24,7 +24,7 @@
 
 #if defined(__AVR__)
 
-void Ascon128::permute(uint8_t first)
+void Ascon128::permute(uint64_t S[5], uint8_t first)
 {
     // AVR version generated by the genascon tool.
     __asm__ __volatile__ (
@@ -710,7 +710,7 @@ void Ascon128::permute(uint8_t first)
         "breq 2f\n"
         "rjmp 1b\n"
         "2:\n"
-        :: "z"(state.S), "d"((uint8_t)(0xF0 - (first << 4) + first))
+        :: "z"(S), "d"((uint8_t)(0xF0 - (first << 4) + first))
         : "r17", "r18", "r19", "r20", "r21", "r22", "r23", "r7", "r8", "r9", "r10", "r11", "r12", "r13", "r14", "r15", "memory"
     );
 }
@@ -0,0 +1,486 @@
+/*
+ * Copyright (C) 2018 Southern Storm Software, Pty Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "Ascon128Batch.h"
+#include "Ascon128.h"
+#include "Crypto.h"
+#include "utility/EndianUtil.h"
+#include <string.h>
+
+// Use AVX2 to process four frames at a time on x86 hosts when the CPU
+// supports it.  Define ASCON_NO_AVX2 to always use the portable code.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && \
+        !defined(ASCON_NO_AVX2)
+#include <immintrin.h>
+#define ASCON_AVX2 1
+#else
+#define ASCON_AVX2 0
+#endif
+
+/**
+ * \class Ascon128Batch Ascon128Batch.h <Ascon128Batch.h>
+ * \brief Encrypts and decrypts batches of independent Ascon128 frames.
+ *
+ * This class is intended for gateways that receive many short frames
+ * from different senders, where a single Ascon128 object spends most
+ * of its time in the permutation for one frame at a time.  Each frame
+ * has its own key, nonce, associated data, and payload, described by a
+ * Frame structure.  The nonce and key are always 16 bytes in size, and
+ * so is the authentication tag.
+ *
+ * \code
+ * Ascon128Batch::Frame frames[N];
+ * // Fill in the key, nonce, ad, adLen, input, output, len, and tag
+ * // fields for each frame, and then:
+ * if (!Ascon128Batch::open(frames, N)) {
+ *     // At least one frame failed to authenticate; check frames[i].valid.
+ * }
+ * \endcode
+ *
+ * On x86 hosts with AVX2, the permutation is applied to the states of
+ * four frames at once.  Frames with different lengths are handled by
+ * masking: each lane of the vector state advances through its own frame
+ * and picks up the next waiting frame as soon as it is finished.  Lanes
+ * that have run out of frames are left unchanged.  On other platforms
+ * the frames are processed one after the other with Ascon128.
+ *
+ * The results are identical to those from Ascon128 with a 16-byte tag.
+ *
+ * \sa Ascon128
+ */
+
+/**
+ * \struct Ascon128Batch::Frame
+ * \brief Describes a single frame to be processed by Ascon128Batch.
+ *
+ * \var Ascon128Batch::Frame::key
+ * Points to the 16-byte key for the frame.
+ *
+ * \var Ascon128Batch::Frame::nonce
+ * Points to the 16-byte nonce for the frame.
+ *
+ * \var Ascon128Batch::Frame::ad
+ * Points to the associated data for the frame, or NULL if \a adLen is zero.
+ *
+ * \var Ascon128Batch::Frame::adLen
+ * Length of the associated data in bytes.
+ *
+ * \var Ascon128Batch::Frame::input
+ * Points to the plaintext for seal() or the ciphertext for open().
+ *
+ * \var Ascon128Batch::Frame::output
+ * Points to the buffer that receives the ciphertext for seal() or the
+ * plaintext for open().  This may be the same as \a input.
+ *
+ * \var Ascon128Batch::Frame::len
+ * Length of the \a input and \a output buffers in bytes.
+ *
+ * \var Ascon128Batch::Frame::tag
+ * Points to the 16-byte authentication tag.  This is written by seal()
+ * and checked by open().
+ *
+ * \var Ascon128Batch::Frame::valid
+ * Set to true by seal(), and by open() if the tag was correct.
+ */
+
+/** @cond */
+
+// Initialization vector for Ascon-128.
+#define ASCON128_IV     0x80400C0600000000ULL
+
+// Phases that each lane moves through while processing a frame.
+#define ASCON_LANE_START    0
+#define ASCON_LANE_INIT     1
+#define ASCON_LANE_KEY      2
+#define ASCON_LANE_AD       3
+#define ASCON_LANE_SEP      4
+#define ASCON_LANE_MSG      5
+#define ASCON_LANE_FINAL    6
+#define ASCON_LANE_TAG      7
+
+// Returned by advanceLane() when there are no more frames for the lane.
+#define ASCON_LANE_IDLE     0xFF
+
+// Number of frames that are processed in parallel.
+#define ASCON_LANES         4
+
+#if ASCON_AVX2
+
+#define ASCON_AVX2_TARGET __attribute__((target("avx2")))
+
+#define ror64_avx2(x, bits) \
+    _mm256_or_si256(_mm256_srli_epi64((x), (bits)), \
+                    _mm256_slli_epi64((x), 64 - (bits)))
+
+// Applies six rounds of the permutation to four states at once.  Each
+// lane starts at its own round, either 0 or 6.  Lanes that are marked
+// as idle are left unchanged.
+ASCON_AVX2_TARGET static void permute4_avx2
+    (uint64_t S[5][ASCON_LANES], const uint8_t first[ASCON_LANES])
+{
+    __m256i x0 = _mm256_loadu_si256((const __m256i *)(S[0]));
+    __m256i x1 = _mm256_loadu_si256((const __m256i *)(S[1]));
+    __m256i x2 = _mm256_loadu_si256((const __m256i *)(S[2]));
+    __m256i x3 = _mm256_loadu_si256((const __m256i *)(S[3]));
+    __m256i x4 = _mm256_loadu_si256((const __m256i *)(S[4]));
+    __m256i ones = _mm256_set1_epi64x(-1);
+    __m256i t0, t1, t2, t3, t4;
+    __m256i m, rc, step;
+    uint64_t mask[ASCON_LANES];
+    uint8_t lane, round;
+
+    // Round constants for the lanes' starting rounds.  Each round's
+    // constant is 15 less than the one before.  Idle lanes get zero.
+    for (lane = 0; lane < ASCON_LANES; ++lane)
+        mask[lane] = (first[lane] == ASCON_LANE_IDLE) ? 0 : ~((uint64_t)0);
+    m = _mm256_loadu_si256((const __m256i *)mask);
+    rc = _mm256_and_si256(m, _mm256_set_epi64x
+        (((0x0F - first[3]) << 4) | first[3],
+         ((0x0F - first[2]) << 4) | first[2],
+         ((0x0F - first[1]) << 4) | first[1],
+         ((0x0F - first[0]) << 4) | first[0]));
+    step = _mm256_and_si256(m, _mm256_set1_epi64x(15));
+
+    for (round = 0; round < 6; ++round) {
+        // Add the round constants to the state.
+        x2 = _mm256_xor_si256(x2, rc);
+        rc = _mm256_sub_epi64(rc, step);
+
+        // Substitution layer.
+        x0 = _mm256_xor_si256(x0, x4);
+        x4 = _mm256_xor_si256(x4, x3);
+        x2 = _mm256_xor_si256(x2, x1);
+        t0 = _mm256_andnot_si256(x0, x1);
+        t1 = _mm256_andnot_si256(x1, x2);
+        t2 = _mm256_andnot_si256(x2, x3);
+        t3 = _mm256_andnot_si256(x3, x4);
+        t4 = _mm256_andnot_si256(x4, x0);
+        x0 = _mm256_xor_si256(x0, t1);
+        x1 = _mm256_xor_si256(x1, t2);
+        x2 = _mm256_xor_si256(x2, t3);
+        x3 = _mm256_xor_si256(x3, t4);
+        x4 = _mm256_xor_si256(x4, t0);
+        x1 = _mm256_xor_si256(x1, x0);
+        x0 = _mm256_xor_si256(x0, x4);
+        x3 = _mm256_xor_si256(x3, x2);
+        x2 = _mm256_xor_si256(x2, ones);
+
+        // Linear diffusion layer.
+        x0 = _mm256_xor_si256(x0, _mm256_xor_si256
+            (ror64_avx2(x0, 19), ror64_avx2(x0, 28)));
+        x1 = _mm256_xor_si256(x1, _mm256_xor_si256
+            (ror64_avx2(x1, 61), ror64_avx2(x1, 39)));
+        x2 = _mm256_xor_si256(x2, _mm256_xor_si256
+            (ror64_avx2(x2, 1), ror64_avx2(x2, 6)));
+        x3 = _mm256_xor_si256(x3, _mm256_xor_si256
+            (ror64_avx2(x3, 10), ror64_avx2(x3, 17)));
+        x4 = _mm256_xor_si256(x4, _mm256_xor_si256
+            (ror64_avx2(x4, 7), ror64_avx2(x4, 41)));
+    }
+
+    // Write the active lanes back to the state.
+    #define ascon_store_avx2(index, x) \
+        _mm256_storeu_si256((__m256i *)(S[(index)]), _mm256_blendv_epi8 \
+            (_mm256_loadu_si256((const __m256i *)(S[(index)])), (x), m))
+    ascon_store_avx2(0, x0);
+    ascon_store_avx2(1, x1);
+    ascon_store_avx2(2, x2);
+    ascon_store_avx2(3, x3);
+    ascon_store_avx2(4, x4);
+    #undef ascon_store_avx2
+}
+
+// Per-lane state while processing a frame.
+struct AsconLane
+{
+    Ascon128Batch::Frame *frame;
+    uint64_t K[2];
+    size_t posn;
+    uint8_t phase;
+};
+
+// Loads a big-endian word from a buffer.
+static inline uint64_t ascon_load(const uint8_t *data)
+{
+    uint64_t word;
+    memcpy(&word, data, 8);
+    return be64toh(word);
+}
+
+// Stores a big-endian word to a buffer.
+static inline void ascon_store(uint8_t *data, uint64_t word)
+{
+    word = htobe64(word);
+    memcpy(data, &word, 8);
+}
+
+// Loads a partial big-endian word of less than 8 bytes, padded with zeroes.
+static uint64_t ascon_load_partial(const uint8_t *data, size_t len)
+{
+    uint64_t word = 0;
+    for (uint8_t posn = 0; posn < len; ++posn)
+        word |= ((uint64_t)(data[posn])) << (56 - posn * 8);
+    return word;
+}
+
+// Stores the top bytes of a big-endian word to a buffer.
+static void ascon_store_partial(uint8_t *data, uint64_t word, size_t len)
+{
+    for (uint8_t posn = 0; posn < len; ++posn)
+        data[posn] = (uint8_t)(word >> (56 - posn * 8));
+}
+
+// Padding for a partial block of "len" bytes.
+#define ascon_pad(len)  (((uint64_t)0x80) << (56 - (len) * 8))
+
+// Moves a lane on through its frames until it next needs the permutation.
+// Returns the round to start the permutation at, or ASCON_LANE_IDLE if
+// there are no more frames for the lane to process.
+static uint8_t advanceLane(AsconLane &lane, uint64_t S[5][ASCON_LANES],
+                           uint8_t index, Ascon128Batch::Frame *&next,
+                           Ascon128Batch::Frame *end, bool decrypt)
+{
+    Ascon128Batch::Frame *f = lane.frame;
+    uint64_t T[2];
+    uint64_t c;
+    size_t remain;
+    for (;;) {
+        switch (lane.phase) {
+        case ASCON_LANE_START:
+            // Start the next frame, if there is one.
+            if (next == end)
+                return ASCON_LANE_IDLE;
+            f = lane.frame = next++;
+            lane.K[0] = ascon_load(f->key);
+            lane.K[1] = ascon_load(f->key + 8);
+            S[0][index] = ASCON128_IV;
+            S[1][index] = lane.K[0];
+            S[2][index] = lane.K[1];
+            S[3][index] = ascon_load(f->nonce);
+            S[4][index] = ascon_load(f->nonce + 8);
+            lane.phase = ASCON_LANE_INIT;
+            return 0;
+
+        case ASCON_LANE_INIT:
+            // Second half of the initial permutation.
+            lane.phase = ASCON_LANE_KEY;
+            return 6;
+
+        case ASCON_LANE_KEY:
+            // XOR the end of the state with the original key.
+            S[3][index] ^= lane.K[0];
+            S[4][index] ^= lane.K[1];
+            lane.posn = 0;
+            lane.phase = ASCON_LANE_AD;
+            break;
+
+        case ASCON_LANE_AD:
+            // Absorb the next block of associated data.
+            remain = f->adLen - lane.posn;
+            if (remain >= 8) {
+                S[0][index] ^= ascon_load(f->ad + lane.posn);
+                lane.posn += 8;
+                return 6;
+            }
+            lane.phase = ASCON_LANE_SEP;
+            if (f->adLen > 0) {
+                S[0][index] ^= ascon_load_partial(f->ad + lane.posn, remain) ^
+                               ascon_pad(remain);
+                return 6;
+            }
+            break;
+
+        case ASCON_LANE_SEP:
+            // Domain separation between auth data and payload data.
+            S[4][index] ^= 1;
+            lane.posn = 0;
+            lane.phase = ASCON_LANE_MSG;
+            break;
+
+        case ASCON_LANE_MSG:
+            // Encrypt or decrypt the next block of the payload.
+            remain = f->len - lane.posn;
+            if (remain >= 8) {
+                c = ascon_load(f->input + lane.posn);
+                if (decrypt) {
+                    ascon_store(f->output + lane.posn, S[0][index] ^ c);
+                    S[0][index] = c;
+                } else {
+                    S[0][index] ^= c;
+                    ascon_store(f->output + lane.posn, S[0][index]);
+                }
+                lane.posn += 8;
+                return 6;
+            }
+            c = ascon_load_partial(f->input + lane.posn, remain);
+            if (decrypt) {
+                ascon_store_partial
+                    (f->output + lane.posn, S[0][index] ^ c, remain);
+                if (remain > 0)
+                    S[0][index] &= ~((uint64_t)0) >> (remain * 8);
+                S[0][index] |= c;
+            } else {
+                S[0][index] ^= c;
+                ascon_store_partial
+                    (f->output + lane.posn, S[0][index], remain);
+            }
+            S[0][index] ^= ascon_pad(remain);
+
+            // Add the original key and start the final permutation.
+            S[1][index] ^= lane.K[0];
+            S[2][index] ^= lane.K[1];
+            lane.phase = ASCON_LANE_FINAL;
+            return 0;
+
+        case ASCON_LANE_FINAL:
+            // Second half of the final permutation.
+            lane.phase = ASCON_LANE_TAG;
+            return 6;
+
+        case ASCON_LANE_TAG:
+            // Compute the tag and then generate or check it.
+            T[0] = htobe64(S[3][index] ^ lane.K[0]);
+            T[1] = htobe64(S[4][index] ^ lane.K[1]);
+            if (decrypt) {
+                f->valid = secure_compare(T, f->tag, 16);
+                if (!f->valid)
+                    memset(f->output, 0, f->len);
+            } else {
+                memcpy(f->tag, T, 16);
+                f->valid = true;
+            }
+            clean(T);
+            lane.phase = ASCON_LANE_START;
+            break;
+        }
+    }
+}
+
+// Processes a batch of frames four at a time with the lane scheduler.
+static void processLanes(Ascon128Batch::Frame *frames, size_t count,
+                         bool decrypt)
+{
+    uint64_t S[5][ASCON_LANES];
+    AsconLane lanes[ASCON_LANES];
+    uint8_t first[ASCON_LANES];
+    Ascon128Batch::Frame *next = frames;
+    Ascon128Batch::Frame *end = frames + count;
+    uint8_t index;
+    bool active;
+
+    memset(S, 0, sizeof(S));
+    memset(lanes, 0, sizeof(lanes));
+    for (;;) {
+        active = false;
+        for (index = 0; index < ASCON_LANES; ++index) {
+            first[index] = advanceLane
+                (lanes[index], S, index, next, end, decrypt);
+            if (first[index] != ASCON_LANE_IDLE)
+                active = true;
+        }
+        if (!active)
+            break;
+        permute4_avx2(S, first);
+    }
+    clean(S);
+    clean(lanes);
+}
+
+#endif // ASCON_AVX2
+
+// Processes a single frame with Ascon128.
+static void processFrame(Ascon128Batch::Frame &f, bool decrypt)
+{
+    Ascon128 cipher;
+    cipher.setKey(f.key, 16);
+    cipher.setIV(f.nonce, 16);
+    cipher.addAuthData(f.ad, f.adLen);
+    if (decrypt) {
+        cipher.decrypt(f.output, f.input, f.len);
+        f.valid = cipher.checkTag(f.tag, 16);
+        if (!f.valid)
+            memset(f.output, 0, f.len);
+    } else {
+        cipher.encrypt(f.output, f.input, f.len);
+        cipher.computeTag(f.tag, 16);
+        f.valid = true;
+    }
+}
+
+// Processes a batch of frames, in parallel if possible.
+static void processBatch(Ascon128Batch::Frame *frames, size_t count,
+                         bool decrypt)
+{
+#if ASCON_AVX2
+    if (count > 1 && __builtin_cpu_supports("avx2")) {
+        processLanes(frames, count, decrypt);
+        return;
+    }
+#endif
+    for (size_t index = 0; index < count; ++index)
+        processFrame(frames[index], decrypt);
+}
+
+/** @endcond */
+
+/**
+ * \brief Encrypts a batch of frames and computes their authentication tags.
+ *
+ * \param frames Points to the frames to encrypt.
+ * \param count Number of frames in the batch.
+ *
+ * The ciphertext for each frame is written to its \a output buffer and
+ * the 16-byte tag is written to its \a tag buffer.  The \a valid field
+ * of each frame is set to true.
+ *
+ * \sa open()
+ */
+void Ascon128Batch::seal(Frame *frames, size_t count)
+{
+    processBatch(frames, count, false);
+}
+
+/**
+ * \brief Decrypts a batch of frames and checks their authentication tags.
+ *
+ * \param frames Points to the frames to decrypt.
+ * \param count Number of frames in the batch.
+ *
+ * \return Returns true if all frames were authenticated, or false if at
+ * least one frame failed to authenticate.
+ *
+ * The \a valid field of each frame indicates whether its tag was correct.
+ * The \a output buffer of a frame that fails to authenticate is set to
+ * all-zeroes so that unauthenticated plaintext is not released.
+ *
+ * \sa seal()
+ */
+bool Ascon128Batch::open(Frame *frames, size_t count)
+{
+    bool ok = true;
+    processBatch(frames, count, true);
+    for (size_t index = 0; index < count; ++index) {
+        if (!frames[index].valid)
+            ok = false;
+    }
+    return ok;
+}
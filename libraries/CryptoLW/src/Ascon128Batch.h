@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2018 Southern Storm Software, Pty Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef CRYPTO_ASCON128BATCH_H
+#define CRYPTO_ASCON128BATCH_H
+
+#include <inttypes.h>
+#include <stddef.h>
+
+class Ascon128Batch
+{
+private:
+    Ascon128Batch() {}
+    ~Ascon128Batch() {}
+
+public:
+    struct Frame
+    {
+        const uint8_t *key;
+        const uint8_t *nonce;
+        const uint8_t *ad;
+        size_t adLen;
+        const uint8_t *input;
+        uint8_t *output;
+        size_t len;
+        uint8_t *tag;
+        bool valid;
+    };
+
+    static void seal(Frame *frames, size_t count);
+    static bool open(Frame *frames, size_t count);
+};
+
+#endif
@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2018 Southern Storm Software, Pty Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "AsconCore.h"
+#include "Ascon128.h"
+#include "Crypto.h"
+#include "utility/EndianUtil.h"
+#include "utility/ProgMemUtil.h"
+#include "utility/AsconUtil.h"
+#include <string.h>
+
+/**
+ * \class AsconCore AsconCore.h <AsconCore.h>
+ * \brief Sponge function for the ASCON hash and XOF algorithms.
+ *
+ * This class provides the common sponge construction for AsconHash and
+ * AsconXof, which absorb and squeeze 8 bytes at a time with the 12-round
+ * permutation from Ascon128::permute().  Applications should normally use
+ * one of those classes instead of this one.
+ *
+ * \sa AsconHash, AsconXof
+ */
+
+/**
+ * \brief Constructs a new ASCON sponge function.
+ *
+ * The state is undefined until reset() is called.
+ */
+AsconCore::AsconCore()
+    : inputSize(0)
+    , outputSize(0)
+{
+    memset(S, 0, sizeof(S));
+}
+
+/**
+ * \brief Destroys this ASCON sponge function after clearing all
+ * sensitive information.
+ */
+AsconCore::~AsconCore()
+{
+    clean(S);
+}
+
+/**
+ * \fn size_t AsconCore::blockSize() const
+ * \brief Returns the input block size for the sponge function in bytes.
+ */
+
+/**
+ * \brief Resets the sponge function to a pre-computed initial state.
+ *
+ * \param iv Points to the five words of the state after the initial
+ * permutation of the algorithm's IV, in program memory.
+ *
+ * Starting from a pre-computed state saves a 12-round permutation
+ * each time a new hash or XOF operation is started.
+ */
+void AsconCore::reset(const uint64_t *iv)
+{
+    memcpy_P(S, iv, sizeof(S));
+#if ASCON_INTERLEAVED
+    for (uint8_t index = 0; index < 5; ++index)
+        S[index] = ascon_to_state(S[index]);
+#endif
+    inputSize = 0;
+    outputSize = 0;
+}
+
+/**
+ * \brief Absorbs more input data into the sponge function.
+ *
+ * \param data The input data to be absorbed.
+ * \param len Length of the input data in bytes.
+ *
+ * \sa pad(), extract()
+ */
+void AsconCore::update(const void *data, size_t len)
+{
+    // Stop generating output while we incorporate the new data.
+    outputSize = 0;
+
+    const uint8_t *d = (const uint8_t *)data;
+    while (len > 0) {
+        if (inputSize == 0 && len >= 8) {
+            // Absorb an entire block at once.
+            uint64_t word;
+            memcpy(&word, d, 8);
+            S[0] ^= ascon_to_state(be64toh(word));
+            d += 8;
+            len -= 8;
+            Ascon128::permute(S, 0);
+            continue;
+        }
+        ascon_xor_byte(S, ASCON_BYTE(inputSize), *d++);
+        --len;
+        if ((++inputSize) == 8) {
+            Ascon128::permute(S, 0);
+            inputSize = 0;
+        }
+    }
+}
+
+/**
+ * \brief Pads the last block of input data and permutes the state
+ * ready to generate output.
+ *
+ * \sa update(), extract()
+ */
+void AsconCore::pad()
+{
+    ascon_xor_byte(S, ASCON_BYTE(inputSize), 0x80);
+    Ascon128::permute(S, 0);
+    inputSize = 0;
+    outputSize = 0;
+}
+
+/**
+ * \brief Extracts data from the sponge function.
+ *
+ * \param data The data buffer to fill with extracted data.
+ * \param len The number of bytes of extracted data that are required.
+ *
+ * \sa pad(), encrypt()
+ */
+void AsconCore::extract(void *data, size_t len)
+{
+    uint8_t *d = (uint8_t *)data;
+    while (len > 0) {
+        // Generate another output block if the current one has been exhausted.
+        if (outputSize >= 8) {
+            Ascon128::permute(S, 0);
+            outputSize = 0;
+        }
+        if (outputSize == 0 && len >= 8) {
+            // Extract an entire block at once.
+            uint64_t word = htobe64(ascon_from_state(S[0]));
+            memcpy(d, &word, 8);
+            d += 8;
+            len -= 8;
+            outputSize = 8;
+            continue;
+        }
+        *d++ = ascon_get_byte(S, ASCON_BYTE(outputSize));
+        ++outputSize;
+        --len;
+    }
+}
+
+/**
+ * \brief Extracts data from the sponge function and uses it to
+ * encrypt a buffer.
+ *
+ * \param output The output buffer to write to, which may be the same
+ * buffer as \a input.
+ * \param input The input buffer to read from.
+ * \param len The number of bytes to encrypt.
+ *
+ * \sa extract()
+ */
+void AsconCore::encrypt(void *output, const void *input, size_t len)
+{
+    uint8_t *out = (uint8_t *)output;
+    const uint8_t *in = (const uint8_t *)input;
+    while (len > 0) {
+        if (outputSize >= 8) {
+            Ascon128::permute(S, 0);
+            outputSize = 0;
+        }
+        *out++ = *in++ ^ ascon_get_byte(S, ASCON_BYTE(outputSize));
+        ++outputSize;
+        --len;
+    }
+}
+
+/**
+ * \brief Clears all sensitive data from this object.
+ */
+void AsconCore::clear()
+{
+    clean(S);
+    inputSize = 0;
+    outputSize = 0;
+}
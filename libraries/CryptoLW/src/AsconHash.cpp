@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2018 Southern Storm Software, Pty Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "AsconHash.h"
+#include "Crypto.h"
+#include "utility/ProgMemUtil.h"
+#include <string.h>
+
+/**
+ * \class AsconHash AsconHash.h <AsconHash.h>
+ * \brief ASCON-HASH hash algorithm.
+ *
+ * AsconHash produces a 256-bit hash value using the same permutation
+ * as the Ascon128 authenticated cipher.  Applications that already use
+ * Ascon128 can add hashing without needing the code space for a second
+ * primitive such as SHA256 or BLAKE2s.
+ *
+ * HMAC mode is supported with a 32-byte key block, for compatibility
+ * with code that expects a Hash object.  New designs should use AsconMAC
+ * instead, which is keyed directly and is much faster.
+ *
+ * References: http://competitions.cr.yp.to/round3/asconv12.pdf,
+ * http://ascon.iaik.tugraz.at/
+ *
+ * \sa AsconXof, AsconMAC, Ascon128
+ */
+
+/** @cond */
+
+// Size of the key block for HMAC mode.
+#define ASCON_HMAC_BLOCK_SIZE 32
+
+// State after permuting the ASCON-HASH IV 0x00400C0000000100.
+static uint64_t const asconHashIV[5] PROGMEM = {
+    0xEE9398AADB67F03DULL, 0x8BB21831C60F1002ULL, 0xB48A92DB98D5DA62ULL,
+    0x43189921B8F8E3E8ULL, 0x348FA5C9D525E140ULL
+};
+
+/** @endcond */
+
+/**
+ * \brief Constructs a new ASCON-HASH object.
+ */
+AsconHash::AsconHash()
+{
+    core.reset(asconHashIV);
+}
+
+/**
+ * \brief Destroys this ASCON-HASH object after clearing
+ * sensitive information.
+ */
+AsconHash::~AsconHash()
+{
+    // The destructor for the AsconCore object will do most of the work.
+}
+
+size_t AsconHash::hashSize() const
+{
+    return 32;
+}
+
+size_t AsconHash::blockSize() const
+{
+    return core.blockSize();
+}
+
+void AsconHash::reset()
+{
+    core.reset(asconHashIV);
+}
+
+void AsconHash::update(const void *data, size_t len)
+{
+    core.update(data, len);
+}
+
+void AsconHash::finalize(void *hash, size_t len)
+{
+    // Pad the final block and then extract the hash value.
+    if (len > 32)
+        len = 32;
+    core.pad();
+    core.extract(hash, len);
+}
+
+void AsconHash::clear()
+{
+    core.clear();
+    reset();
+}
+
+void AsconHash::resetHMAC(const void *key, size_t keyLen)
+{
+    setHMACKey(key, keyLen, 0x36);
+}
+
+void AsconHash::finalizeHMAC(const void *key, size_t keyLen, void *hash, size_t hashLen)
+{
+    uint8_t temp[32];
+    finalize(temp, sizeof(temp));
+    setHMACKey(key, keyLen, 0x5C);
+    update(temp, sizeof(temp));
+    finalize(hash, hashLen);
+    clean(temp);
+}
+
+/**
+ * \brief Resets the hash and absorbs a padded HMAC key.
+ *
+ * \param key Points to the HMAC key.
+ * \param len Length of the HMAC \a key in bytes.
+ * \param pad Inner (0x36) or outer (0x5C) padding value.
+ */
+void AsconHash::setHMACKey(const void *key, size_t len, uint8_t pad)
+{
+    uint8_t block[ASCON_HMAC_BLOCK_SIZE];
+    reset();
+    if (len <= ASCON_HMAC_BLOCK_SIZE) {
+        memcpy(block, key, len);
+    } else {
+        update(key, len);
+        finalize(block, 32);
+        reset();
+        len = 32;
+    }
+    memset(block + len, 0, sizeof(block) - len);
+    for (uint8_t posn = 0; posn < sizeof(block); ++posn)
+        block[posn] ^= pad;
+    update(block, sizeof(block));
+    clean(block);
+}
@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2018 Southern Storm Software, Pty Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "AsconMAC.h"
+#include "Ascon128.h"
+#include "Crypto.h"
+#include "utility/EndianUtil.h"
+#include "utility/AsconUtil.h"
+#include <string.h>
+
+/**
+ * \class AsconMAC AsconMAC.h <AsconMAC.h>
+ * \brief ASCON-MAC message authenticator and ASCON-PRF pseudorandom function.
+ *
+ * AsconMAC computes a 128-bit authentication token over a message
+ * using a 128-bit key and the same permutation as the Ascon128
+ * authenticated cipher.  Unlike HMAC, the key is loaded directly into
+ * the permutation state and the input is absorbed 32 bytes at a time,
+ * so it needs far fewer permutation calls than AsconHash in HMAC mode.
+ *
+ * \code
+ * AsconMAC mac;
+ * uint8_t token[16];
+ * mac.reset(key);
+ * mac.update(data, len);
+ * mac.finalize(token, sizeof(token));
+ * \endcode
+ *
+ * Calling resetPRF() instead of reset() selects the ASCON-PRF variant,
+ * which can produce an arbitrary amount of output from finalize().
+ *
+ * References: https://eprint.iacr.org/2021/1574,
+ * http://ascon.iaik.tugraz.at/
+ *
+ * \sa AsconHash, AsconXof, Ascon128
+ */
+
+/** @cond */
+
+// Initialization vectors for ASCON-MAC and ASCON-PRF.
+#define ASCON_MAC_IV    0x80808C0000000080ULL
+#define ASCON_PRF_IV    0x80808C0000000000ULL
+
+// Number of bytes that are absorbed and squeezed per permutation.
+#define ASCON_MAC_IN_RATE   32
+#define ASCON_MAC_OUT_RATE  16
+
+/** @endcond */
+
+/**
+ * \brief Constructs a new ASCON-MAC object.
+ *
+ * \sa reset()
+ */
+AsconMAC::AsconMAC()
+    : posn(0)
+    , prf(false)
+{
+    memset(S, 0, sizeof(S));
+}
+
+/**
+ * \brief Destroys this ASCON-MAC object after clearing all sensitive
+ * information.
+ */
+AsconMAC::~AsconMAC()
+{
+    clean(S);
+}
+
+/**
+ * \brief Resets the ASCON-MAC authenticator for a new session.
+ *
+ * \param key Points to the 16-byte authentication key.
+ *
+ * \sa resetPRF(), update(), finalize()
+ */
+void AsconMAC::reset(const void *key)
+{
+    init(ASCON_MAC_IV, key);
+    prf = false;
+}
+
+/**
+ * \brief Resets the object to compute ASCON-PRF for a new session.
+ *
+ * \param key Points to the 16-byte key.
+ *
+ * \sa reset(), update(), finalize()
+ */
+void AsconMAC::resetPRF(const void *key)
+{
+    init(ASCON_PRF_IV, key);
+    prf = true;
+}
+
+/**
+ * \brief Updates the authenticator with more data.
+ *
+ * \param data Data to be absorbed.
+ * \param len Number of bytes of data to be absorbed.
+ *
+ * \sa reset(), finalize()
+ */
+void AsconMAC::update(const void *data, size_t len)
+{
+    const uint8_t *d = (const uint8_t *)data;
+    while (len > 0) {
+        if (posn == 0 && len >= ASCON_MAC_IN_RATE) {
+            // Absorb an entire block at once into the first four words.
+            uint64_t word[4];
+            memcpy(word, d, ASCON_MAC_IN_RATE);
+            S[0] ^= ascon_to_state(be64toh(word[0]));
+            S[1] ^= ascon_to_state(be64toh(word[1]));
+            S[2] ^= ascon_to_state(be64toh(word[2]));
+            S[3] ^= ascon_to_state(be64toh(word[3]));
+            d += ASCON_MAC_IN_RATE;
+            len -= ASCON_MAC_IN_RATE;
+            Ascon128::permute(S, 0);
+            continue;
+        }
+        ascon_xor_byte(S, ASCON_BYTE(posn), *d++);
+        --len;
+        if ((++posn) == ASCON_MAC_IN_RATE) {
+            Ascon128::permute(S, 0);
+            posn = 0;
+        }
+    }
+}
+
+/**
+ * \brief Finalizes the authentication process and returns the token.
+ *
+ * \param token The buffer to return the token value in.
+ * \param len The length of the \a token buffer in bytes.
+ *
+ * For ASCON-MAC, the token is 16 bytes in size and \a len is truncated
+ * to that size if necessary.  For ASCON-PRF, \a len can be any length.
+ *
+ * The object must be reset again before it can be used for another session.
+ *
+ * \sa reset(), update()
+ */
+void AsconMAC::finalize(void *token, size_t len)
+{
+    // Pad the last block and add the domain separator.
+    ascon_xor_byte(S, ASCON_BYTE(posn), 0x80);
+    S[4] ^= 1;
+    posn = 0;
+    if (!prf && len > ASCON_MAC_OUT_RATE)
+        len = ASCON_MAC_OUT_RATE;
+
+    // Squeeze the output from the first two words of the state.
+    uint8_t *t = (uint8_t *)token;
+    uint64_t word[2];
+    while (len > 0) {
+        Ascon128::permute(S, 0);
+        word[0] = htobe64(ascon_from_state(S[0]));
+        word[1] = htobe64(ascon_from_state(S[1]));
+        size_t size = len;
+        if (size > ASCON_MAC_OUT_RATE)
+            size = ASCON_MAC_OUT_RATE;
+        memcpy(t, word, size);
+        t += size;
+        len -= size;
+    }
+    clean(word);
+}
+
+/**
+ * \brief Clears the authenticator's state, removing all sensitive data.
+ */
+void AsconMAC::clear()
+{
+    clean(S);
+    posn = 0;
+    prf = false;
+}
+
+/**
+ * \brief Initializes the state with a key.
+ *
+ * \param iv The initialization vector for the algorithm variant.
+ * \param key Points to the 16-byte key.
+ */
+void AsconMAC::init(uint64_t iv, const void *key)
+{
+    memcpy(S + 1, key, 16);
+    S[0] = ascon_to_state(iv);
+    S[1] = ascon_to_state(be64toh(S[1]));
+    S[2] = ascon_to_state(be64toh(S[2]));
+    S[3] = 0;
+    S[4] = 0;
+    posn = 0;
+    Ascon128::permute(S, 0);
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2018 Southern Storm Software, Pty Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "AsconXof.h"
+#include "utility/ProgMemUtil.h"
+
+/**
+ * \class AsconXof AsconXof.h <AsconXof.h>
+ * \brief ASCON-XOF Extendable-Output Function (XOF).
+ *
+ * AsconXof is the extendable-output member of the ASCON hash family.
+ * It uses the same permutation as the Ascon128 authenticated cipher
+ * and can produce an arbitrary amount of output.
+ *
+ * References: http://competitions.cr.yp.to/round3/asconv12.pdf,
+ * http://ascon.iaik.tugraz.at/
+ *
+ * \sa AsconHash, AsconMAC, Ascon128
+ */
+
+/** @cond */
+
+// State after permuting the ASCON-XOF IV 0x00400C0000000000.
+static uint64_t const asconXofIV[5] PROGMEM = {
+    0xB57E273B814CD416ULL, 0x2B51042562AE2420ULL, 0x66A3A7768DDF2218ULL,
+    0x5AAD0A7A8153650CULL, 0x4F3E0E32539493B6ULL
+};
+
+/** @endcond */
+
+/**
+ * \brief Constructs a new ASCON-XOF object.
+ */
+AsconXof::AsconXof()
+    : finalized(false)
+{
+    core.reset(asconXofIV);
+}
+
+/**
+ * \brief Destroys this ASCON-XOF object after clearing all sensitive
+ * information.
+ */
+AsconXof::~AsconXof()
+{
+}
+
+size_t AsconXof::blockSize() const
+{
+    return core.blockSize();
+}
+
+void AsconXof::reset()
+{
+    core.reset(asconXofIV);
+    finalized = false;
+}
+
+void AsconXof::update(const void *data, size_t len)
+{
+    if (finalized)
+        reset();
+    core.update(data, len);
+}
+
+void AsconXof::extend(uint8_t *data, size_t len)
+{
+    if (!finalized) {
+        core.pad();
+        finalized = true;
+    }
+    core.extract(data, len);
+}
+
+void AsconXof::encrypt(uint8_t *output, const uint8_t *input, size_t len)
+{
+    if (!finalized) {
+        core.pad();
+        finalized = true;
+    }
+    core.encrypt(output, input, len);
+}
+
+void AsconXof::clear()
+{
+    core.clear();
+    reset();
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2018 Southern Storm Software, Pty Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "Speck64.h"
+#include "Crypto.h"
+#include "utility/RotateUtil.h"
+#include "utility/EndianUtil.h"
+#include <string.h>
+
+/**
+ * \class Speck64 Speck64.h <Speck64.h>
+ * \brief Speck block cipher with a 64-bit block size.
+ *
+ * This class implements the Speck64/96 and Speck64/128 members of the
+ * Speck family, which operate on 32-bit words instead of the 64-bit
+ * words used by the Speck class.  On 32-bit microcontrollers without
+ * native 64-bit arithmetic, such as ARM Cortex-M0 and ESP8266, this is
+ * considerably faster than Speck.
+ *
+ * Speck64 has the same API as the other block ciphers in the library
+ * and can be used with CTR and EAX mode; e.g. CTR<Speck64> or
+ * EAX<Speck64>.  The IV for CTR mode and the tag for EAX mode are
+ * 8 bytes in size because of the smaller block size.
+ *
+ * \note A 64-bit block size means that the security of CTR and EAX mode
+ * starts to degrade after 2^32 blocks (32 gigabytes) have been processed
+ * with a single key.  The application should change the key well before
+ * that point.
+ *
+ * The Speck64Tiny class provides an alternative implementation that
+ * has reduced RAM requirements at the cost of some features and
+ * performance.
+ *
+ * References: https://en.wikipedia.org/wiki/Speck_%28cipher%29,
+ * http://eprint.iacr.org/2013/404
+ *
+ * \sa Speck64Tiny, Speck
+ */
+
+/**
+ * \brief Constructs a Speck64 block cipher with no initial key.
+ *
+ * This constructor must be followed by a call to setKey() before the
+ * block cipher can be used for encryption or decryption.
+ */
+Speck64::Speck64()
+    : rounds(27)
+{
+}
+
+Speck64::~Speck64()
+{
+    clean(k);
+}
+
+size_t Speck64::blockSize() const
+{
+    return 8;
+}
+
+size_t Speck64::keySize() const
+{
+    // Also supports 96-bit, but we only report 128-bit.
+    return 16;
+}
+
+// Pack/unpack byte-aligned big-endian 32-bit quantities.
+#define pack32(data, value) \
+    do { \
+        uint32_t v = htobe32((value)); \
+        memcpy((data), &v, sizeof(uint32_t)); \
+    } while (0)
+#define unpack32(value, data) \
+    do { \
+        memcpy(&(value), (data), sizeof(uint32_t)); \
+        (value) = be32toh((value)); \
+    } while (0)
+
+bool Speck64::setKey(const uint8_t *key, size_t len)
+{
+    uint32_t l[4];
+    uint8_t m;
+    if (len == 16) {
+        m = 4;
+        unpack32(l[2], key);
+        unpack32(l[1], key + 4);
+        unpack32(l[0], key + 8);
+        unpack32(k[0], key + 12);
+    } else if (len == 12) {
+        m = 3;
+        unpack32(l[1], key);
+        unpack32(l[0], key + 4);
+        unpack32(k[0], key + 8);
+    } else {
+        return false;
+    }
+    rounds = 23 + m;
+    uint8_t li_in = 0;
+    uint8_t li_out = m - 1;
+    for (uint8_t i = 0; i < (rounds - 1); ++i) {
+        l[li_out] = (k[i] + rightRotate8(l[li_in])) ^ i;
+        k[i + 1] = leftRotate3(k[i]) ^ l[li_out];
+        if ((++li_in) >= m)
+            li_in = 0;
+        if ((++li_out) >= m)
+            li_out = 0;
+    }
+    clean(l);
+    return true;
+}
+
+void Speck64::encryptBlock(uint8_t *output, const uint8_t *input)
+{
+    uint32_t x, y;
+    const uint32_t *s = k;
+    unpack32(x, input);
+    unpack32(y, input + 4);
+    for (uint8_t round = rounds; round > 0; --round, ++s) {
+        x = (rightRotate8(x) + y) ^ s[0];
+        y = leftRotate3(y) ^ x;
+    }
+    pack32(output, x);
+    pack32(output + 4, y);
+}
+
+void Speck64::decryptBlock(uint8_t *output, const uint8_t *input)
+{
+    uint32_t x, y;
+    const uint32_t *s = k + rounds - 1;
+    unpack32(x, input);
+    unpack32(y, input + 4);
+    for (uint8_t round = rounds; round > 0; --round, --s) {
+        y = rightRotate3(x ^ y);
+        x = leftRotate8((x ^ s[0]) - y);
+    }
+    pack32(output, x);
+    pack32(output + 4, y);
+}
+
+void Speck64::clear()
+{
+    clean(k);
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2018 Southern Storm Software, Pty Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "Speck64Tiny.h"
+#include "Crypto.h"
+#include "utility/RotateUtil.h"
+#include "utility/EndianUtil.h"
+#include <string.h>
+
+/**
+ * \class Speck64Tiny Speck64Tiny.h <Speck64Tiny.h>
+ * \brief Speck block cipher with a 64-bit block size (tiny-memory version).
+ *
+ * This class differs from the Speck64 class in the following ways:
+ *
+ * \li RAM requirements are reduced.  The key (up to 128 bits) is
+ * stored directly and then expanded to the full key schedule round by round.
+ * The setKey() method is very fast because of this.
+ * \li Performance of encryptBlock() is slower than for Speck64 due to
+ * expanding the key on the fly rather than ahead of time.
+ * \li The decryptBlock() function is not supported, which means that CBC
+ * mode cannot be used but the CTR, CFB, OFB, and EAX modes can be used.
+ *
+ * See the documentation for the Speck64 class for more information on
+ * the 64-bit block size variants of Speck.
+ *
+ * References: https://en.wikipedia.org/wiki/Speck_%28cipher%29,
+ * http://eprint.iacr.org/2013/404
+ *
+ * \sa Speck64, SpeckTiny
+ */
+
+/**
+ * \brief Constructs a tiny-memory Speck64 block cipher with no initial key.
+ *
+ * This constructor must be followed by a call to setKey() before the
+ * block cipher can be used for encryption.
+ */
+Speck64Tiny::Speck64Tiny()
+    : rounds(27)
+{
+}
+
+Speck64Tiny::~Speck64Tiny()
+{
+    clean(k);
+}
+
+size_t Speck64Tiny::blockSize() const
+{
+    return 8;
+}
+
+size_t Speck64Tiny::keySize() const
+{
+    // Also supports 96-bit, but we only report 128-bit.
+    return 16;
+}
+
+// Pack/unpack byte-aligned big-endian 32-bit quantities.
+#define pack32(data, value) \
+    do { \
+        uint32_t v = htobe32((value)); \
+        memcpy((data), &v, sizeof(uint32_t)); \
+    } while (0)
+#define unpack32(value, data) \
+    do { \
+        memcpy(&(value), (data), sizeof(uint32_t)); \
+        (value) = be32toh((value)); \
+    } while (0)
+
+bool Speck64Tiny::setKey(const uint8_t *key, size_t len)
+{
+    if (len == 16) {
+        rounds = 27;
+        unpack32(k[3], key);
+        unpack32(k[2], key + 4);
+        unpack32(k[1], key + 8);
+        unpack32(k[0], key + 12);
+    } else if (len == 12) {
+        rounds = 26;
+        unpack32(k[2], key);
+        unpack32(k[1], key + 4);
+        unpack32(k[0], key + 8);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void Speck64Tiny::encryptBlock(uint8_t *output, const uint8_t *input)
+{
+    uint32_t l[4];
+    uint32_t x, y, s;
+    uint8_t round;
+    uint8_t li_in = 0;
+    uint8_t li_out = rounds - 24;
+    uint8_t i = 0;
+
+    // Copy the input block into the work registers.
+    unpack32(x, input);
+    unpack32(y, input + 4);
+
+    // Prepare the key schedule.
+    memcpy(l, k + 1, li_out * sizeof(uint32_t));
+    s = k[0];
+
+    // Perform all encryption rounds except the last.
+    for (round = rounds - 1; round > 0; --round, ++i) {
+        // Perform the round with the current key schedule word.
+        x = (rightRotate8(x) + y) ^ s;
+        y = leftRotate3(y) ^ x;
+
+        // Calculate the next key schedule word.
+        l[li_out] = (s + rightRotate8(l[li_in])) ^ i;
+        s = leftRotate3(s) ^ l[li_out];
+        li_in = (li_in + 1) & 0x03;
+        li_out = (li_out + 1) & 0x03;
+    }
+
+    // Perform the final round and copy to the output.
+    x = (rightRotate8(x) + y) ^ s;
+    y = leftRotate3(y) ^ x;
+    pack32(output, x);
+    pack32(output + 4, y);
+    clean(l);
+}
+
+void Speck64Tiny::decryptBlock(uint8_t *output, const uint8_t *input)
+{
+    // Decryption is not supported by Speck64Tiny.  Use Speck64 instead.
+}
+
+void Speck64Tiny::clear()
+{
+    clean(k);
+}
@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2018 Southern Storm Software, Pty Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "SpeckCTR.h"
+#include "Crypto.h"
+#include <string.h>
+
+/**
+ * \class SpeckCTR SpeckCTR.h <SpeckCTR.h>
+ * \brief Speck block cipher in CTR mode.
+ *
+ * SpeckCTR produces the same output as CTR<Speck> but it encrypts
+ * several counter blocks at a time with Speck::encryptBlocks().  On x86
+ * hosts this allows the SSE2 and AVX2 versions of Speck to process
+ * eight blocks of keystream in parallel.  On AVR platforms, only a
+ * single block of keystream is buffered to save memory.
+ *
+ * The number of blocks of keystream to buffer can be changed by
+ * defining SPECK_CTR_BLOCKS when compiling the library.
+ *
+ * Reference: http://en.wikipedia.org/wiki/Block_cipher_mode_of_operation
+ *
+ * \sa Speck, CTR
+ */
+
+/**
+ * \brief Constructs a new Speck cipher in CTR mode.
+ */
+SpeckCTR::SpeckCTR()
+    : posn(sizeof(state))
+    , counterStart(0)
+{
+}
+
+/**
+ * \brief Destroys this Speck cipher in CTR mode after clearing all
+ * sensitive information.
+ */
+SpeckCTR::~SpeckCTR()
+{
+    clean(counter);
+    clean(state);
+}
+
+size_t SpeckCTR::keySize() const
+{
+    return cipher.keySize();
+}
+
+size_t SpeckCTR::ivSize() const
+{
+    return 16;
+}
+
+/**
+ * \brief Sets the counter size for the IV.
+ *
+ * \param size The number of bytes on the end of the counter block
+ * that are relevant when incrementing, between 1 and 16.
+ * \return Returns false if the \a size value is not between 1 and 16.
+ *
+ * This has the same effect as CTRCommon::setCounterSize().
+ *
+ * \sa setIV()
+ */
+bool SpeckCTR::setCounterSize(size_t size)
+{
+    if (size < 1 || size > 16)
+        return false;
+    counterStart = 16 - size;
+    return true;
+}
+
+bool SpeckCTR::setKey(const uint8_t *key, size_t len)
+{
+    // Any buffered keystream is no longer valid.
+    posn = sizeof(state);
+    return cipher.setKey(key, len);
+}
+
+/**
+ * \brief Sets the initial counter value to use for future encryption and
+ * decryption operations.
+ *
+ * \param iv The initial counter value which must contain exactly 16 bytes.
+ * \param len The length of the counter value, which mut be 16.
+ * \return Returns false if \a len is not exactly 16.
+ *
+ * \sa encrypt(), setCounterSize()
+ */
+bool SpeckCTR::setIV(const uint8_t *iv, size_t len)
+{
+    if (len != 16)
+        return false;
+    memcpy(counter, iv, len);
+    posn = sizeof(state);
+    return true;
+}
+
+void SpeckCTR::encrypt(uint8_t *output, const uint8_t *input, size_t len)
+{
+    while (len > 0) {
+        if (posn >= sizeof(state))
+            refill();
+        size_t templen = sizeof(state) - posn;
+        if (templen > len)
+            templen = len;
+        len -= templen;
+        while (templen > 0) {
+            *output++ = *input++ ^ state[posn++];
+            --templen;
+        }
+    }
+}
+
+void SpeckCTR::decrypt(uint8_t *output, const uint8_t *input, size_t len)
+{
+    encrypt(output, input, len);
+}
+
+void SpeckCTR::clear()
+{
+    cipher.clear();
+    clean(counter);
+    clean(state);
+    posn = sizeof(state);
+}
+
+/**
+ * \brief Refills the keystream buffer with the next SPECK_CTR_BLOCKS
+ * encrypted counter blocks.
+ */
+void SpeckCTR::refill()
+{
+    // Lay out the consecutive counter values in the keystream buffer.
+    uint8_t *block = state;
+    for (size_t blk = 0; blk < SPECK_CTR_BLOCKS; ++blk, block += 16) {
+        memcpy(block, counter, 16);
+
+        // Increment the counter, taking care not to reveal
+        // any timing information about the starting value.
+        // We iterate through the entire counter region even
+        // if we could stop earlier because a byte is non-zero.
+        uint16_t temp = 1;
+        uint8_t index = 16;
+        while (index > counterStart) {
+            --index;
+            temp += counter[index];
+            counter[index] = (uint8_t)temp;
+            temp >>= 8;
+        }
+    }
+
+    // Encrypt all of the counter blocks at once.
+    cipher.encryptBlocks(state, state, SPECK_CTR_BLOCKS);
+    posn = 0;
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2018 Southern Storm Software, Pty Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef CRYPTO_ASCONUTIL_H
+#define CRYPTO_ASCONUTIL_H
+
+#include "utility/EndianUtil.h"
+#include <inttypes.h>
+
+// The Ascon classes keep the permutation state in the bit-interleaved
+// form on 32-bit platforms, where it turns each 64-bit rotation into two
+// native 32-bit rotations.  The even bits of each state word are stored
+// in the low half and the odd bits in the high half.  Conversion to and
+// from the regular form happens only when data is absorbed or squeezed.
+// Define ASCON_INTERLEAVED to 0 or 1 on the command-line to override.
+#if !defined(ASCON_INTERLEAVED)
+#if !defined(__AVR__) && defined(__SIZEOF_POINTER__) && \
+        __SIZEOF_POINTER__ == 4 && !defined(__x86_64__)
+#define ASCON_INTERLEAVED 1
+#else
+#define ASCON_INTERLEAVED 0
+#endif
+#endif
+#if defined(__AVR__)
+#undef ASCON_INTERLEAVED
+#define ASCON_INTERLEAVED 0
+#endif
+
+// Offset of byte "posn" of the rate within the state words.
+#if defined(CRYPTO_LITTLE_ENDIAN)
+#define ASCON_BYTE(posn)    ((posn) ^ 7)
+#else
+#define ASCON_BYTE(posn)    (posn)
+#endif
+
+#if ASCON_INTERLEAVED
+
+// Moves the even bits of a 32-bit word into the low half and the
+// odd bits into the high half.
+static inline uint32_t ascon_separate(uint32_t x)
+{
+    uint32_t t;
+    t = (x ^ (x >> 1)) & 0x22222222U; x ^= t ^ (t << 1);
+    t = (x ^ (x >> 2)) & 0x0C0C0C0CU; x ^= t ^ (t << 2);
+    t = (x ^ (x >> 4)) & 0x00F000F0U; x ^= t ^ (t << 4);
+    t = (x ^ (x >> 8)) & 0x0000FF00U; x ^= t ^ (t << 8);
+    return x;
+}
+
+// Inverse of ascon_separate().
+static inline uint32_t ascon_combine(uint32_t x)
+{
+    uint32_t t;
+    t = (x ^ (x >> 8)) & 0x0000FF00U; x ^= t ^ (t << 8);
+    t = (x ^ (x >> 4)) & 0x00F000F0U; x ^= t ^ (t << 4);
+    t = (x ^ (x >> 2)) & 0x0C0C0C0CU; x ^= t ^ (t << 2);
+    t = (x ^ (x >> 1)) & 0x22222222U; x ^= t ^ (t << 1);
+    return x;
+}
+
+// Converts a word from the regular form to the state form.
+static inline uint64_t ascon_to_state(uint64_t x)
+{
+    uint32_t lo = ascon_separate((uint32_t)x);
+    uint32_t hi = ascon_separate((uint32_t)(x >> 32));
+    return ((lo & 0x0000FFFFU) | (hi << 16)) |
+           (((uint64_t)((lo >> 16) | (hi & 0xFFFF0000U))) << 32);
+}
+
+// Converts a word from the state form to the regular form.
+static inline uint64_t ascon_from_state(uint64_t x)
+{
+    uint32_t e = (uint32_t)x;
+    uint32_t o = (uint32_t)(x >> 32);
+    uint32_t lo = ascon_combine((e & 0x0000FFFFU) | (o << 16));
+    uint32_t hi = ascon_combine((e >> 16) | (o & 0xFFFF0000U));
+    return (((uint64_t)hi) << 32) | lo;
+}
+
+// Shift for the nibbles that hold the bits of the byte at a memory
+// offset in the regular form of the state.
+#if defined(CRYPTO_LITTLE_ENDIAN)
+#define ASCON_NIBBLE(offset)    (((offset) & 7) * 4)
+#else
+#define ASCON_NIBBLE(offset)    ((7 - ((offset) & 7)) * 4)
+#endif
+
+// Gets the byte at a memory offset in the regular form of the state.
+static inline uint8_t ascon_get_byte(const uint64_t *S, uint8_t offset)
+{
+    uint64_t w = S[offset >> 3] >> ASCON_NIBBLE(offset);
+    uint8_t x = (uint8_t)((w & 0x0F) | ((w >> 28) & 0xF0));
+    uint8_t t;
+    t = (x ^ (x >> 2)) & 0x0C; x ^= t ^ (t << 2);
+    t = (x ^ (x >> 1)) & 0x22; x ^= t ^ (t << 1);
+    return x;
+}
+
+// XOR's a value with the byte at a memory offset in the regular form.
+static inline void ascon_xor_byte(uint64_t *S, uint8_t offset, uint8_t value)
+{
+    uint8_t x = value;
+    uint8_t t;
+    t = (x ^ (x >> 1)) & 0x22; x ^= t ^ (t << 1);
+    t = (x ^ (x >> 2)) & 0x0C; x ^= t ^ (t << 2);
+    S[offset >> 3] ^= ((uint64_t)((x & 0x0F) | (((uint64_t)(x >> 4)) << 32)))
+                            << ASCON_NIBBLE(offset);
+}
+
+// Sets the byte at a memory offset in the regular form of the state.
+static inline void ascon_set_byte(uint64_t *S, uint8_t offset, uint8_t value)
+{
+    ascon_xor_byte(S, offset, ascon_get_byte(S, offset) ^ value);
+}
+
+#else // !ASCON_INTERLEAVED
+
+#define ascon_to_state(x)   (x)
+#define ascon_from_state(x) (x)
+
+static inline uint8_t ascon_get_byte(const uint64_t *S, uint8_t offset)
+{
+    return ((const uint8_t *)S)[offset];
+}
+
+static inline void ascon_xor_byte(uint64_t *S, uint8_t offset, uint8_t value)
+{
+    ((uint8_t *)S)[offset] ^= value;
+}
+
+static inline void ascon_set_byte(uint64_t *S, uint8_t offset, uint8_t value)
+{
+    ((uint8_t *)S)[offset] = value;
+}
+
+#endif // !ASCON_INTERLEAVED
+
+#endif
@@ -0,0 +1,1064 @@
+/*
+ * Copyright (C) 2016 Southern Storm Software, Pty Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "MLKEM.h"
+#include <Crypto.h>
+#include <SHA3.h>
+#include <SHAKE.h>
+#include <RNG.h>
+#include <string.h>
+
+/** @cond */
+
+#if defined(ESP8266)
+#include <pgmspace.h>
+#define table_read(name, index) ((int16_t)pgm_read_word(&((name)[(index)])))
+#elif defined(__AVR__)
+#include <avr/pgmspace.h>
+#define table_read(name, index) ((int16_t)pgm_read_word(&((name)[(index)])))
+#else
+#define PROGMEM
+#define table_read(name, index) ((name)[(index)])
+#endif
+
+// Use AVX2 for the polynomial arithmetic on x86 hosts when the CPU
+// supports it.  Define MLKEM_NO_AVX2 to always use the portable code.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && \
+        !defined(MLKEM_NO_AVX2)
+#include <immintrin.h>
+#define MLKEM_AVX2 1
+#else
+#define MLKEM_AVX2 0
+#endif
+
+#if defined(ESP8266)
+// Keep the intermediate state off the stack on ESP8266, for the same
+// reason as in the NewHope class.
+#define MLKEM_HEAP_STATE 1
+#else
+#define MLKEM_HEAP_STATE 0
+#endif
+
+/** @endcond */
+
+/**
+ * \class MLKEM MLKEM.h <MLKEM.h>
+ * \brief ML-KEM post-quantum key encapsulation mechanism (FIPS 203).
+ *
+ * ML-KEM, previously known as Kyber, is a key encapsulation mechanism
+ * based on module lattices which is believed to be resistant to quantum
+ * computers.  It produces a 32-byte (256-bit) shared secret with much
+ * smaller messages than NewHope.  This class supports the ML-KEM-512
+ * and ML-KEM-768 parameter sets:
+ *
+ * <table>
+ * <tr><td>Variant</td><td>Public Key</td><td>Private Key</td><td>Ciphertext</td></tr>
+ * <tr><td>MLKEM512</td><td>800</td><td>1632</td><td>768</td></tr>
+ * <tr><td>MLKEM768</td><td>1184</td><td>2400</td><td>1088</td></tr>
+ * </table>
+ *
+ * The receiving party, usually the server, generates a key pair and
+ * sends the public key to the other party:
+ *
+ * \code
+ * uint8_t pk[MLKEM768_PUBLICKEYBYTES];
+ * uint8_t sk[MLKEM768_PRIVATEKEYBYTES];
+ * MLKEM::keygen(pk, sk);
+ * \endcode
+ *
+ * The sending party encapsulates a new shared secret against the
+ * public key and sends the ciphertext back:
+ *
+ * \code
+ * uint8_t ciphertext[MLKEM768_CIPHERTEXTBYTES];
+ * uint8_t shared_secret[MLKEM_SHAREDBYTES];
+ * if (!MLKEM::encaps(shared_secret, ciphertext, pk)) {
+ *     // Public key is malformed.
+ * }
+ * \endcode
+ *
+ * The receiving party then recovers the same shared secret:
+ *
+ * \code
+ * uint8_t shared_secret[MLKEM_SHAREDBYTES];
+ * MLKEM::decaps(shared_secret, ciphertext, sk);
+ * \endcode
+ *
+ * If the ciphertext has been modified in transit, then decaps() will
+ * produce a pseudorandom shared secret that does not match the sender's,
+ * which will cause the session to fail at a higher protocol level.
+ *
+ * The polynomial arithmetic follows the same design as the NewHope class:
+ * Montgomery and Barrett reductions within an in-place NTT, with the
+ * public matrix expanded from SHAKE128 one polynomial at a time rather
+ * than being stored in full.  This keeps the working state to around
+ * 3K of memory for ML-KEM-768.  On x86 hosts with AVX2, vectorized
+ * versions of the NTT and pointwise multiplication are selected at runtime.
+ *
+ * \sa NewHope
+ */
+
+/**
+ * \def MLKEM512_PUBLICKEYBYTES
+ * \brief The number of bytes in an ML-KEM-512 public key.
+ */
+
+/**
+ * \def MLKEM512_PRIVATEKEYBYTES
+ * \brief The number of bytes in an ML-KEM-512 private key.
+ */
+
+/**
+ * \def MLKEM512_CIPHERTEXTBYTES
+ * \brief The number of bytes in an ML-KEM-512 ciphertext.
+ */
+
+/**
+ * \def MLKEM768_PUBLICKEYBYTES
+ * \brief The number of bytes in an ML-KEM-768 public key.
+ */
+
+/**
+ * \def MLKEM768_PRIVATEKEYBYTES
+ * \brief The number of bytes in an ML-KEM-768 private key.
+ */
+
+/**
+ * \def MLKEM768_CIPHERTEXTBYTES
+ * \brief The number of bytes in an ML-KEM-768 ciphertext.
+ */
+
+/**
+ * \def MLKEM_SHAREDBYTES
+ * \brief The number of bytes in the shared secret.
+ */
+
+/**
+ * \enum MLKEM::Variant
+ * \brief Describes the ML-KEM parameter set to use.
+ */
+
+/**
+ * \var MLKEM::MLKEM512
+ * \brief ML-KEM-512, with security roughly equivalent to AES-128.
+ */
+
+/**
+ * \var MLKEM::MLKEM768
+ * \brief ML-KEM-768, with security roughly equivalent to AES-192.
+ * This is the default.
+ */
+
+/** @cond */
+
+#define MLKEM_N         256
+#define MLKEM_Q         3329
+#define MLKEM_MAX_K     3
+#define MLKEM_POLYBYTES 384
+#define MLKEM_SYMBYTES  32
+
+// Sizes of the compressed "u" and "v" components of the ciphertext.
+// Both supported parameter sets use du = 10 and dv = 4.
+#define MLKEM_POLYCOMPRESSEDBYTES_U 320
+#define MLKEM_POLYCOMPRESSEDBYTES_V 128
+
+// q^-1 mod 2^16, and the Montgomery factors mont^2 mod q and mont^2 / 128.
+#define MLKEM_QINV      62209U
+#define MLKEM_MONT2     1353
+#define MLKEM_F         1441
+
+// Barrett reduction multiplier: round(2^26 / q).
+#define MLKEM_BARRETT_V 20159
+
+// Powers of the 256th root of unity 17 in bit-reversed order, multiplied
+// by the Montgomery factor 2^16 and centered around zero.
+static int16_t const zetas[128] PROGMEM = {
+    -1044,  -758,  -359, -1517,  1493,  1422,   287,   202,
+     -171,   622,  1577,   182,   962, -1202, -1474,  1468,
+      573, -1325,   264,   383,  -829,  1458, -1602,  -130,
+     -681,  1017,   732,   608, -1542,   411,  -205, -1571,
+     1223,   652,  -552,  1015, -1293,  1491,  -282, -1544,
+      516,    -8,  -320,  -666, -1618, -1162,   126,  1469,
+     -853,   -90,  -271,   830,   107, -1421,  -247,  -951,
+     -398,   961, -1508,  -725,   448, -1065,   677, -1275,
+    -1103,   430,   555,   843, -1251,   871,  1550,   105,
+      422,   587,   177,  -235,  -291,  -460,  1574,  1653,
+     -246,   778,  1159,  -147,  -777,  1483,  -602,  1119,
+    -1590,   644,  -872,   349,   418,   329,  -156,   -75,
+      817,  1097,   603,   610,  1322, -1285, -1465,   384,
+    -1215,  -136,  1218, -1335,  -874,   220, -1187, -1659,
+    -1185, -1530, -1278,   794, -1510,  -854,  -870,   478,
+     -108,  -308,   996,   991,   958, -1460,  1522,  1628
+};
+
+typedef struct
+{
+    uint8_t k;
+    uint8_t eta1;
+
+} MLKEMParams;
+
+static MLKEMParams const params_512 = {2, 3};
+static MLKEMParams const params_768 = {3, 2};
+
+static inline const MLKEMParams *get_params(MLKEM::Variant variant)
+{
+    return (variant == MLKEM::MLKEM512) ? &params_512 : &params_768;
+}
+
+// Montgomery reduction: returns a * 2^-16 mod q, in the range (-q, q).
+static inline int16_t montgomery_reduce(int32_t a)
+{
+    int16_t t = (int16_t)(uint16_t)((uint32_t)a * MLKEM_QINV);
+    return (int16_t)((a - (int32_t)t * MLKEM_Q) >> 16);
+}
+
+static inline int16_t fqmul(int16_t a, int16_t b)
+{
+    return montgomery_reduce((int32_t)a * b);
+}
+
+// Barrett reduction: returns a mod q, centered around zero.
+static inline int16_t barrett_reduce(int16_t a)
+{
+    int16_t t = (int16_t)(((int32_t)MLKEM_BARRETT_V * a + (1L << 25)) >> 26);
+    return a - t * MLKEM_Q;
+}
+
+// Runs the forward NTT layers from "len" down to "minlen" and returns
+// the next index into the zetas table.
+static unsigned ntt_layers(int16_t *r, unsigned len, unsigned minlen,
+                           unsigned k)
+{
+    unsigned start, j;
+    int16_t zeta, t;
+    for (; len >= minlen; len >>= 1) {
+        for (start = 0; start < MLKEM_N; start = j + len) {
+            zeta = table_read(zetas, k++);
+            for (j = start; j < start + len; ++j) {
+                t = fqmul(zeta, r[j + len]);
+                r[j + len] = r[j] - t;
+                r[j] = r[j] + t;
+            }
+        }
+    }
+    return k;
+}
+
+// Runs the inverse NTT layers from "len" up to "maxlen" and returns
+// the next index into the zetas table.
+static unsigned invntt_layers(int16_t *r, unsigned len, unsigned maxlen,
+                              unsigned k)
+{
+    unsigned start, j;
+    int16_t zeta, t;
+    for (; len <= maxlen; len <<= 1) {
+        for (start = 0; start < MLKEM_N; start = j + len) {
+            zeta = table_read(zetas, k--);
+            for (j = start; j < start + len; ++j) {
+                t = r[j];
+                r[j] = barrett_reduce(t + r[j + len]);
+                r[j + len] = r[j + len] - t;
+                r[j + len] = fqmul(zeta, r[j + len]);
+            }
+        }
+    }
+    return k;
+}
+
+// Multiplies two degree-1 polynomials modulo X^2 - zeta.
+static inline void basemul(int16_t r[2], const int16_t a[2],
+                           const int16_t b[2], int16_t zeta)
+{
+    r[0] = fqmul(a[1], b[1]);
+    r[0] = fqmul(r[0], zeta);
+    r[0] += fqmul(a[0], b[0]);
+    r[1] = fqmul(a[0], b[1]);
+    r[1] += fqmul(a[1], b[0]);
+}
+
+static void poly_reduce(int16_t *r)
+{
+    for (unsigned i = 0; i < MLKEM_N; ++i)
+        r[i] = barrett_reduce(r[i]);
+}
+
+#if MLKEM_AVX2
+
+// AVX2 versions of the NTT and pointwise multiplication for x86 hosts.
+// These are selected at runtime if the CPU supports AVX2.  Sixteen
+// coefficients are processed at a time with results that are identical
+// to the scalar code.
+
+#define MLKEM_AVX2_TARGET __attribute__((target("avx2")))
+
+static bool mlkem_has_avx2()
+{
+    return __builtin_cpu_supports("avx2");
+}
+
+MLKEM_AVX2_TARGET static inline __m256i fqmul_avx2(__m256i a, __m256i b)
+{
+    __m256i lo = _mm256_mullo_epi16(a, b);
+    __m256i hi = _mm256_mulhi_epi16(a, b);
+    lo = _mm256_mullo_epi16(lo, _mm256_set1_epi16((int16_t)MLKEM_QINV));
+    lo = _mm256_mulhi_epi16(lo, _mm256_set1_epi16(MLKEM_Q));
+    return _mm256_sub_epi16(hi, lo);
+}
+
+MLKEM_AVX2_TARGET static inline __m256i barrett_reduce_avx2(__m256i a)
+{
+    __m256i t = _mm256_mulhi_epi16(a, _mm256_set1_epi16(MLKEM_BARRETT_V));
+    t = _mm256_add_epi16(t, _mm256_set1_epi16(1 << 9));
+    t = _mm256_srai_epi16(t, 10);
+    t = _mm256_mullo_epi16(t, _mm256_set1_epi16(MLKEM_Q));
+    return _mm256_sub_epi16(a, t);
+}
+
+// Swaps the adjacent coefficients in each pair.
+MLKEM_AVX2_TARGET static inline __m256i swap_pairs_avx2(__m256i a)
+{
+    return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(a, 0xB1), 0xB1);
+}
+
+MLKEM_AVX2_TARGET static void ntt_avx2(int16_t *r)
+{
+    unsigned len, start, j;
+    unsigned k = 1;
+    for (len = 128; len >= 16; len >>= 1) {
+        for (start = 0; start < MLKEM_N; start += 2 * len) {
+            __m256i zeta = _mm256_set1_epi16(table_read(zetas, k++));
+            for (j = start; j < start + len; j += 16) {
+                __m256i a = _mm256_loadu_si256((const __m256i *)(r + j));
+                __m256i b = _mm256_loadu_si256((const __m256i *)(r + j + len));
+                __m256i t = fqmul_avx2(zeta, b);
+                _mm256_storeu_si256((__m256i *)(r + j + len), _mm256_sub_epi16(a, t));
+                _mm256_storeu_si256((__m256i *)(r + j), _mm256_add_epi16(a, t));
+            }
+        }
+    }
+    ntt_layers(r, 8, 2, k);
+    for (j = 0; j < MLKEM_N; j += 16) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(r + j));
+        _mm256_storeu_si256((__m256i *)(r + j), barrett_reduce_avx2(a));
+    }
+}
+
+MLKEM_AVX2_TARGET static void invntt_avx2(int16_t *r)
+{
+    unsigned len, start, j;
+    unsigned k = invntt_layers(r, 2, 8, 127);
+    for (len = 16; len <= 128; len <<= 1) {
+        for (start = 0; start < MLKEM_N; start += 2 * len) {
+            __m256i zeta = _mm256_set1_epi16(table_read(zetas, k--));
+            for (j = start; j < start + len; j += 16) {
+                __m256i a = _mm256_loadu_si256((const __m256i *)(r + j));
+                __m256i b = _mm256_loadu_si256((const __m256i *)(r + j + len));
+                _mm256_storeu_si256((__m256i *)(r + j),
+                                    barrett_reduce_avx2(_mm256_add_epi16(a, b)));
+                _mm256_storeu_si256((__m256i *)(r + j + len),
+                                    fqmul_avx2(zeta, _mm256_sub_epi16(b, a)));
+            }
+        }
+    }
+    __m256i f = _mm256_set1_epi16(MLKEM_F);
+    for (j = 0; j < MLKEM_N; j += 16) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(r + j));
+        _mm256_storeu_si256((__m256i *)(r + j), fqmul_avx2(a, f));
+    }
+}
+
+// Each group of 16 coefficients holds 8 degree-1 polynomials, which use
+// the zeta values z0, -z0, z1, -z1, z2, -z2, z3, -z3 in turn.  The zetas
+// are placed in the odd lanes so that fqmul() zeroes the even lanes.
+MLKEM_AVX2_TARGET static void basemul_acc_avx2
+    (int16_t *r, const int16_t *a, const int16_t *b, bool first)
+{
+    for (unsigned i = 0; i < MLKEM_N; i += 16) {
+        int16_t z0 = table_read(zetas, 64 + i / 4);
+        int16_t z1 = table_read(zetas, 65 + i / 4);
+        int16_t z2 = table_read(zetas, 66 + i / 4);
+        int16_t z3 = table_read(zetas, 67 + i / 4);
+        __m256i zeta = _mm256_setr_epi16
+            (0, z0, 0, -z0, 0, z1, 0, -z1, 0, z2, 0, -z2, 0, z3, 0, -z3);
+        __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i *)(b + i));
+        __m256i p = fqmul_avx2(va, vb);                   // a0*b0, a1*b1
+        __m256i q = fqmul_avx2(va, swap_pairs_avx2(vb));  // a0*b1, a1*b0
+        __m256i t = fqmul_avx2(p, zeta);                  // 0, a1*b1*zeta
+        __m256i even = _mm256_add_epi16(p, swap_pairs_avx2(t));
+        __m256i odd = _mm256_add_epi16(q, swap_pairs_avx2(q));
+        __m256i result = _mm256_blend_epi16(even, odd, 0xAA);
+        if (!first) {
+            result = _mm256_add_epi16
+                (result, _mm256_loadu_si256((const __m256i *)(r + i)));
+        }
+        _mm256_storeu_si256((__m256i *)(r + i), result);
+    }
+}
+
+#endif // MLKEM_AVX2
+
+// Forward NTT, with the output reduced to be centered around zero.
+static void poly_ntt(int16_t *r)
+{
+#if MLKEM_AVX2
+    if (mlkem_has_avx2()) {
+        ntt_avx2(r);
+        return;
+    }
+#endif
+    ntt_layers(r, 128, 2, 1);
+    poly_reduce(r);
+}
+
+// Inverse NTT, which also removes the Montgomery factor introduced
+// by poly_basemul_acc().
+static void poly_invntt(int16_t *r)
+{
+#if MLKEM_AVX2
+    if (mlkem_has_avx2()) {
+        invntt_avx2(r);
+        return;
+    }
+#endif
+    invntt_layers(r, 2, 128, 127);
+    for (unsigned j = 0; j < MLKEM_N; ++j)
+        r[j] = fqmul(r[j], MLKEM_F);
+}
+
+// Multiplies a and b in the NTT domain and adds the result to r, or
+// sets r to the result if "first" is true.  The result is multiplied
+// by 2^-16 and is not reduced.
+static void poly_basemul_acc(int16_t *r, const int16_t *a,
+                             const int16_t *b, bool first)
+{
+#if MLKEM_AVX2
+    if (mlkem_has_avx2()) {
+        basemul_acc_avx2(r, a, b, first);
+        return;
+    }
+#endif
+    int16_t t[4];
+    for (unsigned i = 0; i < MLKEM_N; i += 4) {
+        int16_t zeta = table_read(zetas, 64 + i / 4);
+        basemul(t, a + i, b + i, zeta);
+        basemul(t + 2, a + i + 2, b + i + 2, -zeta);
+        if (first) {
+            r[i]     = t[0];
+            r[i + 1] = t[1];
+            r[i + 2] = t[2];
+            r[i + 3] = t[3];
+        } else {
+            r[i]     += t[0];
+            r[i + 1] += t[1];
+            r[i + 2] += t[2];
+            r[i + 3] += t[3];
+        }
+    }
+}
+
+static void poly_tomont(int16_t *r)
+{
+    for (unsigned i = 0; i < MLKEM_N; ++i)
+        r[i] = montgomery_reduce((int32_t)r[i] * MLKEM_MONT2);
+}
+
+static void poly_add(int16_t *r, const int16_t *a)
+{
+    for (unsigned i = 0; i < MLKEM_N; ++i)
+        r[i] += a[i];
+}
+
+// Maps a coefficient in the range (-q, q) to [0, q).
+static inline uint16_t poly_canonical(int16_t a)
+{
+    return (uint16_t)(a + ((a >> 15) & MLKEM_Q));
+}
+
+static void poly_tobytes(uint8_t *r, const int16_t *a)
+{
+    for (unsigned i = 0; i < MLKEM_N / 2; ++i) {
+        uint16_t t0 = poly_canonical(a[2 * i]);
+        uint16_t t1 = poly_canonical(a[2 * i + 1]);
+        r[3 * i]     = (uint8_t)t0;
+        r[3 * i + 1] = (uint8_t)((t0 >> 8) | (t1 << 4));
+        r[3 * i + 2] = (uint8_t)(t1 >> 4);
+    }
+}
+
+static void poly_frombytes(int16_t *r, const uint8_t *a)
+{
+    for (unsigned i = 0; i < MLKEM_N / 2; ++i) {
+        r[2 * i]     = (a[3 * i] | ((uint16_t)a[3 * i + 1] << 8)) & 0x0FFF;
+        r[2 * i + 1] = ((a[3 * i + 1] >> 4) | ((uint16_t)a[3 * i + 2] << 4)) & 0x0FFF;
+    }
+}
+
+// Compresses to 10 bits per coefficient.  The division by q is replaced
+// with a multiplication by 2^32 / q to keep it constant-time.
+static void poly_compress_u(uint8_t *r, const int16_t *a)
+{
+    uint16_t t[4];
+    for (unsigned i = 0; i < MLKEM_N / 4; ++i) {
+        for (unsigned j = 0; j < 4; ++j) {
+            uint64_t d = poly_canonical(a[4 * i + j]);
+            d = ((d << 10) + 1665) * 1290167;
+            t[j] = (uint16_t)((d >> 32) & 0x3FF);
+        }
+        r[5 * i]     = (uint8_t)t[0];
+        r[5 * i + 1] = (uint8_t)((t[0] >> 8) | (t[1] << 2));
+        r[5 * i + 2] = (uint8_t)((t[1] >> 6) | (t[2] << 4));
+        r[5 * i + 3] = (uint8_t)((t[2] >> 4) | (t[3] << 6));
+        r[5 * i + 4] = (uint8_t)(t[3] >> 2);
+    }
+}
+
+static void poly_decompress_u(int16_t *r, const uint8_t *a)
+{
+    uint16_t t[4];
+    for (unsigned i = 0; i < MLKEM_N / 4; ++i) {
+        t[0] = a[5 * i] | ((uint16_t)a[5 * i + 1] << 8);
+        t[1] = (a[5 * i + 1] >> 2) | ((uint16_t)a[5 * i + 2] << 6);
+        t[2] = (a[5 * i + 2] >> 4) | ((uint16_t)a[5 * i + 3] << 4);
+        t[3] = (a[5 * i + 3] >> 6) | ((uint16_t)a[5 * i + 4] << 2);
+        for (unsigned j = 0; j < 4; ++j)
+            r[4 * i + j] = (int16_t)(((uint32_t)(t[j] & 0x3FF) * MLKEM_Q + 512) >> 10);
+    }
+}
+
+// Compresses to 4 bits per coefficient.
+static void poly_compress_v(uint8_t *r, const int16_t *a)
+{
+    uint8_t t[2];
+    for (unsigned i = 0; i < MLKEM_N / 2; ++i) {
+        for (unsigned j = 0; j < 2; ++j) {
+            uint32_t d = poly_canonical(a[2 * i + j]);
+            d = (((d << 4) + 1665) * 80635) >> 28;
+            t[j] = (uint8_t)(d & 0x0F);
+        }
+        r[i] = t[0] | (t[1] << 4);
+    }
+}
+
+static void poly_decompress_v(int16_t *r, const uint8_t *a)
+{
+    for (unsigned i = 0; i < MLKEM_N / 2; ++i) {
+        r[2 * i]     = (int16_t)(((uint16_t)(a[i] & 0x0F) * MLKEM_Q + 8) >> 4);
+        r[2 * i + 1] = (int16_t)(((uint16_t)(a[i] >> 4) * MLKEM_Q + 8) >> 4);
+    }
+}
+
+static void poly_frommsg(int16_t *r, const uint8_t *msg)
+{
+    for (unsigned i = 0; i < MLKEM_N / 8; ++i) {
+        for (unsigned j = 0; j < 8; ++j) {
+            int16_t mask = -(int16_t)((msg[i] >> j) & 1);
+            r[8 * i + j] = mask & ((MLKEM_Q + 1) / 2);
+        }
+    }
+}
+
+static void poly_tomsg(uint8_t *msg, const int16_t *a)
+{
+    for (unsigned i = 0; i < MLKEM_N / 8; ++i) {
+        msg[i] = 0;
+        for (unsigned j = 0; j < 8; ++j) {
+            uint32_t t = poly_canonical(a[8 * i + j]);
+            t = (((t << 1) + 1665) * 80635) >> 28;
+            msg[i] |= (uint8_t)((t & 1) << j);
+        }
+    }
+}
+
+// Samples a uniformly-distributed polynomial in the NTT domain from
+// SHAKE128(rho || x || y).  The matrix is public so rejection sampling
+// does not need to be constant-time.
+static void poly_uniform(int16_t *r, SHAKE128 &xof, const uint8_t *rho,
+                         uint8_t x, uint8_t y)
+{
+    uint8_t buf[168];
+    uint8_t ext[2] = {x, y};
+    unsigned ctr = 0;
+    xof.reset();
+    xof.update(rho, MLKEM_SYMBYTES);
+    xof.update(ext, 2);
+    while (ctr < MLKEM_N) {
+        xof.extend(buf, sizeof(buf));
+        for (unsigned pos = 0; pos < sizeof(buf) && ctr < MLKEM_N; pos += 3) {
+            uint16_t val0 = (buf[pos] | ((uint16_t)buf[pos + 1] << 8)) & 0x0FFF;
+            uint16_t val1 = (buf[pos + 1] >> 4) | ((uint16_t)buf[pos + 2] << 4);
+            if (val0 < MLKEM_Q)
+                r[ctr++] = val0;
+            if (val1 < MLKEM_Q && ctr < MLKEM_N)
+                r[ctr++] = val1;
+        }
+    }
+}
+
+// Samples a noise polynomial from a centered binomial distribution with
+// parameter eta, using SHAKE256(seed || nonce) as the source of bits.
+static void poly_getnoise(int16_t *r, SHAKE256 &prf, const uint8_t *seed,
+                          uint8_t nonce, uint8_t eta)
+{
+    uint8_t buf[3 * MLKEM_N / 4];
+    uint32_t t, d;
+    unsigned i, j;
+    prf.reset();
+    prf.update(seed, MLKEM_SYMBYTES);
+    prf.update(&nonce, 1);
+    prf.extend(buf, eta * MLKEM_N / 4);
+    if (eta == 2) {
+        for (i = 0; i < MLKEM_N / 8; ++i) {
+            t = buf[4 * i] | ((uint32_t)buf[4 * i + 1] << 8) |
+                ((uint32_t)buf[4 * i + 2] << 16) |
+                ((uint32_t)buf[4 * i + 3] << 24);
+            d = (t & 0x55555555UL) + ((t >> 1) & 0x55555555UL);
+            for (j = 0; j < 8; ++j) {
+                r[8 * i + j] = (int16_t)((d >> (4 * j)) & 0x03) -
+                               (int16_t)((d >> (4 * j + 2)) & 0x03);
+            }
+        }
+    } else {
+        for (i = 0; i < MLKEM_N / 4; ++i) {
+            t = buf[3 * i] | ((uint32_t)buf[3 * i + 1] << 8) |
+                ((uint32_t)buf[3 * i + 2] << 16);
+            d = (t & 0x00249249UL) + ((t >> 1) & 0x00249249UL) +
+                ((t >> 2) & 0x00249249UL);
+            for (j = 0; j < 4; ++j) {
+                r[4 * i + j] = (int16_t)((d >> (6 * j)) & 0x07) -
+                               (int16_t)((d >> (6 * j + 3)) & 0x07);
+            }
+        }
+    }
+    clean(buf);
+}
+
+typedef struct
+{
+    int16_t y[MLKEM_MAX_K][MLKEM_N];    // Secret vector in the NTT domain.
+    int16_t acc[MLKEM_N];               // Accumulator for matrix products.
+    int16_t tmp[MLKEM_N];               // Matrix entries and noise.
+    uint8_t buf[MLKEM_POLYCOMPRESSEDBYTES_U]; // Compressed output.
+
+} MLKEMState;
+
+// Checks that all coefficients of the public key are reduced modulo q.
+static bool check_public_key(const uint8_t *pk, uint8_t k)
+{
+    uint16_t bad = 0;
+    for (unsigned i = 0; i < k * MLKEM_POLYBYTES; i += 3) {
+        uint16_t t0 = (pk[i] | ((uint16_t)pk[i + 1] << 8)) & 0x0FFF;
+        uint16_t t1 = (pk[i + 1] >> 4) | ((uint16_t)pk[i + 2] << 4);
+        bad |= ((uint16_t)(MLKEM_Q - 1 - t0)) >> 15;
+        bad |= ((uint16_t)(MLKEM_Q - 1 - t1)) >> 15;
+    }
+    return bad == 0;
+}
+
+// Copies or compares a component of the ciphertext.  When comparing,
+// returns non-zero if there is a difference.
+static uint8_t emit_ciphertext(uint8_t *ct, const uint8_t *compare,
+                               size_t offset, const uint8_t *buf, size_t len)
+{
+    uint8_t diff = 0;
+    if (compare) {
+        for (size_t i = 0; i < len; ++i)
+            diff |= compare[offset + i] ^ buf[i];
+    } else {
+        memcpy(ct + offset, buf, len);
+    }
+    return diff;
+}
+
+// Encrypts the message m with the K-PKE public key pk and the random
+// coins.  If "compare" is non-NULL, then the ciphertext is compared
+// against it instead of being written to ct, to save memory during
+// decapsulation.  Returns non-zero if the comparison failed.
+static uint8_t indcpa_enc(MLKEMState &state, const MLKEMParams *params,
+                          uint8_t *ct, const uint8_t *pk,
+                          const uint8_t *m, const uint8_t *coins,
+                          const uint8_t *compare)
+{
+    SHAKE128 xof;
+    SHAKE256 prf;
+    uint8_t k = params->k;
+    const uint8_t *rho = pk + k * MLKEM_POLYBYTES;
+    uint8_t diff = 0;
+    uint8_t i, j;
+
+    // Sample the secret vector y and transform it into the NTT domain.
+    for (i = 0; i < k; ++i) {
+        poly_getnoise(state.y[i], prf, coins, i, params->eta1);
+        poly_ntt(state.y[i]);
+    }
+
+    // u = NTT^-1(A^T * y) + e1.  The matrix is expanded one entry at a time.
+    for (i = 0; i < k; ++i) {
+        for (j = 0; j < k; ++j) {
+            poly_uniform(state.tmp, xof, rho, i, j);
+            poly_basemul_acc(state.acc, state.tmp, state.y[j], j == 0);
+        }
+        poly_reduce(state.acc);
+        poly_invntt(state.acc);
+        poly_getnoise(state.tmp, prf, coins, k + i, 2);
+        poly_add(state.acc, state.tmp);
+        poly_reduce(state.acc);
+        poly_compress_u(state.buf, state.acc);
+        diff |= emit_ciphertext(ct, compare, i * MLKEM_POLYCOMPRESSEDBYTES_U,
+                                state.buf, MLKEM_POLYCOMPRESSEDBYTES_U);
+    }
+
+    // v = NTT^-1(t^T * y) + e2 + Decompress(m).
+    for (j = 0; j < k; ++j) {
+        poly_frombytes(state.tmp, pk + j * MLKEM_POLYBYTES);
+        poly_basemul_acc(state.acc, state.tmp, state.y[j], j == 0);
+    }
+    poly_reduce(state.acc);
+    poly_invntt(state.acc);
+    poly_getnoise(state.tmp, prf, coins, 2 * k, 2);
+    poly_add(state.acc, state.tmp);
+    poly_frommsg(state.tmp, m);
+    poly_add(state.acc, state.tmp);
+    poly_reduce(state.acc);
+    poly_compress_v(state.buf, state.acc);
+    diff |= emit_ciphertext(ct, compare, k * MLKEM_POLYCOMPRESSEDBYTES_U,
+                            state.buf, MLKEM_POLYCOMPRESSEDBYTES_V);
+    return diff;
+}
+
+// Decrypts the ciphertext ct with the K-PKE secret key sk to produce m.
+static void indcpa_dec(MLKEMState &state, const MLKEMParams *params,
+                       uint8_t *m, const uint8_t *ct, const uint8_t *sk)
+{
+    uint8_t k = params->k;
+    for (uint8_t i = 0; i < k; ++i) {
+        poly_decompress_u(state.tmp, ct + i * MLKEM_POLYCOMPRESSEDBYTES_U);
+        poly_ntt(state.tmp);
+        poly_frombytes(state.y[0], sk + i * MLKEM_POLYBYTES);
+        poly_basemul_acc(state.acc, state.y[0], state.tmp, i == 0);
+    }
+    poly_reduce(state.acc);
+    poly_invntt(state.acc);
+    poly_decompress_v(state.tmp, ct + k * MLKEM_POLYCOMPRESSEDBYTES_U);
+    for (unsigned j = 0; j < MLKEM_N; ++j)
+        state.acc[j] = barrett_reduce(state.tmp[j] - state.acc[j]);
+    poly_tomsg(m, state.acc);
+}
+
+/** @endcond */
+
+/**
+ * \brief Returns the size of the public key for a variant of ML-KEM.
+ *
+ * \param variant The variant of ML-KEM.
+ * \return The number of bytes in the public key.
+ *
+ * \sa privateKeySize(), ciphertextSize()
+ */
+size_t MLKEM::publicKeySize(Variant variant)
+{
+    return get_params(variant)->k * MLKEM_POLYBYTES + MLKEM_SYMBYTES;
+}
+
+/**
+ * \brief Returns the size of the private key for a variant of ML-KEM.
+ *
+ * \param variant The variant of ML-KEM.
+ * \return The number of bytes in the private key.
+ *
+ * \sa publicKeySize(), ciphertextSize()
+ */
+size_t MLKEM::privateKeySize(Variant variant)
+{
+    return get_params(variant)->k * MLKEM_POLYBYTES * 2 + MLKEM_SYMBYTES * 3;
+}
+
+/**
+ * \brief Returns the size of the ciphertext for a variant of ML-KEM.
+ *
+ * \param variant The variant of ML-KEM.
+ * \return The number of bytes in the ciphertext.
+ *
+ * \sa publicKeySize(), privateKeySize()
+ */
+size_t MLKEM::ciphertextSize(Variant variant)
+{
+    return get_params(variant)->k * MLKEM_POLYCOMPRESSEDBYTES_U +
+           MLKEM_POLYCOMPRESSEDBYTES_V;
+}
+
+/**
+ * \brief Generates a new ML-KEM key pair.
+ *
+ * \param pk The public key to be sent to the other party, which must be
+ * publicKeySize() bytes in length.
+ * \param sk The private key to be passed to decaps() later, which must be
+ * privateKeySize() bytes in length.
+ * \param variant The variant of ML-KEM to use, MLKEM768 by default.
+ * \param random_seed Points to 64 bytes of random data to use to generate
+ * the key pair.  This is intended for test vectors only and should be set
+ * to NULL in real applications.
+ *
+ * \sa encaps(), decaps()
+ */
+void MLKEM::keygen(uint8_t *pk, uint8_t *sk, Variant variant,
+                   const uint8_t *random_seed)
+{
+    const MLKEMParams *params = get_params(variant);
+    uint8_t k = params->k;
+    uint8_t seed[2 * MLKEM_SYMBYTES];
+    uint8_t publicseed[2 * MLKEM_SYMBYTES];
+    const uint8_t *noiseseed = publicseed + MLKEM_SYMBYTES;
+#if MLKEM_HEAP_STATE
+    MLKEMState *heapState = new MLKEMState();
+    #define state (*heapState)
+#else
+    MLKEMState state;
+#endif
+    uint8_t i, j;
+
+    // Seed is d || z, where z is the implicit rejection value.
+    if (!random_seed)
+        RNG.rand(seed, sizeof(seed));
+    else
+        memcpy(seed, random_seed, sizeof(seed));
+
+    // (rho, sigma) = G(d || k)
+    {
+        SHA3_512 g;
+        g.update(seed, MLKEM_SYMBYTES);
+        g.update(&k, 1);
+        g.finalize(publicseed, sizeof(publicseed));
+    }
+
+    // Generate the secret vector s in the NTT domain and encode it into
+    // the first part of the private key.
+    {
+        SHAKE256 prf;
+        for (i = 0; i < k; ++i) {
+            poly_getnoise(state.y[i], prf, noiseseed, i, params->eta1);
+            poly_ntt(state.y[i]);
+            poly_tobytes(sk + i * MLKEM_POLYBYTES, state.y[i]);
+        }
+    }
+
+    // t = A * s + e, encoded directly into the public key one row at a time.
+    {
+        SHAKE128 xof;
+        SHAKE256 prf;
+        for (i = 0; i < k; ++i) {
+            for (j = 0; j < k; ++j) {
+                poly_uniform(state.tmp, xof, publicseed, j, i);
+                poly_basemul_acc(state.acc, state.tmp, state.y[j], j == 0);
+            }
+            poly_reduce(state.acc);
+            poly_tomont(state.acc);
+            poly_getnoise(state.tmp, prf, noiseseed, k + i, params->eta1);
+            poly_ntt(state.tmp);
+            poly_add(state.acc, state.tmp);
+            poly_reduce(state.acc);
+            poly_tobytes(pk + i * MLKEM_POLYBYTES, state.acc);
+        }
+    }
+    memcpy(pk + k * MLKEM_POLYBYTES, publicseed, MLKEM_SYMBYTES);
+
+    // Private key is s || pk || H(pk) || z.
+    size_t pklen = publicKeySize(variant);
+    uint8_t *skpk = sk + k * MLKEM_POLYBYTES;
+    memcpy(skpk, pk, pklen);
+    {
+        SHA3_256 h;
+        h.update(pk, pklen);
+        h.finalize(skpk + pklen, MLKEM_SYMBYTES);
+    }
+    memcpy(skpk + pklen + MLKEM_SYMBYTES, seed + MLKEM_SYMBYTES,
+           MLKEM_SYMBYTES);
+
+    // Clean up.
+    clean(seed);
+    clean(publicseed);
+    clean(&state, sizeof(state));
+#if MLKEM_HEAP_STATE
+    delete heapState;
+    #undef state
+#endif
+}
+
+/**
+ * \brief Encapsulates a new shared secret against a public key.
+ *
+ * \param shared_key The shared secret key.
+ * \param ciphertext The ciphertext to send to the owner of the public key,
+ * which must be ciphertextSize() bytes in length.
+ * \param pk The public key that was received from the other party.
+ * \param variant The variant of ML-KEM to use, MLKEM768 by default.
+ * \param random_seed Points to 32 bytes of random data to use to generate
+ * the shared secret.  This is intended for test vectors only and should be
+ * set to NULL in real applications.
+ *
+ * \return Returns false if the public key is malformed, in which case
+ * \a shared_key and \a ciphertext are not valid.
+ *
+ * \sa decaps(), keygen()
+ */
+bool MLKEM::encaps(uint8_t shared_key[MLKEM_SHAREDBYTES],
+                   uint8_t *ciphertext, const uint8_t *pk,
+                   Variant variant, const uint8_t *random_seed)
+{
+    const MLKEMParams *params = get_params(variant);
+    size_t pklen = publicKeySize(variant);
+    uint8_t buf[2 * MLKEM_SYMBYTES];
+    uint8_t kr[2 * MLKEM_SYMBYTES];
+
+    // Validate the public key as required by FIPS 203.
+    if (!check_public_key(pk, params->k))
+        return false;
+
+#if MLKEM_HEAP_STATE
+    MLKEMState *heapState = new MLKEMState();
+    #define state (*heapState)
+#else
+    MLKEMState state;
+#endif
+
+    // buf = m || H(pk)
+    if (!random_seed)
+        RNG.rand(buf, MLKEM_SYMBYTES);
+    else
+        memcpy(buf, random_seed, MLKEM_SYMBYTES);
+    {
+        SHA3_256 h;
+        h.update(pk, pklen);
+        h.finalize(buf + MLKEM_SYMBYTES, MLKEM_SYMBYTES);
+    }
+
+    // (K, r) = G(m || H(pk))
+    {
+        SHA3_512 g;
+        g.update(buf, sizeof(buf));
+        g.finalize(kr, sizeof(kr));
+    }
+
+    // Encrypt m with the coins r to produce the ciphertext.
+    indcpa_enc(state, params, ciphertext, pk, buf, kr + MLKEM_SYMBYTES, 0);
+    memcpy(shared_key, kr, MLKEM_SHAREDBYTES);
+
+    // Clean up.
+    clean(buf);
+    clean(kr);
+    clean(&state, sizeof(state));
+#if MLKEM_HEAP_STATE
+    delete heapState;
+    #undef state
+#endif
+    return true;
+}
+
+/**
+ * \brief Decapsulates a shared secret from a ciphertext.
+ *
+ * \param shared_key The shared secret key.
+ * \param ciphertext The ciphertext that was received from the other party.
+ * \param sk The private key that was generated by keygen().
+ * \param variant The variant of ML-KEM to use, MLKEM768 by default.
+ *
+ * \return Returns false if the private key fails its internal consistency
+ * check, in which case \a shared_key is set to all-zeroes.
+ *
+ * If the ciphertext is invalid, then this function will return true
+ * and \a shared_key will be set to a pseudorandom value derived from
+ * the private key and the ciphertext.  This "implicit rejection" avoids
+ * revealing to an attacker whether a modified ciphertext was accepted.
+ *
+ * \sa encaps(), keygen()
+ */
+bool MLKEM::decaps(uint8_t shared_key[MLKEM_SHAREDBYTES],
+                   const uint8_t *ciphertext, const uint8_t *sk,
+                   Variant variant)
+{
+    const MLKEMParams *params = get_params(variant);
+    size_t pklen = publicKeySize(variant);
+    size_t ctlen = ciphertextSize(variant);
+    const uint8_t *pk = sk + params->k * MLKEM_POLYBYTES;
+    const uint8_t *hpk = pk + pklen;
+    const uint8_t *z = hpk + MLKEM_SYMBYTES;
+    uint8_t buf[2 * MLKEM_SYMBYTES];
+    uint8_t kr[2 * MLKEM_SYMBYTES];
+    uint8_t rejected[MLKEM_SHAREDBYTES];
+
+    // Check that the hash of the public key in sk is consistent.
+    {
+        SHA3_256 h;
+        h.update(pk, pklen);
+        h.finalize(buf, MLKEM_SYMBYTES);
+    }
+    if (!secure_compare(buf, hpk, MLKEM_SYMBYTES)) {
+        clean(shared_key, MLKEM_SHAREDBYTES);
+        clean(buf);
+        return false;
+    }
+
+#if MLKEM_HEAP_STATE
+    MLKEMState *heapState = new MLKEMState();
+    #define state (*heapState)
+#else
+    MLKEMState state;
+#endif
+
+    // buf = m' || H(pk), and (K', r') = G(m' || H(pk)).
+    indcpa_dec(state, params, buf, ciphertext, sk);
+    memcpy(buf + MLKEM_SYMBYTES, hpk, MLKEM_SYMBYTES);
+    {
+        SHA3_512 g;
+        g.update(buf, sizeof(buf));
+        g.finalize(kr, sizeof(kr));
+    }
+
+    // Implicit rejection value = J(z || c).
+    {
+        SHAKE256 j;
+        j.update(z, MLKEM_SYMBYTES);
+        j.update(ciphertext, ctlen);
+        j.extend(rejected, sizeof(rejected));
+    }
+
+    // Re-encrypt and compare against the ciphertext we were given.
+    uint8_t diff = indcpa_enc(state, params, 0, pk, buf,
+                              kr + MLKEM_SYMBYTES, ciphertext);
+
+    // Select K' or the rejection value in constant time.
+    uint8_t mask = (uint8_t)(-(int8_t)((-(uint32_t)diff) >> 31));
+    for (uint8_t i = 0; i < MLKEM_SHAREDBYTES; ++i)
+        shared_key[i] = kr[i] ^ (mask & (kr[i] ^ rejected[i]));
+
+    // Clean up.
+    clean(buf);
+    clean(kr);
+    clean(rejected);
+    clean(&state, sizeof(state));
+#if MLKEM_HEAP_STATE
+    delete heapState;
+    #undef state
+#endif
+    return true;
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2016 Southern Storm Software, Pty Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef CRYPTO_MLKEM_h
+#define CRYPTO_MLKEM_h
+
+#include <inttypes.h>
+#include <stddef.h>
+
+#define MLKEM512_PUBLICKEYBYTES     800
+#define MLKEM512_PRIVATEKEYBYTES    1632
+#define MLKEM512_CIPHERTEXTBYTES    768
+
+#define MLKEM768_PUBLICKEYBYTES     1184
+#define MLKEM768_PRIVATEKEYBYTES    2400
+#define MLKEM768_CIPHERTEXTBYTES    1088
+
+#define MLKEM_SHAREDBYTES           32
+
+class MLKEM
+{
+private:
+    MLKEM() {}
+    ~MLKEM() {}
+
+public:
+    enum Variant
+    {
+        MLKEM512,
+        MLKEM768
+    };
+
+    static size_t publicKeySize(Variant variant);
+    static size_t privateKeySize(Variant variant);
+    static size_t ciphertextSize(Variant variant);
+
+    static void keygen(uint8_t *pk, uint8_t *sk, Variant variant = MLKEM768,
+                       const uint8_t *random_seed = 0);
+    static bool encaps(uint8_t shared_key[MLKEM_SHAREDBYTES],
+                       uint8_t *ciphertext, const uint8_t *pk,
+                       Variant variant = MLKEM768,
+                       const uint8_t *random_seed = 0);
+    static bool decaps(uint8_t shared_key[MLKEM_SHAREDBYTES],
+                       const uint8_t *ciphertext, const uint8_t *sk,
+                       Variant variant = MLKEM768);
+};
+
+#endif
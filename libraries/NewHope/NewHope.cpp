@@ -26,6 +26,7 @@
 #include <SHA3.h>
 #include <SHAKE.h>
 #include <RNG.h>
+#include <Arduino.h>
 #include <string.h>
 
 /** @cond */
@@ -47,6 +48,16 @@ void *operator new(size_t size, void *ptr)
 #define table_read(name, index) ((name)[(index)])
 #endif
 
+// Use AVX2 for the polynomial arithmetic on x86 hosts when the CPU
+// supports it.  Define NEWHOPE_NO_AVX2 to always use the portable code.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && \
+        !defined(NEWHOPE_NO_AVX2)
+#include <immintrin.h>
+#define NEWHOPE_AVX2 1
+#else
+#define NEWHOPE_AVX2 0
+#endif
+
 /** @endcond */
 
 /**
@@ -127,6 +138,11 @@ void *operator new(size_t size, void *ptr)
  * and then use it universally.  The paper contains more information on
  * why an application may want to use "torref" instead of "ref".
  *
+ * The RefX4 variant is specific to this library.  It is "ref" with the
+ * public parameter "a" split into four sub-streams that can be generated
+ * in parallel.  This makes keygen() and sharedb() faster on hosts with
+ * AVX2, but only when both parties use this library.
+ *
  * Reference: https://cryptojedi.org/crypto/#newhope
  */
 
@@ -141,6 +157,30 @@ void *operator new(size_t size, void *ptr)
  * Reference: https://cryptojedi.org/crypto/#newhope
  */
 
+/**
+ * \class NewHopeWorkspace NewHope.h <NewHope.h>
+ * \brief Workspace for the intermediate state of NewHope operations.
+ *
+ * Passing the same workspace to each call of keygen(), sharedb() or
+ * shareda() avoids placing NEWHOPE_WORKSPACE_SIZE bytes of state on the
+ * stack for every key exchange.  The contents should be treated as opaque.
+ */
+
+/**
+ * \class NewHopePublicParams NewHope.h <NewHope.h>
+ * \brief Cached NewHope public parameter for servers.
+ *
+ * Instances of NewHopePublicParams hold a pre-expanded public parameter
+ * "a" and its seed, which NewHope::generatePublicParams() creates and
+ * NewHope::keygen() uses.  The parameter is rotated automatically once
+ * its lifetime has expired.  It should be treated as opaque.
+ */
+
+/**
+ * \def NEWHOPE_WORKSPACE_SIZE
+ * \brief The number of bytes in a NewHopeWorkspace object.
+ */
+
 /**
  * \def NEWHOPE_SENDABYTES
  * \brief The number of bytes in the public key value sent by Alice.
@@ -496,6 +536,163 @@ inline uint16_t barrett_reduce(uint16_t a)
   return a;
 }
 
+#if NEWHOPE_AVX2
+
+// AVX2 versions of the polynomial operations for x86 hosts.  These are
+// selected at runtime if the CPU supports AVX2.  Coefficients are widened
+// to 32-bit lanes so that the reductions can be computed exactly as in
+// the scalar code, including the truncation to 16 bits on store.
+
+#define NEWHOPE_AVX2_TARGET __attribute__((target("avx2")))
+
+static bool newhope_has_avx2()
+{
+    return __builtin_cpu_supports("avx2");
+}
+
+NEWHOPE_AVX2_TARGET static inline __m256i montgomery_reduce_avx2(__m256i a)
+{
+    __m256i u = _mm256_mullo_epi32(a, _mm256_set1_epi32(qinv));
+    u = _mm256_and_si256(u, _mm256_set1_epi32((1 << rlog) - 1));
+    u = _mm256_mullo_epi32(u, _mm256_set1_epi32(PARAM_Q));
+    a = _mm256_add_epi32(a, u);
+    return _mm256_srli_epi32(a, rlog);
+}
+
+NEWHOPE_AVX2_TARGET static inline __m256i barrett_reduce_avx2(__m256i a)
+{
+    __m256i u;
+    a = _mm256_and_si256(a, _mm256_set1_epi32(0xFFFF));
+    u = _mm256_srli_epi32(_mm256_mullo_epi32(a, _mm256_set1_epi32(5)), 16);
+    u = _mm256_mullo_epi32(u, _mm256_set1_epi32(PARAM_Q));
+    return _mm256_sub_epi32(a, u);
+}
+
+// Loads 8 coefficients into 32-bit lanes.
+NEWHOPE_AVX2_TARGET static inline __m256i load8_avx2(const uint16_t *p)
+{
+    return _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)p));
+}
+
+// Truncates 8 lanes to 16 bits and stores them.
+NEWHOPE_AVX2_TARGET static inline void store8_avx2(uint16_t *p, __m256i v)
+{
+    v = _mm256_and_si256(v, _mm256_set1_epi32(0xFFFF));
+    v = _mm256_packus_epi32(v, v);
+    v = _mm256_permute4x64_epi64(v, 0x08);
+    _mm_storeu_si128((__m128i *)p, _mm256_castsi256_si128(v));
+}
+
+// Loads 16 coefficients into two vectors of 32-bit lanes.
+NEWHOPE_AVX2_TARGET static inline void load16_avx2
+    (__m256i *lo, __m256i *hi, const uint16_t *p)
+{
+    __m256i v = _mm256_loadu_si256((const __m256i *)p);
+    *lo = _mm256_cvtepu16_epi32(_mm256_castsi256_si128(v));
+    *hi = _mm256_cvtepu16_epi32(_mm256_extracti128_si256(v, 1));
+}
+
+// Truncates two vectors of 32-bit lanes to 16 bits and stores them.
+NEWHOPE_AVX2_TARGET static inline void store16_avx2
+    (uint16_t *p, __m256i lo, __m256i hi)
+{
+    __m256i mask = _mm256_set1_epi32(0xFFFF);
+    __m256i v = _mm256_packus_epi32(_mm256_and_si256(lo, mask),
+                                    _mm256_and_si256(hi, mask));
+    v = _mm256_permute4x64_epi64(v, 0xD8);
+    _mm256_storeu_si256((__m256i *)p, v);
+}
+
+NEWHOPE_AVX2_TARGET static void mul_coefficients_avx2
+    (uint16_t* poly, const uint16_t* factors)
+{
+    __m256i p0, p1, f0, f1;
+    for (int i = 0; i < PARAM_N; i += 16) {
+        load16_avx2(&p0, &p1, poly + i);
+        load16_avx2(&f0, &f1, factors + i);
+        p0 = montgomery_reduce_avx2(_mm256_mullo_epi32(p0, f0));
+        p1 = montgomery_reduce_avx2(_mm256_mullo_epi32(p1, f1));
+        store16_avx2(poly + i, p0, p1);
+    }
+}
+
+NEWHOPE_AVX2_TARGET static void ntt_avx2(uint16_t * a, const uint16_t* omega)
+{
+    int level, distance, start, j, jTwiddle;
+    uint16_t temp, W;
+    __m256i x, y, w, q3;
+
+    q3 = _mm256_set1_epi32(3 * PARAM_Q);
+    for (level = 0; level < 10; ++level) {
+        // Even levels omit the reduction of the sum; odd levels reduce it.
+        distance = 1 << level;
+        if (distance < 8) {
+            // Butterflies are too close together to vectorise.
+            for (start = 0; start < distance; start++) {
+                jTwiddle = 0;
+                for (j = start; j < PARAM_N - 1; j += 2 * distance) {
+                    W = omega[jTwiddle++];
+                    temp = a[j];
+                    if (level & 1)
+                        a[j] = barrett_reduce((temp + a[j + distance]));
+                    else
+                        a[j] = (temp + a[j + distance]);
+                    a[j + distance] = montgomery_reduce((W * ((uint32_t)temp + 3*PARAM_Q - a[j + distance])));
+                }
+            }
+            continue;
+        }
+
+        // All butterflies in a block of 2 * distance use the same twiddle.
+        jTwiddle = 0;
+        for (start = 0; start < PARAM_N; start += 2 * distance) {
+            w = _mm256_set1_epi32(omega[jTwiddle++]);
+            for (j = start; j < (start + distance); j += 8) {
+                x = load8_avx2(a + j);
+                y = load8_avx2(a + j + distance);
+                if (level & 1)
+                    store8_avx2(a + j, barrett_reduce_avx2(_mm256_add_epi32(x, y)));
+                else
+                    store8_avx2(a + j, _mm256_add_epi32(x, y));
+                y = _mm256_sub_epi32(_mm256_add_epi32(x, q3), y);
+                y = montgomery_reduce_avx2(_mm256_mullo_epi32(w, y));
+                store8_avx2(a + j + distance, y);
+            }
+        }
+    }
+}
+
+NEWHOPE_AVX2_TARGET static void poly_pointwise_avx2
+    (uint16_t *r, const uint16_t *a, const uint16_t *b)
+{
+    __m256i a0, a1, b0, b1, f;
+    f = _mm256_set1_epi32(3186);
+    for (int i = 0; i < PARAM_N; i += 16) {
+        load16_avx2(&a0, &a1, a + i);
+        load16_avx2(&b0, &b1, b + i);
+        b0 = montgomery_reduce_avx2(_mm256_mullo_epi32(b0, f));
+        b1 = montgomery_reduce_avx2(_mm256_mullo_epi32(b1, f));
+        a0 = montgomery_reduce_avx2(_mm256_mullo_epi32(a0, b0));
+        a1 = montgomery_reduce_avx2(_mm256_mullo_epi32(a1, b1));
+        store16_avx2(r + i, a0, a1);
+    }
+}
+
+NEWHOPE_AVX2_TARGET static void poly_add_avx2
+    (uint16_t *r, const uint16_t *a, const uint16_t *b)
+{
+    __m256i a0, a1, b0, b1;
+    for (int i = 0; i < PARAM_N; i += 16) {
+        load16_avx2(&a0, &a1, a + i);
+        load16_avx2(&b0, &b1, b + i);
+        a0 = barrett_reduce_avx2(_mm256_add_epi32(a0, b0));
+        a1 = barrett_reduce_avx2(_mm256_add_epi32(a1, b1));
+        store16_avx2(r + i, a0, a1);
+    }
+}
+
+#endif // NEWHOPE_AVX2
+
 static void bitrev_vector(uint16_t* poly)
 {
     unsigned int i,r;
@@ -513,6 +710,8 @@ static void bitrev_vector(uint16_t* poly)
     }
 }
 
+#if NEWHOPE_SMALL_FOOTPRINT
+
 static void mul_coefficients(uint16_t* poly, const uint16_t* factors)
 {
     unsigned int i;
@@ -560,7 +759,10 @@ static void ntt(uint16_t * a, const uint16_t* omega)
   }
 }
 
-static int32_t abs(int32_t v)
+#endif // NEWHOPE_SMALL_FOOTPRINT
+
+// Renamed from abs() to avoid a clash with <stdlib.h> via <immintrin.h>.
+static int32_t abs32(int32_t v)
 {
   int32_t mask = v >> 31;
   return (v ^ mask) - mask;
@@ -586,7 +788,7 @@ static int32_t f(int32_t *v0, int32_t *v1, uint32_t x)
   r = t & 1;
   *v1 = (t>>1)+r;
 
-  return abs(x-((*v0)*2*PARAM_Q));
+  return abs32(x-((*v0)*2*PARAM_Q));
 }
 
 static int32_t g(int32_t x)
@@ -606,7 +808,7 @@ static int32_t g(int32_t x)
 
   t *= 8*PARAM_Q;
 
-  return abs(t - x);
+  return abs32(t - x);
 }
 
 static int16_t LDDecode(int32_t xi0, int32_t xi1, int32_t xi2, int32_t xi3)
@@ -739,6 +941,13 @@ static void poly_pointwise(uint16_t *r, const uint16_t *a, const uint16_t *b)
 {
   int i;
   uint16_t t;
+#if NEWHOPE_AVX2
+  if (newhope_has_avx2())
+  {
+    poly_pointwise_avx2(r, a, b);
+    return;
+  }
+#endif
   for(i=0;i<PARAM_N;i++)
   {
     t    = montgomery_reduce(3186*(uint32_t)b[i]); /* t is now in Montgomery domain */
@@ -749,21 +958,41 @@ static void poly_pointwise(uint16_t *r, const uint16_t *a, const uint16_t *b)
 static void poly_add(uint16_t *r, const uint16_t *a, const uint16_t *b)
 {
   int i;
+#if NEWHOPE_AVX2
+  if (newhope_has_avx2())
+  {
+    poly_add_avx2(r, a, b);
+    return;
+  }
+#endif
   for(i=0;i<PARAM_N;i++)
     r[i] = barrett_reduce(a[i] + (uint32_t)b[i]);
 }
 
+#if !NEWHOPE_SMALL_FOOTPRINT
+static void ntt_merged(uint16_t *a, const uint16_t *omega,
+                       const uint16_t *pre, const uint16_t *post);
+#endif
+
 static void poly_ntt(uint16_t *r)
 {
+#if NEWHOPE_SMALL_FOOTPRINT
   mul_coefficients(r, psis_bitrev_montgomery); 
   ntt(r, omegas_montgomery);
+#else
+  ntt_merged(r, omegas_montgomery, psis_bitrev_montgomery, 0);
+#endif
 }
 
 static void poly_invntt(uint16_t *r)
 {
   bitrev_vector(r);
+#if NEWHOPE_SMALL_FOOTPRINT
   ntt(r, omegas_inv_montgomery);
   mul_coefficients(r, psis_inv_montgomery);
+#else
+  ntt_merged(r, omegas_inv_montgomery, 0, psis_inv_montgomery);
+#endif
 }
 
 static void encode_b_2nd_half(unsigned char *r, const uint16_t *c)
@@ -813,6 +1042,103 @@ static int discardtopoly(uint16_t *x)
 }
 
 // End of public domain code imported from the C reference code.
+
+#if !NEWHOPE_SMALL_FOOTPRINT
+
+// Version of ntt() for systems with 32-bit registers and enough code space.
+// Each pass over the polynomial performs the butterflies for two adjacent
+// levels on groups of four coefficients that are held in registers.
+// This halves the number of passes, and the unreduced sums from the even
+// levels are never stored.  The optional "pre" and "post" factor tables
+// are folded into the first and last passes instead of being applied by
+// separate calls to mul_coefficients().
+//
+// The odd level sums must be reduced in every pass, as in ntt().
+// Barrett reduction leaves values below 16380.  If a pass skipped it, the
+// sums going into the next pass could reach 4 * 16380.  The even level
+// of that pass would then form sums of up to 8 * 16380, which is more
+// than 16 bits.  It would also subtract values above 3 * PARAM_Q.
+//
+// The exception is the last pass of the inverse transform.  There, the
+// unreduced sums (at most 4 * 16380 = 65520) go straight into the
+// Montgomery multiplication by "post", which reduces them anyway.
+// The results are the same as ntt() modulo PARAM_Q, and are less than
+// PARAM_Q + 65520 * (PARAM_Q - 1) / 2^18 < 2^14.  The forward transform
+// produces bit-for-bit the same results as ntt().
+static void ntt_merged(uint16_t *a, const uint16_t *omega,
+                       const uint16_t *pre, const uint16_t *post)
+{
+    int level, distance, start, j, k;
+    uint16_t x0, x1, x2, x3, t, W0, W1, W2;
+
+#if NEWHOPE_AVX2
+    if (newhope_has_avx2()) {
+        if (pre)
+            mul_coefficients_avx2(a, pre);
+        ntt_avx2(a, omega);
+        if (post)
+            mul_coefficients_avx2(a, post);
+        return;
+    }
+#endif
+
+    for (level = 0; level < 10; level += 2) {
+        distance = 1 << level;
+        for (start = 0; start < distance; ++start) {
+            k = 0;
+            for (j = start; j < PARAM_N; j += 4 * distance, ++k) {
+                // Twiddles for the even and odd levels.
+                W0 = table_read(omega, 2 * k);
+                W1 = table_read(omega, 2 * k + 1);
+                W2 = table_read(omega, k);
+
+                // Load the four coefficients for this group.
+                x0 = a[j];
+                x1 = a[j + distance];
+                x2 = a[j + 2 * distance];
+                x3 = a[j + 3 * distance];
+                if (level == 0 && pre) {
+                    x0 = montgomery_reduce(x0 * (uint32_t)table_read(pre, j));
+                    x1 = montgomery_reduce(x1 * (uint32_t)table_read(pre, j + 1));
+                    x2 = montgomery_reduce(x2 * (uint32_t)table_read(pre, j + 2));
+                    x3 = montgomery_reduce(x3 * (uint32_t)table_read(pre, j + 3));
+                }
+
+                // Even level: omit the reduction of the sums.
+                t = x0;
+                x0 = t + x1;
+                x1 = montgomery_reduce(W0 * ((uint32_t)t + 3*PARAM_Q - x1));
+                t = x2;
+                x2 = t + x3;
+                x3 = montgomery_reduce(W1 * ((uint32_t)t + 3*PARAM_Q - x3));
+
+                // Odd level.
+                t = x0;
+                x0 = t + x2;
+                x2 = montgomery_reduce(W2 * ((uint32_t)t + 3*PARAM_Q - x2));
+                t = x1;
+                x1 = t + x3;
+                x3 = montgomery_reduce(W2 * ((uint32_t)t + 3*PARAM_Q - x3));
+
+                // Store the results back, reducing the sums unless the
+                // multiplication by "post" will do it for us.
+                if (level == 8 && post) {
+                    a[j]                = montgomery_reduce(x0 * (uint32_t)table_read(post, j));
+                    a[j + distance]     = montgomery_reduce(x1 * (uint32_t)table_read(post, j + distance));
+                    a[j + 2 * distance] = montgomery_reduce(x2 * (uint32_t)table_read(post, j + 2 * distance));
+                    a[j + 3 * distance] = montgomery_reduce(x3 * (uint32_t)table_read(post, j + 3 * distance));
+                } else {
+                    a[j]                = barrett_reduce(x0);
+                    a[j + distance]     = barrett_reduce(x1);
+                    a[j + 2 * distance] = x2;
+                    a[j + 3 * distance] = x3;
+                }
+            }
+        }
+    }
+}
+
+#endif // !NEWHOPE_SMALL_FOOTPRINT
  
 // Code size efficient (but slower) version of the Batcher sort.
 // https://en.wikipedia.org/wiki/Batcher_odd%E2%80%93even_mergesort
@@ -882,33 +1208,41 @@ static void crypto_chacha20_set_key(uint32_t *block, const unsigned char *k)
     memset(block + 12, 0, 8);
 }
 
-static void poly_uniform(SHAKE128 *shake, uint16_t *a, const unsigned char *seed)
+// Rejection-samples "count" coefficients from the output of "shake".
+static void poly_uniform_fill(SHAKE128 *shake, uint16_t *a, int count)
 {
     int ctr = 0;
-    int posn = PARAM_N;
+    int posn = count;
     uint16_t val;
 
-    // Absorb the seed material into the SHAKE128 object.
-    shake->update(seed, NEWHOPE_SEEDBYTES);
-
-    while (ctr < PARAM_N) {
+    while (ctr < count) {
         // Extract data from the SHAKE128 object directly into "a".
-        if (posn >= PARAM_N) {
+        if (posn >= count) {
             shake->extend((uint8_t *)(a + ctr),
-                          (PARAM_N - ctr) * sizeof(uint16_t));
+                          (count - ctr) * sizeof(uint16_t));
             posn = ctr;
         }
 
         // Process as much of the data as we can, discarding values
-        // that are greater than or equal to 5 * PARAM_Q.
-        while (posn < PARAM_N) {
+        // that are greater than or equal to 5 * PARAM_Q.  Every value is
+        // stored and the counter only advances for accepted values, which
+        // avoids a data-dependent branch per coefficient.  It is safe to
+        // store at "ctr" because it never passes "posn".
+        while (posn < count) {
             val = a[posn++];
-            if (val < (5 * PARAM_Q))
-                a[ctr++] = val;
+            a[ctr] = val;
+            ctr += (val < (5 * PARAM_Q));
         }
     }
 }
 
+static void poly_uniform(SHAKE128 *shake, uint16_t *a, const unsigned char *seed)
+{
+    // Absorb the seed material into the SHAKE128 object.
+    shake->update(seed, NEWHOPE_SEEDBYTES);
+    poly_uniform_fill(shake, a, PARAM_N);
+}
+
 static void poly_uniform_torref(SHAKE128 *shake, uint16_t *a, const unsigned char *seed)
 {
     shake->update(seed, 32);
@@ -917,10 +1251,239 @@ static void poly_uniform_torref(SHAKE128 *shake, uint16_t *a, const unsigned cha
     } while (discardtopoly(a));
 }
 
+// Number of independent SHAKE128 sub-streams for the RefX4 variant,
+// the number of coefficients that each one produces, and the SHAKE128
+// rate in 64-bit words.
+#define NEWHOPE_X4_LANES        4
+#define NEWHOPE_X4_COEFFS       (PARAM_N / NEWHOPE_X4_LANES)
+#define NEWHOPE_SHAKE128_WORDS  21
+
+#if NEWHOPE_AVX2
+
+static uint64_t const keccak_rc_x4[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808AULL,
+    0x8000000080008000ULL, 0x000000000000808BULL, 0x0000000080000001ULL,
+    0x8000000080008081ULL, 0x8000000000008009ULL, 0x000000000000008AULL,
+    0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000AULL,
+    0x000000008000808BULL, 0x800000000000008BULL, 0x8000000000008089ULL,
+    0x8000000000008003ULL, 0x8000000000008002ULL, 0x8000000000000080ULL,
+    0x000000000000800AULL, 0x800000008000000AULL, 0x8000000080008081ULL,
+    0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+// Rotation amount for word x + 5 * y in the rho step, and the word that
+// it moves to in the pi step.
+static uint8_t const keccak_rho_x4[25] = {
+     0,  1, 62, 28, 27, 36, 44,  6, 55, 20,  3, 10, 43,
+    25, 39, 41, 45, 15, 21,  8, 18,  2, 61, 56, 14
+};
+static uint8_t const keccak_pi_x4[25] = {
+     0, 10, 20,  5, 15, 16,  1, 11, 21,  6,  7, 17,  2,
+    12, 22, 23,  8, 18,  3, 13, 14, 24,  9, 19,  4
+};
+
+NEWHOPE_AVX2_TARGET static inline __m256i keccak_rol_x4(__m256i x, int n)
+{
+    return _mm256_or_si256(_mm256_sll_epi64(x, _mm_cvtsi32_si128(n)),
+                           _mm256_srl_epi64(x, _mm_cvtsi32_si128(64 - n)));
+}
+
+// Applies Keccak-f[1600] to four states at once.  Each 64-bit lane of
+// A[i] holds word i of a different state.
+NEWHOPE_AVX2_TARGET static void keccakp_x4_avx2(__m256i *A)
+{
+    __m256i B[25];
+    __m256i C[5];
+    __m256i D;
+    uint8_t round, x, y;
+    for (round = 0; round < 24; ++round) {
+        // Step mapping theta.
+        for (x = 0; x < 5; ++x) {
+            C[x] = _mm256_xor_si256
+                (_mm256_xor_si256(_mm256_xor_si256(A[x], A[x + 5]),
+                                  _mm256_xor_si256(A[x + 10], A[x + 15])),
+                 A[x + 20]);
+        }
+        for (x = 0; x < 5; ++x) {
+            D = _mm256_xor_si256(C[(x + 4) % 5],
+                                 keccak_rol_x4(C[(x + 1) % 5], 1));
+            for (y = 0; y < 25; y += 5)
+                A[x + y] = _mm256_xor_si256(A[x + y], D);
+        }
+
+        // Step mappings rho and pi combined into one.
+        for (x = 0; x < 25; ++x)
+            B[keccak_pi_x4[x]] = keccak_rol_x4(A[x], keccak_rho_x4[x]);
+
+        // Step mapping chi.
+        for (y = 0; y < 25; y += 5) {
+            for (x = 0; x < 5; ++x) {
+                A[x + y] = _mm256_xor_si256
+                    (B[x + y], _mm256_andnot_si256(B[(x + 1) % 5 + y],
+                                                   B[(x + 2) % 5 + y]));
+            }
+        }
+
+        // Step mapping iota.
+        A[0] = _mm256_xor_si256(A[0], _mm256_set1_epi64x(keccak_rc_x4[round]));
+    }
+}
+
+// Squeezes all four sub-streams of the RefX4 variant at once.
+NEWHOPE_AVX2_TARGET static void poly_uniform_x4_avx2
+    (uint16_t *a, const unsigned char *seed)
+{
+    __m256i A[25];
+    uint64_t out[NEWHOPE_SHAKE128_WORDS][NEWHOPE_X4_LANES];
+    int ctr[NEWHOPE_X4_LANES] = {0, 0, 0, 0};
+    uint64_t word;
+    uint16_t val;
+    uint8_t lane, index, shift;
+    bool more;
+
+    // Absorb "seed || lane" with the SHAKE128 padding into each state.
+    // The input is shorter than the rate so it fits in a single block.
+    for (index = 0; index < 25; ++index)
+        A[index] = _mm256_setzero_si256();
+    for (index = 0; index < 4; ++index) {
+        memcpy(&word, seed + index * 8, sizeof(word));  // Assumes little-endian.
+        A[index] = _mm256_set1_epi64x((long long)word);
+    }
+    A[4] = _mm256_set_epi64x(0x1F03, 0x1F02, 0x1F01, 0x1F00);
+    A[NEWHOPE_SHAKE128_WORDS - 1] =
+        _mm256_set1_epi64x((long long)0x8000000000000000ULL);
+
+    // Squeeze one block from every state at a time until all of the
+    // sub-streams have produced enough coefficients.
+    do {
+        keccakp_x4_avx2(A);
+        for (index = 0; index < NEWHOPE_SHAKE128_WORDS; ++index)
+            _mm256_storeu_si256((__m256i *)(out[index]), A[index]);
+        more = false;
+        for (lane = 0; lane < NEWHOPE_X4_LANES; ++lane) {
+            uint16_t *r = a + lane * NEWHOPE_X4_COEFFS;
+            int c = ctr[lane];
+            for (index = 0; index < NEWHOPE_SHAKE128_WORDS &&
+                            c < NEWHOPE_X4_COEFFS; ++index) {
+                word = out[index][lane];
+                for (shift = 0; shift < 64 && c < NEWHOPE_X4_COEFFS; shift += 16) {
+                    val = (uint16_t)(word >> shift);
+                    r[c] = val;
+                    c += (val < (5 * PARAM_Q));
+                }
+            }
+            ctr[lane] = c;
+            more |= (c < NEWHOPE_X4_COEFFS);
+        }
+    } while (more);
+
+    clean(A, sizeof(A));
+    clean(out, sizeof(out));
+}
+
+#endif // NEWHOPE_AVX2
+
+// Generates "a" for the RefX4 variant from four domain-separated SHAKE128
+// sub-streams.  Sub-stream "i" is SHAKE128(seed || i) and it produces
+// coefficients 256 * i to 256 * i + 255 with the same rejection sampling
+// as poly_uniform().  The sub-streams can be squeezed in parallel.
+static void poly_uniform_x4(SHAKE128 *shake, uint16_t *a, const unsigned char *seed)
+{
+#if NEWHOPE_AVX2
+    if (newhope_has_avx2()) {
+        poly_uniform_x4_avx2(a, seed);
+        return;
+    }
+#endif
+    for (uint8_t lane = 0; lane < NEWHOPE_X4_LANES; ++lane) {
+        shake->reset();
+        shake->update(seed, NEWHOPE_SEEDBYTES);
+        shake->update(&lane, 1);
+        poly_uniform_fill(shake, a + lane * NEWHOPE_X4_COEFFS, NEWHOPE_X4_COEFFS);
+    }
+}
+
+#if NEWHOPE_AVX2
+
+#define NEWHOPE_CHACHA_ROTL(x, n) \
+    _mm256_or_si256(_mm256_slli_epi32((x), (n)), _mm256_srli_epi32((x), 32 - (n)))
+#define NEWHOPE_CHACHA_QR(a, b, c, d) \
+    do { \
+        (a) = _mm256_add_epi32((a), (b)); \
+        (d) = NEWHOPE_CHACHA_ROTL(_mm256_xor_si256((d), (a)), 16); \
+        (c) = _mm256_add_epi32((c), (d)); \
+        (b) = NEWHOPE_CHACHA_ROTL(_mm256_xor_si256((b), (c)), 12); \
+        (a) = _mm256_add_epi32((a), (b)); \
+        (d) = NEWHOPE_CHACHA_ROTL(_mm256_xor_si256((d), (a)), 8); \
+        (c) = _mm256_add_epi32((c), (d)); \
+        (b) = NEWHOPE_CHACHA_ROTL(_mm256_xor_si256((b), (c)), 7); \
+    } while (0)
+
+// Generates the noise polynomial eight ChaCha20 blocks at a time.
+// Each 32-bit lane holds the same word from a different block, so the
+// bit counts for block "b" and word "w" produce coefficient 16 * b + w.
+NEWHOPE_AVX2_TARGET static void poly_getnoise_avx2
+    (uint16_t *r, const uint32_t *input)
+{
+    __m256i x[16];
+    __m256i counter = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    uint32_t out[16][8];
+    int blk, i, w;
+
+    for (blk = 0; blk < PARAM_N / 16; blk += 8) {
+        for (w = 0; w < 16; ++w)
+            x[w] = _mm256_set1_epi32(input[w]);
+        x[12] = _mm256_add_epi32(x[12], counter);
+        for (i = 0; i < 10; ++i) {
+            NEWHOPE_CHACHA_QR(x[0], x[4], x[8],  x[12]);
+            NEWHOPE_CHACHA_QR(x[1], x[5], x[9],  x[13]);
+            NEWHOPE_CHACHA_QR(x[2], x[6], x[10], x[14]);
+            NEWHOPE_CHACHA_QR(x[3], x[7], x[11], x[15]);
+            NEWHOPE_CHACHA_QR(x[0], x[5], x[10], x[15]);
+            NEWHOPE_CHACHA_QR(x[1], x[6], x[11], x[12]);
+            NEWHOPE_CHACHA_QR(x[2], x[7], x[8],  x[13]);
+            NEWHOPE_CHACHA_QR(x[3], x[4], x[9],  x[14]);
+        }
+        for (w = 0; w < 16; ++w) {
+            __m256i in = _mm256_set1_epi32(input[w]);
+            if (w == 12)
+                in = _mm256_add_epi32(in, counter);
+            __m256i t = _mm256_add_epi32(x[w], in);
+
+            // Count the bits in both 16-bit halves of each lane at once.
+            t = _mm256_sub_epi32
+                (t, _mm256_and_si256(_mm256_srli_epi32(t, 1),
+                                     _mm256_set1_epi32(0x55555555)));
+            t = _mm256_add_epi32
+                (_mm256_and_si256(t, _mm256_set1_epi32(0x33333333)),
+                 _mm256_and_si256(_mm256_srli_epi32(t, 2),
+                                  _mm256_set1_epi32(0x33333333)));
+            t = _mm256_and_si256(_mm256_add_epi32(t, _mm256_srli_epi32(t, 4)),
+                                 _mm256_set1_epi32(0x0F0F0F0F));
+            t = _mm256_and_si256(_mm256_add_epi32(t, _mm256_srli_epi32(t, 8)),
+                                 _mm256_set1_epi32(0x00FF00FF));
+            t = _mm256_sub_epi32
+                (_mm256_add_epi32(_mm256_and_si256(t, _mm256_set1_epi32(0xFF)),
+                                  _mm256_set1_epi32(PARAM_Q)),
+                 _mm256_srli_epi32(t, 16));
+            _mm256_storeu_si256((__m256i *)(out[w]), t);
+        }
+        for (i = 0; i < 8; ++i) {
+            for (w = 0; w < 16; ++w)
+                r[(blk + i) * 16 + w] = (uint16_t)(out[w][i]);
+        }
+        counter = _mm256_add_epi32(counter, _mm256_set1_epi32(8));
+    }
+
+    clean(x, sizeof(x));
+    clean(out, sizeof(out));
+}
+
+#endif // NEWHOPE_AVX2
+
 static void poly_getnoise(uint16_t *r, NewHopeChaChaState *chacha, unsigned char nonce)
 {
     int i, j;
-    uint32_t a, b;
 
     // Note: The rest of this function assumes that we are running on a
     // little-endian CPU.  Since we're generating random noise from a
@@ -933,6 +1496,15 @@ static void poly_getnoise(uint16_t *r, NewHopeChaChaState *chacha, unsigned char
     chacha->input[14] = nonce;                 // Assumes little-endian.
     chacha->input[15] = 0;
 
+#if NEWHOPE_AVX2
+    if (newhope_has_avx2()) {
+        poly_getnoise_avx2(r, chacha->input);
+        return;
+    }
+#endif
+
+#if NEWHOPE_SMALL_FOOTPRINT
+    uint32_t a, b;
     for (i = 0; i < PARAM_N; ++i) {
         // Generate a new block of random data if necessary.
         j = i % 16;
@@ -958,8 +1530,26 @@ static void poly_getnoise(uint16_t *r, NewHopeChaChaState *chacha, unsigned char
 
         r[i] = a + PARAM_Q - b;
     }
+#else
+    // Process two keystream words at a time, counting the bits in all
+    // four 16-bit halves in parallel within a 64-bit register.
+    uint64_t t;
+    for (i = 0; i < PARAM_N; i += 16) {
+        ChaCha::hashCore(chacha->output, chacha->input, 20);
+        ++(chacha->input[12]);                  // Assumes little-endian.
+        for (j = 0; j < 16; j += 2) {
+            t = chacha->output[j] | (((uint64_t)(chacha->output[j + 1])) << 32);
+            t = t - ((t >> 1) & 0x5555555555555555ULL);
+            t = (t & 0x3333333333333333ULL) + ((t >> 2) & 0x3333333333333333ULL);
+            t = ((t >> 4) + t) & 0x0F0F0F0F0F0F0F0FULL;
+            t = ((t >> 8) + t) & 0x00FF00FF00FF00FFULL;
+            r[i + j]     = (uint16_t)((t & 0xFF) + PARAM_Q - ((t >> 16) & 0xFF));
+            r[i + j + 1] = (uint16_t)(((t >> 32) & 0xFF) + PARAM_Q - (t >> 48));
+        }
+    }
+#endif
 
-    clean(&chacha, sizeof(chacha));
+    clean(chacha->output, sizeof(chacha->output));
 }
 
 /** @endcond */
@@ -982,6 +1572,20 @@ static void poly_getnoise(uint16_t *r, NewHopeChaChaState *chacha, unsigned char
  * to save memory.  In that case, Torref is identical to Ref.
  */
 
+/**
+ * \var NewHope::RefX4
+ * \brief Version of "ref" that expands the public parameter "a" from
+ * four independent SHAKE128 sub-streams.
+ *
+ * Sub-stream i is SHAKE128(seed || i) for i = 0 to 3.  Each one supplies
+ * 256 of the coefficients of "a" with the same rejection sampling as Ref.
+ * On x86 hosts with AVX2, the four sub-streams are squeezed at the same
+ * time with a 4-way Keccak permutation.
+ *
+ * RefX4 is not binary-compatible with Ref, Torref, or other New Hope
+ * implementations.  Both parties must use it.
+ */
+
 /** @cond */
 
 #define ALLOC_OBJ(type, name)   \
@@ -990,6 +1594,13 @@ static void poly_getnoise(uint16_t *r, NewHopeChaChaState *chacha, unsigned char
 #define INIT_OBJ(type, name)  \
     type *name = new (state.name##_x) type
 
+// Binds "state" to the workspace "ws", with a compile-time check that
+// the state type fits within NEWHOPE_WORKSPACE_SIZE.
+#define WORKSPACE_STATE(type)   \
+    typedef char type##_fits[(sizeof(type) <= sizeof(NewHopeWorkspace)) ? 1 : -1] \
+        __attribute__((unused)); \
+    type &state = *(new (ws) type)
+
 #if defined(ESP8266)
 // If we try to put the state on the stack, then it causes a stack smash.
 // Possibly a system stack size limitation.  Allocate the NewHope state on
@@ -1004,6 +1615,111 @@ static void poly_getnoise(uint16_t *r, NewHopeChaChaState *chacha, unsigned char
 #define NEWHOPE_BYTE_ALIGNED 0
 #endif
 
+// The functions that do not take a NewHopeWorkspace allocate a workspace
+// that is only as large as the state for that operation.
+#define WORKSPACE_WORDS(type)   \
+    ((sizeof(type) + sizeof(uint64_t) - 1) / sizeof(uint64_t))
+#if NEWHOPE_HEAP_STATE
+#define ALLOC_WORKSPACE(type)   \
+    uint64_t *ws = new uint64_t [WORKSPACE_WORDS(type)]
+#define FREE_WORKSPACE()        delete [] ws
+#else
+#define ALLOC_WORKSPACE(type)   uint64_t ws[WORKSPACE_WORDS(type)]
+#define FREE_WORKSPACE()        do { ; } while (0)
+#endif
+
+// State for keygen().
+typedef union {
+    struct {
+        uint16_t a[PARAM_N];        // Value of "a" as a "poly" object.
+        uint16_t pk[PARAM_N];       // Value of "pk" as a "poly" object.
+    };
+    struct {
+        uint16_t a_ext[84 * 16];    // Value of "a" for torref uniform.
+        ALLOC_OBJ(SHAKE128, shake); // SHAKE128 object for poly_uniform().
+    };
+    ALLOC_OBJ(SHA3_256, sha3);      // SHA3 object for hashing the seed.
+} NewHopeKeygenState;
+
+// State for generatePublicParams().
+typedef union {
+    struct {
+        uint16_t a_ext[84 * 16];    // Value of "a" for torref uniform.
+        ALLOC_OBJ(SHAKE128, shake); // SHAKE128 object for poly_uniform().
+    };
+    ALLOC_OBJ(SHA3_256, sha3);      // SHA3 object for hashing the seed.
+} NewHopePublicParamsState;
+
+// State for keygen() with a cached public parameter, which may need to
+// regenerate the parameter first.
+typedef struct {
+    uint16_t pk[PARAM_N];           // Value of "pk" as a "poly" object.
+    uint16_t e[PARAM_N];            // Value of "e" as a "poly" object.
+} NewHopeKeygenCachedState;
+typedef union {
+    NewHopeKeygenCachedState keygen;
+    NewHopePublicParamsState params;
+} NewHopeKeygenCachedWorkspace;
+
+// State for sharedb().
+#if NEWHOPE_SMALL_FOOTPRINT && NEWHOPE_BYTE_ALIGNED
+typedef union {
+    struct {
+        uint16_t a[PARAM_N];        // Value of "a" as a "poly" object.
+        uint16_t v[PARAM_N];        // Value of "v" as a "poly" object.
+    };
+    struct {
+        uint16_t a_ext[84 * 16];    // Value of "a" for torref uniform.
+        ALLOC_OBJ(SHAKE128, shake); // SHAKE128 object for poly_uniform().
+    };
+    ALLOC_OBJ(SHA3_256, sha3);      // SHA3 object for hashing the result.
+} NewHopeSharedBState;
+#else
+typedef union {
+    struct {
+        uint16_t a[PARAM_N];        // Value of "a" as a "poly" object.
+        uint16_t v[PARAM_N];        // Value of "v" as a "poly" object.
+        uint16_t bp[PARAM_N];       // Value of "bp" as a "poly" object.
+    };
+    struct {
+        uint16_t a_ext[84 * 16];    // Value of "a" for torref uniform.
+        ALLOC_OBJ(SHAKE128, shake); // SHAKE128 object for poly_uniform().
+    };
+    ALLOC_OBJ(SHA3_256, sha3);      // SHA3 object for hashing the result.
+} NewHopeSharedBState;
+#endif
+
+// State for shareda().
+typedef union {
+    struct {
+        uint16_t v[PARAM_N];        // Value of "v" as a "poly" object.
+        uint16_t bp[PARAM_N];       // Value of "bp" as a "poly" object.
+    };
+    struct {
+        uint16_t v_alt[PARAM_N];
+        ALLOC_OBJ(NewHopeChaChaState, chacha);
+    };
+    ALLOC_OBJ(SHA3_256, sha3);      // SHA3 object for hashing the result.
+} NewHopeSharedAState;
+
+static void generate_keypair(uint8_t *send, NewHopePrivateKey &sk,
+                             uint64_t *ws, NewHope::Variant variant,
+                             const uint8_t *random_seed);
+static void generate_public_params(NewHopePublicParams &params,
+                                   NewHope::Variant variant,
+                                   const uint8_t *random_seed,
+                                   uint64_t *ws);
+static void generate_keypair_cached(uint8_t *send, NewHopePrivateKey &sk,
+                                    NewHopePublicParams &params,
+                                    uint64_t *ws, const uint8_t *random_seed);
+static void generate_shared_b(uint8_t *shared_key, uint8_t *send,
+                              uint8_t *received, uint64_t *ws,
+                              NewHope::Variant variant,
+                              const uint8_t *random_seed);
+static void generate_shared_a(uint8_t *shared_key,
+                              const NewHopePrivateKey &sk,
+                              uint8_t *received, uint64_t *ws);
+
 /** @endcond */
 
 /**
@@ -1024,6 +1740,42 @@ static void poly_getnoise(uint16_t *r, NewHopeChaChaState *chacha, unsigned char
  */
 void NewHope::keygen(uint8_t send[NEWHOPE_SENDABYTES], NewHopePrivateKey &sk,
                      Variant variant, const uint8_t *random_seed)
+{
+    ALLOC_WORKSPACE(NewHopeKeygenState);
+    generate_keypair(send, sk, ws, variant, random_seed);
+    FREE_WORKSPACE();
+}
+
+/**
+ * \brief Generates the key pair for Alice in a New Hope key exchange,
+ * using a caller-supplied workspace.
+ *
+ * \param send The public key value for Alice to be sent to Bob.
+ * \param sk The private key value for Alice to be passed to shareda() later.
+ * \param ws Workspace for intermediate values.  The contents are
+ * cleaned before this function returns.
+ * \param variant The variant of the New Hope algorithm to use, usually Ref.
+ * \param random_seed Points to 64 bytes of random data to use to generate
+ * the key pair.  This is intended for test vectors only and should be set
+ * to NULL in real applications.
+ *
+ * This version avoids placing NEWHOPE_WORKSPACE_SIZE bytes of state on
+ * the stack or allocating it on the heap on every call.  Applications
+ * that perform many key exchanges can reuse the same workspace each time,
+ * as long as it is not used by two calls at once.
+ */
+void NewHope::keygen(uint8_t send[NEWHOPE_SENDABYTES], NewHopePrivateKey &sk,
+                     NewHopeWorkspace &ws, Variant variant,
+                     const uint8_t *random_seed)
+{
+    generate_keypair(send, sk, ws.data, variant, random_seed);
+}
+
+/** @cond */
+
+static void generate_keypair(uint8_t *send, NewHopePrivateKey &sk,
+                             uint64_t *ws, NewHope::Variant variant,
+                             const uint8_t *random_seed)
 {
     // The order of calls is rearranged compared to the reference C version.
     // This allows us to get away with two temporary poly objects (a, pk)
@@ -1032,23 +1784,7 @@ void NewHope::keygen(uint8_t send[NEWHOPE_SENDABYTES], NewHopePrivateKey &sk,
     // We also combine most of the state into a single union, which allows
     // us to overlap some of the larger objects and reuse the stack space
     // at different points within this function.
-    typedef union {
-        struct {
-            uint16_t a[PARAM_N];        // Value of "a" as a "poly" object.
-            uint16_t pk[PARAM_N];       // Value of "pk" as a "poly" object.
-        };
-        struct {
-            uint16_t a_ext[84 * 16];    // Value of "a" for torref uniform.
-            ALLOC_OBJ(SHAKE128, shake); // SHAKE128 object for poly_uniform().
-        };
-        ALLOC_OBJ(SHA3_256, sha3);      // SHA3 object for hashing the seed.
-    } NewHopeKeygenState;
-#if NEWHOPE_HEAP_STATE
-    NewHopeKeygenState *heapState = new NewHopeKeygenState();
-    #define state (*heapState)
-#else
-    NewHopeKeygenState state;
-#endif
+    WORKSPACE_STATE(NewHopeKeygenState);
 
     // Hide the ChaCha state and the noise seed inside "send".
 #if NEWHOPE_BYTE_ALIGNED
@@ -1074,8 +1810,10 @@ void NewHope::keygen(uint8_t send[NEWHOPE_SENDABYTES], NewHopePrivateKey &sk,
     sha3->finalize(send + POLY_BYTES, NEWHOPE_SEEDBYTES);
 
     INIT_OBJ(SHAKE128, shake);
-    if (variant == Ref)
+    if (variant == NewHope::Ref)
         poly_uniform(shake, state.a, send + POLY_BYTES);
+    else if (variant == NewHope::RefX4)
+        poly_uniform_x4(shake, state.a, send + POLY_BYTES);
     else
         poly_uniform_torref(shake, state.a_ext, send + POLY_BYTES);
 
@@ -1104,12 +1842,181 @@ void NewHope::keygen(uint8_t send[NEWHOPE_SENDABYTES], NewHopePrivateKey &sk,
 #endif
     #undef noiseseed
     #undef chacha
-#if NEWHOPE_HEAP_STATE
-    delete heapState;
-    #undef state
+}
+
+// Expands a new public parameter "a" into "params", using the workspace
+// for the temporary state.
+static void generate_public_params(NewHopePublicParams &params,
+                                   NewHope::Variant variant,
+                                   const uint8_t *random_seed,
+                                   uint64_t *ws)
+{
+    WORKSPACE_STATE(NewHopePublicParamsState);
+
+    if (!random_seed)
+        RNG.rand(params.seed, NEWHOPE_SEEDBYTES);
+    else
+        memcpy(params.seed, random_seed, NEWHOPE_SEEDBYTES);
+    INIT_OBJ(SHA3_256, sha3);
+    sha3->update(params.seed, NEWHOPE_SEEDBYTES);
+    sha3->finalize(params.seed, NEWHOPE_SEEDBYTES);
+
+    INIT_OBJ(SHAKE128, shake);
+    if (variant == NewHope::Ref) {
+        poly_uniform(shake, params.coeffs, params.seed);
+    } else if (variant == NewHope::RefX4) {
+        poly_uniform_x4(shake, params.coeffs, params.seed);
+    } else {
+        poly_uniform_torref(shake, state.a_ext, params.seed);
+        memcpy(params.coeffs, state.a_ext, sizeof(params.coeffs));
+    }
+    params.variant = (uint8_t)variant;
+    params.created = millis();
+
+    clean(&state, sizeof(state));
+}
+
+/** @endcond */
+
+/**
+ * \brief Generates a cached public parameter for use with keygen().
+ *
+ * \param params The public parameter object to populate.
+ * \param lifetime The number of milliseconds that the public parameter
+ * may be used for before keygen() will automatically generate a new one.
+ * \param variant The variant of the New Hope algorithm to use, usually Ref.
+ * \param random_seed Points to 32 bytes of random data to use to generate
+ * the public parameter.  This is intended for test vectors only and should
+ * be set to NULL in real applications.
+ *
+ * Normally keygen() expands a fresh public parameter "a" from a new
+ * random seed for every key exchange.  Servers that accept a shared
+ * "a" for a limited time can call this function once and then pass
+ * \a params to keygen().  That skips the SHAKE128 expansion of "a" on
+ * each handshake.  The public seed is still sent to Bob, so sharedb()
+ * is unchanged.
+ *
+ * The public parameter is replaced with a new one once \a lifetime
+ * milliseconds have passed, so that the same "a" is not used forever.
+ * Applications can also call this function at any time to rotate it.
+ *
+ * \sa keygen()
+ */
+void NewHope::generatePublicParams(NewHopePublicParams &params,
+                                   unsigned long lifetime, Variant variant,
+                                   const uint8_t *random_seed)
+{
+    params.lifetime = lifetime;
+    ALLOC_WORKSPACE(NewHopePublicParamsState);
+    generate_public_params(params, variant, random_seed, ws);
+    FREE_WORKSPACE();
+}
+
+/**
+ * \brief Generates the key pair for Alice using a cached public parameter.
+ *
+ * \param send The public key value for Alice to be sent to Bob.
+ * \param sk The private key value for Alice to be passed to shareda() later.
+ * \param params The public parameter that was generated by
+ * generatePublicParams().  It is regenerated if its lifetime has expired.
+ * \param random_seed Points to 32 bytes of random data to use to generate
+ * the private key.  This is intended for test vectors only and should be
+ * set to NULL in real applications.
+ *
+ * Bob must call sharedb() with the same variant that was passed to
+ * generatePublicParams().
+ *
+ * \sa generatePublicParams(), sharedb(), shareda()
+ */
+void NewHope::keygen(uint8_t send[NEWHOPE_SENDABYTES], NewHopePrivateKey &sk,
+                     NewHopePublicParams &params, const uint8_t *random_seed)
+{
+    ALLOC_WORKSPACE(NewHopeKeygenCachedWorkspace);
+    generate_keypair_cached(send, sk, params, ws, random_seed);
+    FREE_WORKSPACE();
+}
+
+/**
+ * \brief Generates the key pair for Alice using a cached public parameter
+ * and a caller-supplied workspace.
+ *
+ * \param send The public key value for Alice to be sent to Bob.
+ * \param sk The private key value for Alice to be passed to shareda() later.
+ * \param params The public parameter that was generated by
+ * generatePublicParams().  It is regenerated if its lifetime has expired.
+ * \param ws Workspace for intermediate values.  The contents are
+ * cleaned before this function returns.
+ * \param random_seed Points to 32 bytes of random data to use to generate
+ * the private key.  This is intended for test vectors only and should be
+ * set to NULL in real applications.
+ *
+ * \sa generatePublicParams(), sharedb(), shareda()
+ */
+void NewHope::keygen(uint8_t send[NEWHOPE_SENDABYTES], NewHopePrivateKey &sk,
+                     NewHopePublicParams &params, NewHopeWorkspace &ws,
+                     const uint8_t *random_seed)
+{
+    generate_keypair_cached(send, sk, params, ws.data, random_seed);
+}
+
+/** @cond */
+
+static void generate_keypair_cached(uint8_t *send, NewHopePrivateKey &sk,
+                                    NewHopePublicParams &params,
+                                    uint64_t *ws, const uint8_t *random_seed)
+{
+    // Rotate the public parameter if it has reached the end of its life.
+    if ((unsigned long)(millis() - params.created) >= params.lifetime)
+        generate_public_params(params, (NewHope::Variant)(params.variant), 0, ws);
+
+    WORKSPACE_STATE(NewHopeKeygenCachedState);
+
+    // Hide the ChaCha state and the noise seed inside "send".
+#if NEWHOPE_BYTE_ALIGNED
+    #define chacha (*((NewHopeChaChaState *)send))
+#else
+    NewHopeChaChaState chacha;
 #endif
+#if NEWHOPE_SMALL_FOOTPRINT
+    #define noiseseed (sk.seed)
+#else
+    #define noiseseed (send + sizeof(NewHopeChaChaState))
+#endif
+
+    if (!random_seed)
+        RNG.rand(noiseseed, 32);
+    else
+        memcpy(noiseseed, random_seed, 32);
+    crypto_chacha20_set_key(chacha.input, noiseseed);
+
+#if NEWHOPE_SMALL_FOOTPRINT
+    poly_getnoise(state.pk, &chacha, 0);
+    poly_ntt(state.pk);
+    poly_pointwise(state.pk, state.pk, params.coeffs);
+#else
+    poly_getnoise(sk.coeffs, &chacha, 0);
+    poly_ntt(sk.coeffs);
+    poly_pointwise(state.pk, sk.coeffs, params.coeffs);
+#endif
+
+    poly_getnoise(state.e, &chacha, 1);
+    poly_ntt(state.e);
+
+    poly_add(state.pk, state.e, state.pk);
+
+    poly_tobytes(send, state.pk);
+    memcpy(send + POLY_BYTES, params.seed, NEWHOPE_SEEDBYTES);
+
+    clean(&state, sizeof(state));
+#if !NEWHOPE_BYTE_ALIGNED
+    clean(&chacha, sizeof(chacha));
+#endif
+    #undef noiseseed
+    #undef chacha
 }
 
+/** @endcond */
+
 /**
  * \brief Generates the public key and shared secret for Bob.
  *
@@ -1138,6 +2045,45 @@ void NewHope::sharedb(uint8_t shared_key[NEWHOPE_SHAREDBYTES],
                       uint8_t send[NEWHOPE_SENDBBYTES],
                       uint8_t received[NEWHOPE_SENDABYTES],
                       Variant variant, const uint8_t *random_seed)
+{
+    ALLOC_WORKSPACE(NewHopeSharedBState);
+    generate_shared_b(shared_key, send, received, ws, variant, random_seed);
+    FREE_WORKSPACE();
+}
+
+/**
+ * \brief Generates the public key and shared secret for Bob,
+ * using a caller-supplied workspace.
+ *
+ * \param shared_key The shared secret key.
+ * \param send The public key value for Bob to be sent to Alice.
+ * This is allowed to be the same pointer as \a received.
+ * \param received The public key value that was received from Alice.
+ * \param ws Workspace for intermediate values.  The contents are
+ * cleaned before this function returns.
+ * \param variant The variant of the New Hope algorithm to use, usually Ref.
+ * \param random_seed Points to 32 bytes of random data to use to generate
+ * the temporary private key for Bob.  This is intended for test vectors
+ * only and should be set to NULL in real applications.
+ *
+ * This is the same as the other version of sharedb() except that the
+ * intermediate state is kept in \a ws instead of on the stack.
+ */
+void NewHope::sharedb(uint8_t shared_key[NEWHOPE_SHAREDBYTES],
+                      uint8_t send[NEWHOPE_SENDBBYTES],
+                      uint8_t received[NEWHOPE_SENDABYTES],
+                      NewHopeWorkspace &ws, Variant variant,
+                      const uint8_t *random_seed)
+{
+    generate_shared_b(shared_key, send, received, ws.data, variant, random_seed);
+}
+
+/** @cond */
+
+static void generate_shared_b(uint8_t *shared_key, uint8_t *send,
+                              uint8_t *received, uint64_t *ws,
+                              NewHope::Variant variant,
+                              const uint8_t *random_seed)
 {
 #if NEWHOPE_SMALL_FOOTPRINT && NEWHOPE_BYTE_ALIGNED
     // The order of calls is rearranged compared to the reference C version.
@@ -1148,17 +2094,7 @@ void NewHope::sharedb(uint8_t shared_key[NEWHOPE_SHAREDBYTES],
     // We also combine most of the state into a single union, which allows
     // us to overlap some of the larger objects and reuse the stack space
     // at different points within this function.
-    union {
-        struct {
-            uint16_t a[PARAM_N];        // Value of "a" as a "poly" object.
-            uint16_t v[PARAM_N];        // Value of "v" as a "poly" object.
-        };
-        struct {
-            uint16_t a_ext[84 * 16];    // Value of "a" for torref uniform.
-            ALLOC_OBJ(SHAKE128, shake); // SHAKE128 object for poly_uniform().
-        };
-        ALLOC_OBJ(SHA3_256, sha3);      // SHA3 object for hashing the result.
-    } state;
+    WORKSPACE_STATE(NewHopeSharedBState);
     uint8_t seed[32];
     NewHopeChaChaState chacha;
     #define bp  ((uint16_t *)send)
@@ -1194,8 +2130,10 @@ void NewHope::sharedb(uint8_t shared_key[NEWHOPE_SHAREDBYTES],
     sha3->finalize(shared_key, 32);
 
     INIT_OBJ(SHAKE128, shake);
-    if (variant == Ref)
+    if (variant == NewHope::Ref)
         poly_uniform(shake, state.a, seed);
+    else if (variant == NewHope::RefX4)
+        poly_uniform_x4(shake, state.a, seed);
     else
         poly_uniform_torref(shake, state.a_ext, seed);
 
@@ -1223,24 +2161,7 @@ void NewHope::sharedb(uint8_t shared_key[NEWHOPE_SHAREDBYTES],
     // We also combine most of the state into a single union, which allows
     // us to overlap some of the larger objects and reuse the stack space
     // at different points within this function.
-    typedef union {
-        struct {
-            uint16_t a[PARAM_N];        // Value of "a" as a "poly" object.
-            uint16_t v[PARAM_N];        // Value of "v" as a "poly" object.
-            uint16_t bp[PARAM_N];       // Value of "bp" as a "poly" object.
-        };
-        struct {
-            uint16_t a_ext[84 * 16];    // Value of "a" for torref uniform.
-            ALLOC_OBJ(SHAKE128, shake); // SHAKE128 object for poly_uniform().
-        };
-        ALLOC_OBJ(SHA3_256, sha3);      // SHA3 object for hashing the result.
-    } NewHopeSharedBState;
-#if NEWHOPE_HEAP_STATE
-    NewHopeSharedBState *heapState = new NewHopeSharedBState();
-    #define state (*heapState)
-#else
-    NewHopeSharedBState state;
-#endif
+    WORKSPACE_STATE(NewHopeSharedBState);
 
     // Hide the ChaCha state and the noise seed inside "send".
     // Put them at the end of the "send" buffer in case "received"
@@ -1258,8 +2179,10 @@ void NewHope::sharedb(uint8_t shared_key[NEWHOPE_SHAREDBYTES],
         memcpy(noiseseed, random_seed, 32);
 
     INIT_OBJ(SHAKE128, shake);
-    if (variant == Ref)
+    if (variant == NewHope::Ref)
         poly_uniform(shake, state.a, received + POLY_BYTES);
+    else if (variant == NewHope::RefX4)
+        poly_uniform_x4(shake, state.a, received + POLY_BYTES);
     else
         poly_uniform_torref(shake, state.a_ext, received + POLY_BYTES);
 
@@ -1301,12 +2224,10 @@ void NewHope::sharedb(uint8_t shared_key[NEWHOPE_SHAREDBYTES],
 #undef noiseseed
 #undef chacha
 #endif
-#if NEWHOPE_HEAP_STATE
-    delete heapState;
-    #undef state
-#endif
 }
 
+/** @endcond */
+
 /**
  * \brief Generates the shared secret for Alice.
  *
@@ -1319,6 +2240,38 @@ void NewHope::sharedb(uint8_t shared_key[NEWHOPE_SHAREDBYTES],
 void NewHope::shareda(uint8_t shared_key[NEWHOPE_SHAREDBYTES],
                       const NewHopePrivateKey &sk,
                       uint8_t received[NEWHOPE_SENDBBYTES])
+{
+    ALLOC_WORKSPACE(NewHopeSharedAState);
+    generate_shared_a(shared_key, sk, received, ws);
+    FREE_WORKSPACE();
+}
+
+/**
+ * \brief Generates the shared secret for Alice, using a caller-supplied
+ * workspace.
+ *
+ * \param shared_key The shared secret key.
+ * \param sk Alice's secret private key which was generated by keygen().
+ * \param received The public key value that was received from Bob.
+ * \param ws Workspace for intermediate values.  The contents are
+ * cleaned before this function returns.
+ *
+ * This is the same as the other version of shareda() except that the
+ * intermediate state is kept in \a ws instead of on the stack.
+ */
+void NewHope::shareda(uint8_t shared_key[NEWHOPE_SHAREDBYTES],
+                      const NewHopePrivateKey &sk,
+                      uint8_t received[NEWHOPE_SENDBBYTES],
+                      NewHopeWorkspace &ws)
+{
+    generate_shared_a(shared_key, sk, received, ws.data);
+}
+
+/** @cond */
+
+static void generate_shared_a(uint8_t *shared_key,
+                              const NewHopePrivateKey &sk,
+                              uint8_t *received, uint64_t *ws)
 {
     // The order of calls is rearranged compared to the reference C version.
     // This allows us to get away with two temporary poly objects (v, bp)
@@ -1327,23 +2280,7 @@ void NewHope::shareda(uint8_t shared_key[NEWHOPE_SHAREDBYTES],
     // We also combine most of the state into a single union, which allows
     // us to overlap some of the larger objects and reuse the stack space
     // at different points within this function.
-    typedef union {
-        struct {
-            uint16_t v[PARAM_N];        // Value of "v" as a "poly" object.
-            uint16_t bp[PARAM_N];       // Value of "bp" as a "poly" object.
-        };
-        struct {
-            uint16_t v_alt[PARAM_N];
-            ALLOC_OBJ(NewHopeChaChaState, chacha);
-        };
-        ALLOC_OBJ(SHA3_256, sha3);      // SHA3 object for hashing the result.
-    } NewHopeSharedAState;
-#if NEWHOPE_HEAP_STATE
-    NewHopeSharedAState *heapState = new NewHopeSharedAState();
-    #define state (*heapState)
-#else
-    NewHopeSharedAState state;
-#endif
+    WORKSPACE_STATE(NewHopeSharedAState);
 
 #if NEWHOPE_SMALL_FOOTPRINT
     // Re-create the full private key for Alice from the seed.
@@ -1370,8 +2307,6 @@ void NewHope::shareda(uint8_t shared_key[NEWHOPE_SHAREDBYTES],
     sha3->finalize(shared_key, 32);
 
     clean(&state, sizeof(state));
-#if NEWHOPE_HEAP_STATE
-    delete heapState;
-    #undef state
-#endif
 }
+
+/** @endcond */
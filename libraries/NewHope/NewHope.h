@@ -47,6 +47,32 @@ typedef struct
 
 } NewHopePrivateKey;
 
+#if NEWHOPE_SMALL_FOOTPRINT
+#define NEWHOPE_WORKSPACE_SIZE 4096
+#else
+#define NEWHOPE_WORKSPACE_SIZE 6144
+#endif
+
+typedef struct
+{
+    /** @cond */
+    uint64_t data[NEWHOPE_WORKSPACE_SIZE / sizeof(uint64_t)];
+    /** @endcond */
+
+} NewHopeWorkspace;
+
+typedef struct
+{
+    /** @cond */
+    uint16_t coeffs[1024];
+    uint8_t seed[32];
+    unsigned long created;
+    unsigned long lifetime;
+    uint8_t variant;
+    /** @endcond */
+
+} NewHopePublicParams;
+
 class NewHope
 {
 private:
@@ -57,7 +83,8 @@ public:
     enum Variant
     {
         Ref,
-        Torref
+        Torref,
+        RefX4
     };
 
     static void keygen(uint8_t send[NEWHOPE_SENDABYTES], NewHopePrivateKey &sk,
@@ -69,6 +96,30 @@ public:
     static void shareda(uint8_t shared_key[NEWHOPE_SHAREDBYTES],
                         const NewHopePrivateKey &sk,
                         uint8_t received[NEWHOPE_SENDBBYTES]);
+
+    static void keygen(uint8_t send[NEWHOPE_SENDABYTES], NewHopePrivateKey &sk,
+                       NewHopeWorkspace &ws, Variant variant = Ref,
+                       const uint8_t *random_seed = 0);
+    static void sharedb(uint8_t shared_key[NEWHOPE_SHAREDBYTES],
+                        uint8_t send[NEWHOPE_SENDBBYTES],
+                        uint8_t received[NEWHOPE_SENDABYTES],
+                        NewHopeWorkspace &ws, Variant variant = Ref,
+                        const uint8_t *random_seed = 0);
+    static void shareda(uint8_t shared_key[NEWHOPE_SHAREDBYTES],
+                        const NewHopePrivateKey &sk,
+                        uint8_t received[NEWHOPE_SENDBBYTES],
+                        NewHopeWorkspace &ws);
+
+    static void generatePublicParams(NewHopePublicParams &params,
+                                     unsigned long lifetime,
+                                     Variant variant = Ref,
+                                     const uint8_t *random_seed = 0);
+    static void keygen(uint8_t send[NEWHOPE_SENDABYTES], NewHopePrivateKey &sk,
+                       NewHopePublicParams &params,
+                       const uint8_t *random_seed = 0);
+    static void keygen(uint8_t send[NEWHOPE_SENDABYTES], NewHopePrivateKey &sk,
+                       NewHopePublicParams &params, NewHopeWorkspace &ws,
+                       const uint8_t *random_seed = 0);
 };
 
 #endif
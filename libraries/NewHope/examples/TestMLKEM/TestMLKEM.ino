@@ -0,0 +1,580 @@
+/*
+ * Copyright (C) 2016 Southern Storm Software, Pty Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+This example runs tests on the MLKEM class to verify correct behaviour.
+*/
+
+#include <Crypto.h>
+#include <MLKEM.h>
+#include <RNG.h>
+#include <string.h>
+#if defined(ESP8266) || defined(ESP32)
+#include <pgmspace.h>
+#else
+#include <avr/pgmspace.h>
+#if !defined(__AVR__)
+#define memcmp_P(a,b,c) memcmp((a), (b), (c))
+#endif
+#endif
+
+// Test vectors that were generated from the FIPS 203 specification.
+// The "rejected" value is the shared secret after flipping a bit in
+// byte 5 of the ciphertext.
+
+static uint8_t const mlkem512_keygen_seed[] PROGMEM = {
+    0x00, 0x07, 0x0e, 0x15, 0x1c, 0x23, 0x2a, 0x31, 0x38, 0x3f, 0x46, 0x4d,
+    0x54, 0x5b, 0x62, 0x69, 0x70, 0x77, 0x7e, 0x85, 0x8c, 0x93, 0x9a, 0xa1,
+    0xa8, 0xaf, 0xb6, 0xbd, 0xc4, 0xcb, 0xd2, 0xd9, 0xe0, 0xe7, 0xee, 0xf5,
+    0xfc, 0x03, 0x0a, 0x11, 0x18, 0x1f, 0x26, 0x2d, 0x34, 0x3b, 0x42, 0x49,
+    0x50, 0x57, 0x5e, 0x65, 0x6c, 0x73, 0x7a, 0x81, 0x88, 0x8f, 0x96, 0x9d,
+    0xa4, 0xab, 0xb2, 0xb9
+};
+
+static uint8_t const mlkem512_encaps_seed[] PROGMEM = {
+    0xff, 0xfc, 0xf9, 0xf6, 0xf3, 0xf0, 0xed, 0xea, 0xe7, 0xe4, 0xe1, 0xde,
+    0xdb, 0xd8, 0xd5, 0xd2, 0xcf, 0xcc, 0xc9, 0xc6, 0xc3, 0xc0, 0xbd, 0xba,
+    0xb7, 0xb4, 0xb1, 0xae, 0xab, 0xa8, 0xa5, 0xa2
+};
+
+static uint8_t const mlkem512_public[] PROGMEM = {
+    0x50, 0x71, 0x85, 0xaf, 0xba, 0x0a, 0x0d, 0xe6, 0x8e, 0x5e, 0x07, 0x08,
+    0x31, 0x66, 0xcf, 0xaa, 0x96, 0x20, 0xee, 0xcc, 0x7e, 0x4b, 0xe7, 0xb6,
+    0xa3, 0xd7, 0x97, 0x1e, 0x18, 0x9e, 0x1c, 0xec, 0xae, 0xd4, 0x92, 0xb4,
+    0x54, 0x4a, 0x29, 0xb5, 0xc9, 0x14, 0xb1, 0x33, 0x7b, 0xc6, 0x9c, 0x53,
+    0x72, 0xf6, 0xc9, 0x64, 0x3c, 0x61, 0xf7, 0xd0, 0x7d, 0x94, 0x00, 0xb0,
+    0x12, 0x9a, 0x9e, 0x01, 0x87, 0x79, 0x57, 0x71, 0x36, 0x9a, 0x73, 0x51,
+    0x67, 0xf6, 0xbf, 0xc5, 0x5b, 0x8b, 0x9d, 0xf7, 0xbf, 0x0d, 0x11, 0x4a,
+    0xd7, 0xeb, 0x53, 0x71, 0x76, 0xc6, 0xdc, 0x3c, 0x78, 0x17, 0x8b, 0x1d,
+    0x37, 0xfb, 0x6e, 0x52, 0x59, 0xc7, 0x5a, 0x81, 0x4d, 0xde, 0xc6, 0x3f,
+    0xa2, 0x5a, 0x9a, 0x96, 0x16, 0x92, 0xbc, 0x59, 0x7d, 0x1c, 0x8b, 0xcc,
+    0x1f, 0x7b, 0x56, 0x0c, 0x8c, 0x83, 0xe7, 0xc2, 0xa9, 0xc3, 0xc4, 0x78,
+    0xa5, 0x50, 0x3c, 0xce, 0x61, 0x95, 0xde, 0x6b, 0x35, 0x58, 0x42, 0xc2,
+    0xa5, 0x73, 0x05, 0xeb, 0x76, 0x49, 0x9c, 0xe1, 0x45, 0x42, 0xcc, 0x9c,
+    0xd1, 0x99, 0xa5, 0x40, 0xb7, 0xce, 0xaf, 0x0b, 0xac, 0x35, 0x4b, 0x93,
+    0x1a, 0xc5, 0x11, 0x24, 0x45, 0x2b, 0x54, 0xa2, 0x81, 0x85, 0xeb, 0x2d,
+    0x73, 0x24, 0x49, 0xdc, 0x58, 0x86, 0xe4, 0xb8, 0xb1, 0xac, 0x18, 0x98,
+    0x29, 0x9c, 0x2c, 0x53, 0xdb, 0x9a, 0x3e, 0x4b, 0x3d, 0x3c, 0x52, 0x21,
+    0xa7, 0x09, 0x9f, 0x4a, 0x52, 0xc1, 0xf2, 0x41, 0x0f, 0x8a, 0xa6, 0xae,
+    0xb9, 0xe7, 0x13, 0x27, 0xf4, 0x49, 0x29, 0x4b, 0xaf, 0xd0, 0xba, 0x90,
+    0x59, 0x63, 0x09, 0xf8, 0x69, 0x1e, 0x8f, 0x03, 0x4f, 0xda, 0xe4, 0x01,
+    0xad, 0x01, 0xc8, 0x19, 0x4b, 0x38, 0xf3, 0xd5, 0x19, 0x80, 0xa7, 0x21,
+    0x85, 0x58, 0xc5, 0x9c, 0xd0, 0x57, 0x25, 0xa5, 0x41, 0x70, 0x95, 0x3b,
+    0x5b, 0xea, 0x0d, 0xe1, 0x5c, 0x6b, 0x46, 0xd5, 0x84, 0x79, 0x90, 0x94,
+    0xe3, 0x4a, 0x54, 0x3f, 0xb0, 0x2c, 0x70, 0xa2, 0xb5, 0x11, 0x7a, 0x4b,
+    0xf2, 0x07, 0x32, 0x97, 0x5b, 0x58, 0x07, 0x8a, 0x6d, 0xff, 0x2b, 0xa3,
+    0x45, 0x2a, 0x03, 0x63, 0x54, 0x7a, 0x8d, 0x9c, 0x53, 0xeb, 0x42, 0x83,
+    0xc8, 0x55, 0x2a, 0x40, 0x27, 0x5d, 0x8a, 0x82, 0x5a, 0xf9, 0x69, 0x17,
+    0x80, 0xe9, 0x88, 0xdd, 0x94, 0x3d, 0x06, 0x88, 0x9a, 0xbf, 0x33, 0xcd,
+    0xd8, 0xe1, 0xaa, 0xc7, 0x71, 0x7a, 0x99, 0x67, 0x7d, 0xa6, 0x08, 0x9b,
+    0x8c, 0x31, 0xc2, 0xe5, 0x2b, 0x8d, 0x06, 0x11, 0x99, 0x51, 0xf6, 0x8d,
+    0xc4, 0x24, 0x1d, 0x09, 0xa6, 0x33, 0xd0, 0xfc, 0x1e, 0x67, 0x67, 0xb6,
+    0xae, 0xf9, 0x4c, 0x26, 0x39, 0x0a, 0x8d, 0x63, 0xa8, 0x20, 0xe2, 0x84,
+    0x7b, 0x08, 0x59, 0xf5, 0x7c, 0x59, 0x57, 0x39, 0x95, 0x26, 0xf9, 0x55,
+    0x49, 0xb5, 0x51, 0x09, 0x72, 0x91, 0x19, 0xd5, 0x50, 0xa8, 0x04, 0x1f,
+    0xc0, 0xd9, 0x64, 0x97, 0xc7, 0x38, 0x1d, 0x67, 0x90, 0x75, 0x51, 0x19,
+    0x09, 0x26, 0xc5, 0x9e, 0xa0, 0x1c, 0x36, 0x51, 0x2b, 0xbf, 0x73, 0x5e,
+    0xdc, 0x30, 0x95, 0xa4, 0x46, 0x61, 0x5b, 0x68, 0x95, 0x28, 0x71, 0x2e,
+    0xfe, 0xbc, 0xb4, 0x9f, 0x92, 0x4c, 0xc1, 0x7b, 0xab, 0xb2, 0xc6, 0x85,
+    0x51, 0x6c, 0x6a, 0xc1, 0x1b, 0x3d, 0x7d, 0xda, 0x50, 0xdf, 0xc1, 0x24,
+    0x71, 0x9c, 0x3f, 0x89, 0x17, 0x5c, 0xd9, 0xa8, 0x83, 0x6d, 0x17, 0xae,
+    0x40, 0x9a, 0x34, 0x95, 0x82, 0x3d, 0xe7, 0x59, 0x2f, 0x04, 0x90, 0xab,
+    0xa0, 0x66, 0x09, 0x2c, 0x37, 0x6b, 0x8f, 0x5c, 0x90, 0x61, 0x56, 0x14,
+    0x1a, 0x00, 0x62, 0x0e, 0x08, 0x3c, 0xff, 0x07, 0x23, 0x9e, 0xf9, 0x35,
+    0x4b, 0xab, 0x2e, 0xa0, 0xa8, 0x6e, 0x0c, 0xe0, 0x72, 0xa6, 0xf3, 0x14,
+    0x75, 0xc6, 0xbf, 0x2d, 0x01, 0x2a, 0x3d, 0x70, 0x3d, 0xd8, 0x08, 0x10,
+    0xe7, 0x31, 0xa1, 0x0c, 0x52, 0xa9, 0x65, 0x48, 0x55, 0x1c, 0xb8, 0x48,
+    0x2b, 0x18, 0x2b, 0xcd, 0x23, 0x43, 0x57, 0x88, 0x39, 0x53, 0x59, 0x65,
+    0x61, 0x25, 0x83, 0xba, 0x61, 0x08, 0x48, 0x49, 0x97, 0x7e, 0x03, 0x8c,
+    0x22, 0xba, 0x12, 0x1d, 0x30, 0x3a, 0x85, 0x35, 0xa3, 0x0a, 0xab, 0x2c,
+    0xbf, 0x5c, 0x1e, 0x59, 0x86, 0x19, 0x0a, 0x17, 0x42, 0xa4, 0xd8, 0x58,
+    0x72, 0xd7, 0xa5, 0xdf, 0x94, 0x36, 0x9d, 0xab, 0xb6, 0xbb, 0x26, 0x57,
+    0xd0, 0x07, 0x09, 0xa6, 0x19, 0x6f, 0x12, 0xa3, 0x94, 0x59, 0x30, 0x5c,
+    0xf4, 0x47, 0x56, 0x16, 0xbb, 0xa6, 0xfa, 0xfb, 0x5c, 0xc9, 0x31, 0xad,
+    0x23, 0x78, 0xb2, 0x6e, 0xc7, 0xb6, 0x33, 0xa0, 0x9b, 0x02, 0x50, 0x1d,
+    0xb4, 0x1b, 0x10, 0xef, 0x9b, 0x2c, 0x18, 0x45, 0x89, 0x35, 0x3c, 0x5e,
+    0xc5, 0x22, 0x01, 0x75, 0xdc, 0x06, 0xa4, 0x20, 0x2c, 0xf7, 0x1b, 0x4f,
+    0x35, 0x1c, 0xa3, 0x40, 0x84, 0x5a, 0x1a, 0x56, 0x52, 0x5d, 0x90, 0x93,
+    0x74, 0xab, 0x38, 0x9c, 0xa2, 0x23, 0x29, 0x08, 0x59, 0xf4, 0x24, 0x23,
+    0x68, 0xd6, 0x87, 0x12, 0xba, 0x3f, 0x0d, 0x30, 0x15, 0x00, 0x69, 0x6f,
+    0xa9, 0x39, 0x1d, 0xd3, 0x57, 0x6c, 0x4d, 0x39, 0x4a, 0x11, 0xe7, 0x02,
+    0xc8, 0x7a, 0x47, 0x71, 0xa1, 0x49, 0x61, 0x93, 0x68, 0x9c, 0xf0, 0x72,
+    0x9c, 0x97, 0x22, 0x61, 0x71, 0x32, 0xfd, 0x53, 0x25, 0x98, 0x6a, 0x3d,
+    0x20, 0x66, 0x6c, 0x44, 0xe9, 0x27, 0xf9, 0x26, 0x07, 0x40, 0xf8, 0xc4,
+    0xce, 0xb4, 0x7c, 0x34, 0xc7, 0xa9, 0x7a, 0x8a, 0x47, 0xaf, 0x37, 0x57,
+    0x9b, 0xb7, 0x71, 0x76, 0xcf, 0xf6, 0xa8, 0x18, 0x96, 0x5e, 0x78, 0x3a,
+    0x9a, 0x09, 0x31, 0xaf, 0xaf, 0xfa, 0xf6, 0xaf, 0x03, 0x65, 0x5f, 0x70,
+    0xce, 0x94, 0xcb, 0x34, 0xe5, 0xa0, 0x35, 0x89
+};
+
+static uint8_t const mlkem512_ciphertext[] PROGMEM = {
+    0x79, 0xa8, 0x46, 0x14, 0x49, 0x39, 0xe2, 0x18, 0x8a, 0xf0, 0xfa, 0xfc,
+    0x25, 0x6c, 0x39, 0xcd, 0xc4, 0x66, 0x35, 0xae, 0x03, 0xe3, 0x52, 0x00,
+    0xb9, 0x9d, 0xf1, 0x16, 0xe3, 0x07, 0xb8, 0x7f, 0x6e, 0x90, 0x18, 0x48,
+    0x6c, 0x50, 0x47, 0x12, 0xb1, 0xe9, 0x32, 0x25, 0x62, 0xc1, 0x97, 0xd9,
+    0xd2, 0x3f, 0x33, 0x57, 0x21, 0x33, 0x16, 0x62, 0x54, 0x7c, 0x9a, 0xff,
+    0xb0, 0xca, 0x6b, 0x0c, 0xf9, 0x90, 0x18, 0x8d, 0xd6, 0xaf, 0xd6, 0x65,
+    0x50, 0xc1, 0xc8, 0x47, 0xd7, 0x8b, 0x78, 0x84, 0x43, 0xee, 0xdb, 0x82,
+    0x4f, 0x60, 0x1e, 0x1f, 0x4b, 0x01, 0x6c, 0x33, 0xe8, 0x77, 0xc2, 0xa6,
+    0x13, 0x85, 0x9d, 0x80, 0x9a, 0xab, 0xef, 0x2f, 0x57, 0x35, 0x81, 0x1d,
+    0x21, 0x8e, 0x10, 0x6d, 0xd3, 0x81, 0x2c, 0xa4, 0x8e, 0x53, 0xab, 0x3a,
+    0x1e, 0xeb, 0x66, 0xfb, 0xef, 0xcb, 0x2b, 0x5e, 0x76, 0xb4, 0xdc, 0xfd,
+    0x8f, 0xa4, 0xb5, 0xf6, 0x2a, 0xd3, 0xad, 0x5c, 0x90, 0x4b, 0xd8, 0xf9,
+    0x29, 0xb8, 0x79, 0x06, 0x1c, 0xdd, 0x17, 0x7a, 0xe3, 0x69, 0x61, 0xdc,
+    0xa3, 0xa0, 0x36, 0x8b, 0x77, 0xf4, 0x52, 0x72, 0xa3, 0x96, 0x83, 0xdd,
+    0x0e, 0xf4, 0xb6, 0x59, 0xcb, 0xa7, 0xbf, 0x66, 0xd0, 0x40, 0xb4, 0xfb,
+    0xf5, 0x06, 0x82, 0x4e, 0x3a, 0x74, 0x39, 0xb1, 0xdf, 0x1e, 0x0e, 0xe5,
+    0x47, 0xd8, 0xf0, 0x54, 0x2c, 0xcb, 0xe6, 0xd8, 0xdb, 0x35, 0x35, 0x04,
+    0xbc, 0xe3, 0x64, 0x6a, 0xef, 0x39, 0x3c, 0x3d, 0x07, 0xa6, 0xfc, 0x26,
+    0x50, 0x70, 0xb1, 0x1e, 0xc3, 0x7b, 0xf7, 0xd4, 0xd5, 0x1b, 0xb3, 0x60,
+    0xa8, 0x42, 0x72, 0x5d, 0xf3, 0xe8, 0x45, 0xc5, 0x81, 0xdb, 0x21, 0xb3,
+    0x1c, 0xa0, 0x39, 0xb6, 0x0f, 0x77, 0xbf, 0x60, 0x0b, 0x5b, 0x9a, 0x50,
+    0xaf, 0x57, 0x8a, 0x7a, 0xef, 0x6d, 0x78, 0x23, 0x3e, 0xa3, 0x9d, 0xc7,
+    0x31, 0x6d, 0xbe, 0xee, 0xac, 0x0c, 0x7b, 0x57, 0x53, 0x10, 0xf5, 0x6e,
+    0x7b, 0x3e, 0xef, 0xa6, 0xfe, 0xea, 0xee, 0x95, 0x2b, 0xd1, 0xa3, 0x3f,
+    0xa4, 0xe7, 0x07, 0x3f, 0xb2, 0xa0, 0x37, 0x74, 0x17, 0x53, 0xab, 0xb8,
+    0xb5, 0xd9, 0x00, 0xe3, 0x11, 0xc4, 0x86, 0x30, 0xe7, 0x51, 0x6d, 0x85,
+    0xdf, 0x4c, 0x7e, 0x55, 0x09, 0x99, 0xf6, 0xc3, 0x47, 0xd0, 0xf4, 0x94,
+    0x1d, 0xa3, 0xc0, 0x9a, 0x4c, 0x4f, 0x3b, 0x47, 0xa3, 0x4b, 0x21, 0xfa,
+    0x5a, 0x3d, 0xd1, 0x76, 0x38, 0x18, 0xa1, 0x5b, 0x58, 0x99, 0x7d, 0x7d,
+    0x07, 0x05, 0x98, 0xfb, 0xa9, 0xda, 0x3b, 0x43, 0xb6, 0xd4, 0x19, 0xcc,
+    0x62, 0x29, 0x1d, 0x93, 0xd3, 0xbd, 0x90, 0x30, 0x36, 0xfc, 0xe9, 0x71,
+    0x1b, 0xcc, 0x45, 0x0e, 0xf1, 0x67, 0xe3, 0x21, 0xc5, 0x16, 0x5e, 0x0a,
+    0x6e, 0x7d, 0xc9, 0x92, 0x39, 0x2f, 0x18, 0x76, 0x83, 0x20, 0xce, 0x6e,
+    0xe7, 0x5b, 0xb0, 0x1f, 0x7d, 0x69, 0x5b, 0x29, 0x07, 0x38, 0x06, 0x93,
+    0x9d, 0x9e, 0x80, 0x72, 0x09, 0xf0, 0xfa, 0x3d, 0xed, 0x2a, 0x80, 0xb7,
+    0xc7, 0x5b, 0x58, 0x85, 0xb9, 0x30, 0xd9, 0x9d, 0x98, 0x55, 0xff, 0x11,
+    0x42, 0xdf, 0xad, 0x50, 0xdd, 0x7b, 0xb4, 0x93, 0x97, 0x3e, 0xd9, 0xad,
+    0x75, 0xa7, 0xe5, 0xc0, 0x05, 0x52, 0x61, 0x87, 0xd3, 0x5a, 0xa1, 0xcb,
+    0x29, 0xfd, 0xb6, 0x79, 0xad, 0x22, 0x2a, 0xb0, 0x7e, 0xb5, 0x83, 0xa5,
+    0xb6, 0x6a, 0x3f, 0xc3, 0x31, 0x9b, 0xa9, 0xd4, 0x76, 0xb1, 0x4e, 0xe4,
+    0xc6, 0xa3, 0x08, 0xfc, 0x11, 0x86, 0xff, 0x5b, 0x14, 0xcb, 0x68, 0xee,
+    0x17, 0xb7, 0x74, 0x73, 0xbf, 0xf7, 0xd5, 0xa4, 0x36, 0x14, 0x9e, 0xee,
+    0xd3, 0x6f, 0x69, 0x77, 0x5d, 0x25, 0x03, 0xaf, 0xd1, 0x4a, 0xe1, 0x53,
+    0x18, 0x11, 0x93, 0x54, 0x49, 0x57, 0x0a, 0x2f, 0x82, 0x3c, 0x45, 0x78,
+    0x29, 0x4f, 0x42, 0xd5, 0x49, 0x56, 0x9b, 0x62, 0x45, 0x00, 0x88, 0xb2,
+    0xab, 0xde, 0xd6, 0xfe, 0xcc, 0x71, 0xb5, 0x16, 0x99, 0xf8, 0xf1, 0x70,
+    0xc6, 0x51, 0xe7, 0x67, 0x39, 0xcd, 0x49, 0xc5, 0x4e, 0x1c, 0xf7, 0xad,
+    0x23, 0xa8, 0xb1, 0x2c, 0x81, 0x52, 0x27, 0x4e, 0x75, 0xfe, 0xf5, 0xb2,
+    0xe2, 0x4e, 0xea, 0xde, 0xef, 0xed, 0x04, 0x30, 0xaf, 0x19, 0x85, 0x97,
+    0x5d, 0x48, 0x7b, 0x0f, 0xf2, 0xea, 0xfb, 0x53, 0x1d, 0x5d, 0x59, 0xee,
+    0x8e, 0xaa, 0x84, 0xf6, 0x0a, 0x63, 0x5d, 0x70, 0x8b, 0x50, 0x70, 0xe7,
+    0x02, 0xde, 0x71, 0x72, 0x00, 0xda, 0x66, 0x8c, 0x70, 0xa7, 0x23, 0x7d,
+    0xea, 0xc9, 0xf0, 0xd5, 0x94, 0x4e, 0xc9, 0x92, 0x71, 0x79, 0x8a, 0x81,
+    0x45, 0x50, 0x50, 0xc5, 0xd5, 0x4a, 0xc6, 0xce, 0x5b, 0x9f, 0xd6, 0xff,
+    0xad, 0x8f, 0x67, 0x73, 0xa3, 0xaa, 0x11, 0xaf, 0x22, 0x68, 0xc6, 0x57,
+    0x1e, 0x9d, 0xed, 0xa0, 0x0a, 0xbd, 0xec, 0x3c, 0x3f, 0xc8, 0xe2, 0xf8,
+    0x98, 0x70, 0x17, 0xbf, 0x1f, 0x3f, 0xd4, 0x23, 0x04, 0x4c, 0x3b, 0x6a,
+    0x7c, 0x56, 0x87, 0x63, 0x98, 0x79, 0x88, 0xad, 0xb4, 0x7f, 0xe0, 0x1f,
+    0x1c, 0x6b, 0x7f, 0x1c, 0xe8, 0x2f, 0x48, 0x2e, 0xa6, 0xb8, 0xa3, 0x07,
+    0x6f, 0xfb, 0x90, 0x51, 0x25, 0x34, 0x76, 0x42, 0xd1, 0x9f, 0x11, 0x56,
+    0x38, 0x2a, 0xdb, 0xd8, 0x51, 0x20, 0x84, 0x5a, 0x84, 0x59, 0x27, 0xd6,
+    0x35, 0x67, 0xdc, 0xa0, 0x1a, 0x6a, 0xe5, 0x3a, 0x3f, 0xc0, 0xbc, 0xb4,
+    0xfb, 0xd8, 0x6e, 0xce, 0x58, 0xbc, 0x2d, 0xcb, 0x61, 0x21, 0x47, 0x71,
+    0x76, 0xda, 0x5e, 0xc7, 0x73, 0xf7, 0x32, 0xf0, 0x64, 0xe2, 0x80, 0x9f
+};
+
+static uint8_t const mlkem512_shared[] PROGMEM = {
+    0x8f, 0xb8, 0x00, 0xef, 0x7f, 0x5a, 0x1c, 0x14, 0xa9, 0x5f, 0xc2, 0x40,
+    0x68, 0xda, 0xa2, 0x58, 0xf3, 0xec, 0xc4, 0x4e, 0x9f, 0xb8, 0xee, 0x2b,
+    0x5c, 0x7e, 0x75, 0xeb, 0xf1, 0xf1, 0x16, 0x2d
+};
+
+static uint8_t const mlkem512_rejected[] PROGMEM = {
+    0xbe, 0x0e, 0x01, 0x6b, 0x35, 0x29, 0x90, 0x25, 0x2a, 0x07, 0xe5, 0xb0,
+    0x06, 0x4e, 0x07, 0x8c, 0xef, 0x8f, 0x1f, 0xca, 0x02, 0xdb, 0xe3, 0xc0,
+    0x48, 0xab, 0xd3, 0x3e, 0xc9, 0x60, 0x59, 0x45
+};
+
+static uint8_t const mlkem768_keygen_seed[] PROGMEM = {
+    0x01, 0x08, 0x0f, 0x16, 0x1d, 0x24, 0x2b, 0x32, 0x39, 0x40, 0x47, 0x4e,
+    0x55, 0x5c, 0x63, 0x6a, 0x71, 0x78, 0x7f, 0x86, 0x8d, 0x94, 0x9b, 0xa2,
+    0xa9, 0xb0, 0xb7, 0xbe, 0xc5, 0xcc, 0xd3, 0xda, 0xe1, 0xe8, 0xef, 0xf6,
+    0xfd, 0x04, 0x0b, 0x12, 0x19, 0x20, 0x27, 0x2e, 0x35, 0x3c, 0x43, 0x4a,
+    0x51, 0x58, 0x5f, 0x66, 0x6d, 0x74, 0x7b, 0x82, 0x89, 0x90, 0x97, 0x9e,
+    0xa5, 0xac, 0xb3, 0xba
+};
+
+static uint8_t const mlkem768_encaps_seed[] PROGMEM = {
+    0xfe, 0xfb, 0xf8, 0xf5, 0xf2, 0xef, 0xec, 0xe9, 0xe6, 0xe3, 0xe0, 0xdd,
+    0xda, 0xd7, 0xd4, 0xd1, 0xce, 0xcb, 0xc8, 0xc5, 0xc2, 0xbf, 0xbc, 0xb9,
+    0xb6, 0xb3, 0xb0, 0xad, 0xaa, 0xa7, 0xa4, 0xa1
+};
+
+static uint8_t const mlkem768_public[] PROGMEM = {
+    0x7b, 0x01, 0x85, 0x73, 0x94, 0x42, 0x61, 0xf2, 0x7d, 0x43, 0x82, 0x08,
+    0x7e, 0x11, 0x5c, 0x4a, 0x2a, 0xa3, 0x8e, 0x48, 0x3c, 0x96, 0xe4, 0x5a,
+    0x3b, 0xd7, 0x84, 0x6e, 0x6c, 0x35, 0xf4, 0x39, 0x67, 0xea, 0x16, 0x5b,
+    0x7b, 0x52, 0x40, 0x19, 0x58, 0x2d, 0x48, 0xb4, 0xab, 0x45, 0xda, 0xa1,
+    0x17, 0x3c, 0x6d, 0x03, 0x50, 0x1b, 0x50, 0x16, 0x8a, 0x1a, 0x42, 0x1e,
+    0x45, 0x31, 0x39, 0xc9, 0x87, 0x0a, 0x36, 0xdb, 0xa9, 0xcb, 0xe2, 0xcb,
+    0x8e, 0xc5, 0x47, 0x55, 0x44, 0xa7, 0x1c, 0xc7, 0x68, 0x29, 0x71, 0xa0,
+    0x18, 0xc0, 0x83, 0x06, 0xd6, 0x02, 0x31, 0x8c, 0x3c, 0x80, 0xd0, 0x60,
+    0xe1, 0xa6, 0x90, 0x43, 0xb3, 0xb1, 0xd2, 0xac, 0x98, 0xe0, 0x81, 0xb7,
+    0x23, 0x5a, 0x7b, 0x8a, 0x59, 0x57, 0x4d, 0xe0, 0x7b, 0x82, 0xe2, 0xbb,
+    0x63, 0x0a, 0x8c, 0x10, 0x08, 0x70, 0xda, 0xd2, 0x79, 0x41, 0x44, 0xc2,
+    0x2e, 0x94, 0xb3, 0x41, 0x12, 0x5b, 0xaa, 0xd2, 0x67, 0x40, 0x64, 0xb1,
+    0x65, 0x97, 0x2f, 0xad, 0xb7, 0x40, 0x25, 0x44, 0x7c, 0x5d, 0x63, 0x8d,
+    0x40, 0x22, 0x0b, 0x1b, 0x08, 0x47, 0x80, 0x31, 0x03, 0xea, 0xe0, 0xc5,
+    0x9a, 0x09, 0x1d, 0xf2, 0xd1, 0xc6, 0xc8, 0xd3, 0x21, 0x6a, 0xdc, 0x2c,
+    0x98, 0x19, 0x2d, 0x14, 0x07, 0x53, 0xbf, 0x41, 0x69, 0xa7, 0xe3, 0x7e,
+    0xca, 0x94, 0xb4, 0x6d, 0x61, 0xcd, 0x88, 0xd0, 0xb5, 0xd2, 0xd0, 0x68,
+    0xe1, 0xc0, 0xc9, 0x31, 0x51, 0xbd, 0xc4, 0x52, 0x0d, 0xd4, 0x2a, 0x10,
+    0x62, 0x54, 0x37, 0x5e, 0x96, 0x63, 0x45, 0xd2, 0x47, 0x04, 0xc4, 0xb4,
+    0x7f, 0x8a, 0xce, 0x89, 0x57, 0xab, 0x93, 0x21, 0x77, 0x93, 0xb5, 0x21,
+    0xf3, 0x60, 0x35, 0x46, 0x7a, 0x6e, 0x26, 0x32, 0x55, 0xd1, 0xe1, 0x80,
+    0x2c, 0x73, 0x9d, 0xbd, 0xcb, 0x33, 0x04, 0x33, 0xc4, 0x7d, 0x44, 0x80,
+    0x3c, 0x3b, 0x9c, 0x61, 0x39, 0x04, 0x49, 0xd3, 0x85, 0xdc, 0x2a, 0x8a,
+    0x99, 0x13, 0xa5, 0x7a, 0x12, 0x07, 0xa7, 0x35, 0x7c, 0x64, 0x57, 0x8d,
+    0xa5, 0x07, 0xcf, 0x1b, 0x8c, 0x4b, 0xaf, 0xd0, 0xc3, 0xb0, 0xbb, 0x26,
+    0x50, 0xd4, 0xc0, 0xff, 0x66, 0x7d, 0xf8, 0xb0, 0x81, 0xfe, 0x82, 0x4e,
+    0x48, 0xbb, 0xc7, 0x0f, 0xab, 0x4b, 0x18, 0x39, 0x9e, 0x5d, 0x40, 0x2b,
+    0x54, 0xf1, 0x6d, 0x24, 0xdc, 0xc5, 0x8f, 0x39, 0xa5, 0x3a, 0xa9, 0x4d,
+    0xfc, 0x40, 0x65, 0x79, 0xcc, 0xb3, 0x74, 0xb5, 0xa4, 0x91, 0x8c, 0xc5,
+    0xe6, 0xf9, 0x9e, 0xc2, 0xa2, 0x4f, 0x5d, 0x68, 0x05, 0xad, 0x61, 0x06,
+    0x6e, 0x05, 0x20, 0x8e, 0x23, 0x8c, 0x69, 0x35, 0xcb, 0x4b, 0xf3, 0x7f,
+    0xb5, 0x27, 0xa0, 0x24, 0x5c, 0x04, 0x98, 0x77, 0x0c, 0x62, 0x43, 0x82,
+    0x26, 0xd1, 0x5a, 0x7f, 0x95, 0xc2, 0x44, 0xa8, 0x99, 0x16, 0xb0, 0xa1,
+    0x2a, 0xe0, 0x0d, 0xeb, 0x66, 0x91, 0x34, 0x75, 0x0e, 0xa2, 0xa4, 0x86,
+    0xc8, 0x30, 0x28, 0x8f, 0x0b, 0x2e, 0xc4, 0x62, 0x80, 0xae, 0x92, 0x0f,
+    0xef, 0x0b, 0xc2, 0x80, 0x33, 0x03, 0x0d, 0xa9, 0x01, 0xc1, 0x75, 0x65,
+    0xaa, 0x9b, 0x57, 0x55, 0x85, 0x78, 0x8d, 0x08, 0xa0, 0x48, 0xd3, 0x2d,
+    0x18, 0x4c, 0xcc, 0x22, 0xf4, 0x53, 0x7a, 0xa0, 0x0c, 0xb8, 0x25, 0x8d,
+    0x17, 0x27, 0x73, 0x69, 0xc7, 0x2a, 0xe6, 0x80, 0x9d, 0xd9, 0x16, 0x50,
+    0xac, 0xf0, 0xb6, 0x85, 0xcb, 0x09, 0xf4, 0xab, 0xb7, 0xe7, 0xb5, 0x2b,
+    0xa3, 0x4c, 0xc1, 0x93, 0xb5, 0x07, 0x08, 0x3c, 0x03, 0xc5, 0x05, 0x1d,
+    0x69, 0xa3, 0x57, 0xcf, 0x8b, 0xb8, 0xe5, 0xe9, 0x61, 0x1c, 0xea, 0xb5,
+    0xad, 0xbb, 0x8f, 0xb2, 0x81, 0xc6, 0x3d, 0x99, 0x69, 0x94, 0x1c, 0x8b,
+    0xca, 0x95, 0x23, 0xe4, 0xa6, 0x5c, 0x06, 0x57, 0x41, 0x92, 0x5b, 0x19,
+    0x88, 0x34, 0xbc, 0x7a, 0x73, 0x5c, 0x8a, 0x81, 0x07, 0x46, 0x4c, 0xbf,
+    0xf8, 0xfa, 0x23, 0x7a, 0xc1, 0x1a, 0x7f, 0x6a, 0x07, 0x73, 0x54, 0x06,
+    0xd9, 0xb7, 0xa9, 0x94, 0xe5, 0x8b, 0x26, 0x52, 0xb8, 0xab, 0x62, 0x73,
+    0x7b, 0x88, 0x65, 0x78, 0x22, 0xa9, 0x6a, 0x39, 0x1e, 0xe9, 0xd9, 0x6e,
+    0x21, 0x2b, 0x94, 0xe1, 0x04, 0x1b, 0x33, 0xf7, 0xc0, 0x98, 0x2c, 0x38,
+    0x0e, 0x64, 0x6b, 0xcb, 0xd3, 0x75, 0x0e, 0xf5, 0xa0, 0x56, 0xd4, 0x9c,
+    0x40, 0xc5, 0xc5, 0xa7, 0x85, 0x49, 0x87, 0xa7, 0x34, 0xb5, 0x24, 0xcb,
+    0x73, 0x75, 0x5e, 0x64, 0xcc, 0x6c, 0x50, 0x2b, 0x77, 0xa1, 0x34, 0xa3,
+    0xa7, 0x50, 0x0d, 0x80, 0xc4, 0x50, 0x1c, 0x5a, 0x33, 0xcb, 0xf0, 0x93,
+    0xb1, 0xa1, 0xa1, 0xce, 0x7c, 0x9d, 0xdf, 0x02, 0x8d, 0xe1, 0x87, 0x28,
+    0x11, 0x5c, 0xbf, 0x70, 0xd5, 0x0b, 0xf6, 0x09, 0x0e, 0x64, 0x3c, 0x15,
+    0x0c, 0x95, 0x3a, 0xff, 0xd1, 0x21, 0x1b, 0x74, 0x48, 0x93, 0x64, 0x15,
+    0x44, 0xe5, 0xb5, 0x10, 0xc0, 0x1c, 0x71, 0x56, 0x22, 0xe4, 0x9a, 0x54,
+    0x94, 0x3c, 0xad, 0x84, 0xa9, 0x9e, 0x8b, 0xd0, 0x62, 0xfe, 0x8b, 0x82,
+    0x4a, 0xa0, 0x72, 0x8d, 0xd7, 0x6e, 0x81, 0xab, 0x3e, 0x0e, 0x84, 0xbc,
+    0x50, 0x30, 0x82, 0xf4, 0x8c, 0x60, 0x65, 0x72, 0x5f, 0xb4, 0x3b, 0x46,
+    0x3b, 0xdb, 0x75, 0x14, 0x78, 0x4c, 0xad, 0xc5, 0x4d, 0x86, 0xc8, 0x67,
+    0xab, 0x5c, 0x2d, 0x86, 0x77, 0x01, 0x57, 0x01, 0x85, 0x8e, 0xbb, 0x9b,
+    0x01, 0x79, 0x71, 0xe6, 0x38, 0x37, 0x56, 0xf6, 0x9c, 0xf6, 0xd9, 0x3f,
+    0xc9, 0x04, 0x2c, 0x5d, 0xf0, 0xcf, 0xb5, 0x2c, 0xbb, 0xf1, 0xdc, 0x6b,
+    0x7f, 0xb9, 0x54, 0x94, 0x8b, 0xc0, 0x83, 0x33, 0xc2, 0xc5, 0x44, 0x4a,
+    0xd2, 0x56, 0x94, 0xa6, 0x43, 0x00, 0x59, 0x47, 0x1b, 0x2d, 0x66, 0x2e,
+    0x23, 0x59, 0xb1, 0x38, 0xd1, 0x6c, 0x59, 0x94, 0x55, 0x67, 0xcb, 0x5b,
+    0x79, 0xd7, 0x02, 0xe9, 0xa2, 0x1b, 0xc0, 0x18, 0x72, 0x1c, 0x29, 0x07,
+    0x31, 0x5c, 0x33, 0xdb, 0x80, 0xa3, 0xeb, 0x2a, 0x80, 0xa0, 0x34, 0x48,
+    0x09, 0x71, 0xb0, 0x00, 0x87, 0x40, 0xdc, 0x86, 0x8c, 0xae, 0x28, 0x24,
+    0x76, 0xf0, 0x5a, 0x2a, 0x64, 0x24, 0x71, 0x01, 0x46, 0xe7, 0x2a, 0xa7,
+    0xef, 0x91, 0x16, 0xc3, 0xe6, 0x6e, 0xb6, 0x2c, 0x90, 0xaa, 0x61, 0x3f,
+    0xe0, 0x19, 0xa2, 0x57, 0x8b, 0x05, 0x50, 0x53, 0x48, 0x2d, 0xcb, 0x80,
+    0xc3, 0x2b, 0xa6, 0xcb, 0x84, 0x68, 0xbc, 0x34, 0xb5, 0x0e, 0x76, 0x23,
+    0x69, 0x86, 0x9b, 0xb9, 0xdb, 0xbb, 0xc5, 0x57, 0x4d, 0xea, 0x6b, 0x44,
+    0x77, 0x62, 0x30, 0x8d, 0x70, 0x0c, 0xff, 0x9a, 0x12, 0x15, 0x90, 0xaa,
+    0x4f, 0x10, 0xac, 0x80, 0xeb, 0x81, 0x98, 0x16, 0x0e, 0xd9, 0xda, 0x88,
+    0x38, 0x00, 0x3b, 0xea, 0x2a, 0x78, 0x82, 0x1a, 0xcb, 0xd7, 0xdb, 0x13,
+    0x3b, 0xa4, 0x8b, 0x28, 0x48, 0x6e, 0x98, 0x61, 0x83, 0x0c, 0x7a, 0x55,
+    0x0a, 0xe1, 0x0e, 0xc3, 0x46, 0x71, 0x15, 0x5a, 0xb0, 0x27, 0xd7, 0x06,
+    0xd1, 0x13, 0x08, 0xa4, 0x5a, 0xac, 0xa3, 0x99, 0x77, 0xea, 0xe6, 0x89,
+    0xaf, 0x42, 0x16, 0x4b, 0xfb, 0x29, 0x5b, 0x1c, 0x8d, 0x90, 0xa1, 0x04,
+    0xfb, 0x5b, 0xb6, 0x60, 0x27, 0x0e, 0x52, 0x1a, 0x1d, 0x3b, 0x38, 0xaa,
+    0x87, 0x45, 0x82, 0x1c, 0xf8, 0xca, 0xbd, 0x95, 0xb6, 0x09, 0x04, 0x10,
+    0x27, 0x2a, 0xc6, 0x3c, 0x71, 0x74, 0x29, 0xf6, 0x9c, 0x34, 0x23, 0x87,
+    0x5b, 0x31, 0x2f, 0x6f, 0xcc, 0xaa, 0x59, 0x63, 0x42, 0xfa, 0x63, 0x2f,
+    0xe2, 0x9b, 0x9f, 0xd2, 0x1a, 0x90, 0x2d, 0x78, 0x61, 0x1c, 0x57, 0x2b,
+    0x18, 0x21, 0x73, 0xa5, 0x35, 0x77, 0xa1, 0x54, 0xc3, 0x3c, 0xa7, 0x2c,
+    0x6c, 0xf1, 0x24, 0x0b, 0x47, 0xc7, 0x89, 0x7b, 0x80, 0x81, 0xeb, 0xb1,
+    0x17, 0xf0, 0x9f, 0x1d, 0xcb, 0xbf, 0x46, 0x59, 0x9c, 0xe5, 0x34, 0xc2,
+    0x96, 0xf8, 0x23, 0x70, 0x5a, 0x9a, 0xcf, 0x56, 0x58, 0xa0, 0x26, 0x35,
+    0xda, 0xdc, 0x01, 0x6b, 0x64, 0x13, 0x57, 0x68, 0x2d, 0x25, 0x69, 0x09,
+    0x3e, 0x21, 0x6e, 0xe9, 0x68, 0x3a, 0x85, 0x0a, 0x5d, 0x93, 0x15, 0x25,
+    0x3b, 0xb2, 0x66, 0x4b, 0x27, 0x2a, 0x48, 0x4c, 0x79, 0xd4, 0x64, 0xcc,
+    0xc0, 0xd3, 0x9c, 0x80, 0xc4, 0x4d, 0x2e, 0x14, 0x5f, 0xf0, 0xc4, 0x11,
+    0xe9, 0x17, 0xaa, 0xff, 0xbc, 0x8d, 0xe1, 0xe8, 0x84, 0x34, 0x6a, 0x33,
+    0xd7, 0xa1, 0x7c, 0x5a, 0x2d, 0xdc, 0x28, 0xe0, 0x9d, 0x21, 0x4e, 0x32,
+    0x03, 0xe9, 0x52, 0xa7, 0x0f, 0x81, 0xcb, 0xd1, 0xe4, 0xfd, 0x2c, 0x14,
+    0xa5, 0xb7, 0x65, 0x0c, 0x24, 0xbe, 0x2f, 0x29
+};
+
+static uint8_t const mlkem768_ciphertext[] PROGMEM = {
+    0x68, 0x75, 0x5a, 0xc8, 0x25, 0xba, 0x4c, 0xc3, 0x5e, 0x3f, 0x4f, 0x96,
+    0xa0, 0x79, 0xb7, 0x49, 0xb7, 0x2c, 0xac, 0xa9, 0x56, 0x17, 0x76, 0x29,
+    0xb6, 0x7d, 0x08, 0x3d, 0x2c, 0x21, 0x75, 0x17, 0x19, 0x1e, 0xcd, 0xd2,
+    0x32, 0xc5, 0xd5, 0xd2, 0xda, 0xca, 0x01, 0x56, 0x34, 0x5e, 0x75, 0x3a,
+    0x02, 0x0e, 0xef, 0xea, 0xbe, 0x81, 0xa2, 0x77, 0xe6, 0x85, 0xa7, 0xb3,
+    0xf3, 0xcf, 0x0c, 0x8f, 0x0d, 0x8c, 0xbd, 0x8e, 0x8a, 0xbc, 0x17, 0x91,
+    0x26, 0x9e, 0xfa, 0x12, 0x6d, 0xff, 0x8c, 0xb6, 0xc1, 0x23, 0x0d, 0xa9,
+    0xd1, 0x03, 0x2c, 0xdb, 0x6e, 0x8c, 0x0a, 0xf8, 0x6f, 0x56, 0xe4, 0x8d,
+    0x70, 0x6f, 0xd3, 0x25, 0x5a, 0x64, 0x68, 0x98, 0x75, 0x65, 0xf7, 0x48,
+    0x06, 0xb3, 0xf6, 0xb0, 0x16, 0xa6, 0x07, 0xaa, 0xec, 0x8e, 0x87, 0x70,
+    0xeb, 0xe3, 0xf0, 0x83, 0xd3, 0xc2, 0xec, 0x30, 0xd0, 0xb1, 0x87, 0xef,
+    0xec, 0x24, 0x5c, 0x1a, 0xb8, 0x64, 0x0e, 0x58, 0x41, 0xc4, 0xda, 0x13,
+    0x89, 0xb2, 0x32, 0x2e, 0xc6, 0xf8, 0xa1, 0xb9, 0x63, 0xac, 0x5a, 0x79,
+    0x0b, 0x22, 0xb5, 0x00, 0x2d, 0xb9, 0x25, 0x88, 0x72, 0xd8, 0x7d, 0xe1,
+    0x3a, 0x15, 0x97, 0xf2, 0xf8, 0x50, 0xc6, 0xb9, 0xec, 0x47, 0xd4, 0xbe,
+    0x0e, 0x6a, 0x10, 0xb7, 0x07, 0x6e, 0x78, 0x2e, 0x46, 0xff, 0xdd, 0x58,
+    0x41, 0x97, 0x77, 0x27, 0xdf, 0x60, 0x84, 0xef, 0xd4, 0x82, 0xca, 0x5e,
+    0x13, 0x1a, 0x0b, 0x1f, 0x8c, 0xfc, 0xd6, 0x1b, 0x15, 0x3f, 0x72, 0x0f,
+    0x93, 0x17, 0x84, 0x00, 0x87, 0x98, 0xd9, 0xf3, 0x4e, 0xb5, 0xb1, 0xee,
+    0x14, 0xff, 0x19, 0x93, 0x12, 0x35, 0x6f, 0xc4, 0x01, 0xdb, 0x8d, 0xf9,
+    0x96, 0x7e, 0xb5, 0x14, 0x21, 0xc4, 0x18, 0xdb, 0xdd, 0xaf, 0x4c, 0x5e,
+    0x9d, 0x56, 0x98, 0x90, 0xbf, 0x9d, 0x09, 0x5b, 0x2b, 0x32, 0xbc, 0xeb,
+    0x9c, 0xf4, 0x4a, 0x28, 0x2b, 0x1a, 0xe0, 0x79, 0xeb, 0x14, 0x8c, 0x1d,
+    0xd1, 0x59, 0xd1, 0xfc, 0xca, 0xe4, 0xf0, 0xac, 0x8a, 0x5d, 0x55, 0x69,
+    0x55, 0x55, 0x64, 0x40, 0x51, 0x23, 0xe4, 0x1a, 0xf2, 0xe4, 0xcc, 0x60,
+    0x7b, 0x0c, 0x83, 0x9b, 0xcf, 0x6e, 0x42, 0x4f, 0x9d, 0x5f, 0x04, 0x8a,
+    0x3a, 0xd2, 0x20, 0x45, 0x42, 0xd8, 0xea, 0xa1, 0x68, 0x60, 0xe6, 0xfe,
+    0x61, 0xdd, 0x98, 0x54, 0xd2, 0x21, 0xb2, 0xfe, 0x40, 0x84, 0xe3, 0x0a,
+    0x20, 0x18, 0x22, 0xd4, 0x85, 0xd7, 0xf4, 0xe2, 0x3d, 0x02, 0xf3, 0xbb,
+    0x2f, 0xa6, 0x98, 0xf0, 0xee, 0x41, 0xa0, 0x72, 0xb4, 0xa4, 0xc3, 0x86,
+    0x8f, 0x69, 0xb8, 0xf6, 0x27, 0xc9, 0x7d, 0xfe, 0x2b, 0xb6, 0x52, 0x0c,
+    0xf9, 0xe6, 0xf0, 0x02, 0x23, 0xb1, 0x0e, 0x10, 0xbb, 0x5f, 0x22, 0x57,
+    0xa2, 0x66, 0xa9, 0x94, 0xde, 0x6d, 0x83, 0x34, 0xde, 0x39, 0x71, 0x93,
+    0xd4, 0xb0, 0x0c, 0x6b, 0xf9, 0x72, 0x75, 0x28, 0x2b, 0x01, 0x14, 0x3e,
+    0xc5, 0xcf, 0xe8, 0x57, 0x11, 0x7f, 0x3d, 0x31, 0x65, 0x80, 0x5e, 0x73,
+    0xe0, 0xfe, 0x67, 0x05, 0x30, 0xea, 0xb5, 0xcd, 0x87, 0x8c, 0x7c, 0x23,
+    0x9a, 0xeb, 0x0c, 0x46, 0xbc, 0x01, 0xd3, 0xdb, 0x99, 0xb0, 0x7a, 0x68,
+    0x86, 0xdc, 0xeb, 0xf5, 0xb2, 0x48, 0x28, 0x8e, 0x88, 0xd6, 0xdc, 0xfb,
+    0x1b, 0x3e, 0x36, 0xd3, 0xa0, 0x39, 0xcc, 0x6a, 0xaf, 0x1f, 0x65, 0x8b,
+    0xb5, 0x8f, 0x5a, 0x8d, 0x7d, 0x30, 0x55, 0x8d, 0x55, 0xf3, 0x34, 0x79,
+    0x30, 0xcc, 0x54, 0x23, 0x80, 0x8a, 0x6d, 0x73, 0x70, 0xae, 0xf5, 0xc2,
+    0x87, 0xb5, 0x07, 0x60, 0x1d, 0xfa, 0xbe, 0x10, 0xbd, 0xbf, 0x0d, 0xf3,
+    0x30, 0x60, 0x4f, 0xbd, 0xc5, 0x58, 0xf4, 0x64, 0x15, 0xca, 0x89, 0x06,
+    0x82, 0xa8, 0xe3, 0x13, 0xcf, 0x62, 0x9f, 0x13, 0x4a, 0x62, 0x65, 0x32,
+    0x29, 0x12, 0xf2, 0x7d, 0xc0, 0xab, 0xf0, 0x79, 0x1c, 0x44, 0xe6, 0xfb,
+    0xcb, 0xb8, 0x68, 0x99, 0x0b, 0x87, 0x0f, 0x3d, 0xdd, 0x68, 0x6a, 0xc6,
+    0x05, 0x1b, 0x70, 0x6a, 0x2b, 0x51, 0xf9, 0x69, 0x24, 0xe1, 0xd6, 0x82,
+    0xca, 0x07, 0x72, 0x7e, 0xab, 0x52, 0x5c, 0x51, 0xd5, 0x62, 0xc5, 0xb7,
+    0xfb, 0x38, 0xd2, 0xfd, 0xb3, 0xcb, 0x9b, 0x45, 0x8b, 0x34, 0x6e, 0x11,
+    0x6e, 0x4a, 0xd8, 0x3c, 0x3d, 0x05, 0x3d, 0xb1, 0x10, 0x51, 0xe0, 0xd8,
+    0xd5, 0xf7, 0xef, 0x80, 0x6f, 0xe4, 0xbd, 0xe0, 0x97, 0xa4, 0xd9, 0x05,
+    0x2d, 0x30, 0x92, 0xbb, 0x36, 0x86, 0x78, 0xe9, 0x04, 0x3f, 0xa4, 0xeb,
+    0xc2, 0xdd, 0x90, 0x12, 0x57, 0x5e, 0x31, 0x7e, 0xcb, 0x4d, 0x7f, 0xce,
+    0xe1, 0x0e, 0x91, 0x53, 0x99, 0x7e, 0x0c, 0xb6, 0xcd, 0xa4, 0x9d, 0x20,
+    0x0f, 0xa0, 0x5f, 0x0a, 0x36, 0xe9, 0xfd, 0xb9, 0xef, 0x0d, 0x56, 0xf5,
+    0x72, 0xcd, 0xfd, 0x75, 0x19, 0xd1, 0x3f, 0x4a, 0xc1, 0xd5, 0x31, 0x56,
+    0xc5, 0x6c, 0xf4, 0xc3, 0xf3, 0x81, 0x2b, 0x0f, 0xea, 0x00, 0xba, 0x96,
+    0xfa, 0x50, 0x82, 0x58, 0x08, 0xd7, 0x32, 0x37, 0xe3, 0xd1, 0x90, 0xb4,
+    0x19, 0xff, 0x70, 0x10, 0xbd, 0xbc, 0x3d, 0x4c, 0x3d, 0x04, 0x14, 0x6f,
+    0x08, 0x76, 0xf6, 0xfd, 0xba, 0x8a, 0x04, 0x5e, 0x52, 0xb8, 0xbe, 0x81,
+    0x3d, 0x71, 0x44, 0xdc, 0xa9, 0xbd, 0x61, 0xd7, 0xba, 0x13, 0xfd, 0xb4,
+    0x57, 0x69, 0xd5, 0x88, 0xcd, 0x9c, 0x9d, 0xb8, 0x4d, 0xd7, 0x13, 0x47,
+    0x66, 0xce, 0xa3, 0xdb, 0xb3, 0x37, 0x3e, 0xb6, 0x2b, 0xaa, 0x9d, 0x65,
+    0x9e, 0xd6, 0x19, 0xcd, 0x80, 0xd8, 0x78, 0x95, 0xea, 0xad, 0x33, 0xed,
+    0x8a, 0x1b, 0xc3, 0x69, 0xf3, 0x64, 0xfe, 0x11, 0xb7, 0xa1, 0x20, 0xee,
+    0x23, 0xe4, 0x0f, 0x41, 0x27, 0x41, 0x63, 0x03, 0x18, 0xc1, 0xd8, 0x67,
+    0xf7, 0x8c, 0x3a, 0xfa, 0x89, 0x06, 0xd9, 0x4d, 0xe3, 0xec, 0x25, 0x85,
+    0xaa, 0xd3, 0x82, 0xa2, 0x3b, 0x8f, 0xa2, 0xa0, 0x1e, 0x41, 0xd4, 0xf1,
+    0x81, 0x78, 0x4c, 0x19, 0xb5, 0xdc, 0x93, 0x93, 0x06, 0x8c, 0xdd, 0xcf,
+    0xea, 0x6d, 0x50, 0x34, 0x65, 0x02, 0x96, 0xd9, 0x42, 0x55, 0x58, 0x2e,
+    0x64, 0x65, 0x54, 0x0d, 0x02, 0x05, 0x80, 0x5d, 0x3f, 0x5f, 0xc3, 0x2b,
+    0x1a, 0xc5, 0xc7, 0x90, 0x6a, 0x8d, 0xe3, 0xbf, 0xf7, 0x6f, 0xdb, 0x4d,
+    0x7b, 0x4e, 0xd8, 0x7e, 0x3f, 0xdd, 0x3b, 0x08, 0xaf, 0x90, 0x51, 0x38,
+    0x82, 0xec, 0x92, 0xac, 0x3b, 0x92, 0x4e, 0x56, 0x08, 0xf3, 0xdc, 0xd4,
+    0x7e, 0xbb, 0xcc, 0x27, 0x44, 0x84, 0x0b, 0xd0, 0xd7, 0x34, 0xf1, 0xcb,
+    0xaf, 0x81, 0x19, 0x86, 0xd9, 0x93, 0x8e, 0x64, 0x40, 0xfe, 0x2e, 0xb0,
+    0x1b, 0xd4, 0x08, 0x5b, 0x87, 0x25, 0xa3, 0x27, 0xf6, 0x76, 0x02, 0x0e,
+    0x72, 0x59, 0x29, 0xb3, 0x23, 0x7b, 0xf3, 0xe2, 0xfe, 0x54, 0x7d, 0x9e,
+    0x5e, 0x77, 0x04, 0x52, 0x6c, 0xee, 0xcc, 0xb3, 0x05, 0xe9, 0xd9, 0x5e,
+    0xcf, 0x00, 0x3e, 0x6d, 0xf7, 0x27, 0x4a, 0xdb, 0x71, 0xc2, 0xcc, 0x94,
+    0xe2, 0x9d, 0x8d, 0xf7, 0x8c, 0xcd, 0xc4, 0x4a, 0xaa, 0x03, 0x25, 0xcf,
+    0x2e, 0xa0, 0x95, 0x07, 0x3d, 0x24, 0x33, 0x44, 0x37, 0x36, 0x32, 0xbc,
+    0x47, 0x1d, 0xf7, 0xc2, 0x9a, 0xf6, 0xb0, 0x5d, 0x95, 0xcb, 0x54, 0x8b,
+    0xe9, 0xb2, 0x91, 0x84, 0x1a, 0x34, 0xb0, 0x9d, 0x5f, 0xd4, 0x7a, 0x70,
+    0x11, 0x76, 0x9d, 0x9e, 0x8b, 0x39, 0x10, 0x83, 0xc0, 0x42, 0xb8, 0x06,
+    0xaf, 0x12, 0x9b, 0xd4, 0x26, 0x82, 0x06, 0x7b, 0xed, 0xf4, 0x66, 0x4f,
+    0xda, 0x65, 0xb6, 0x2a, 0x3d, 0x92, 0x5d, 0xc4, 0xea, 0x4f, 0x26, 0x03,
+    0x9e, 0xa0, 0x99, 0xca, 0x5d, 0x57, 0xc6, 0xef, 0xe0, 0x80, 0x56, 0x5f,
+    0x19, 0x61, 0x16, 0xb4, 0x18, 0x66, 0x41, 0xfb, 0xc3, 0x14, 0xa5, 0x0e,
+    0xd0, 0x60, 0xdf, 0xaf, 0x1a, 0xd6, 0x50, 0xfd, 0x07, 0x47, 0x75, 0x92,
+    0x73, 0xfc, 0xa7, 0x0a, 0x48, 0x13, 0x36, 0x69
+};
+
+static uint8_t const mlkem768_shared[] PROGMEM = {
+    0xdd, 0xdc, 0xd3, 0x30, 0x9b, 0x3f, 0xd1, 0xc0, 0xdf, 0x95, 0x27, 0x1f,
+    0x4f, 0xbc, 0x87, 0xe6, 0xd8, 0xef, 0xa6, 0xd8, 0x35, 0xaf, 0xbd, 0x1c,
+    0xd5, 0x2e, 0x07, 0x5f, 0xa8, 0xbf, 0xde, 0x8c
+};
+
+static uint8_t const mlkem768_rejected[] PROGMEM = {
+    0x46, 0x9c, 0x5e, 0x2b, 0x07, 0x72, 0xec, 0x07, 0x17, 0xdb, 0x9c, 0x89,
+    0xa3, 0x08, 0x19, 0xe2, 0x50, 0x8d, 0xac, 0x92, 0x35, 0x66, 0xf9, 0x6c,
+    0x37, 0xc0, 0xfe, 0x5e, 0x95, 0x6d, 0x0a, 0x2a
+};
+
+struct TestVector
+{
+    const char *name;
+    MLKEM::Variant variant;
+    const uint8_t *keygen_seed;
+    const uint8_t *encaps_seed;
+    const uint8_t *public_key;
+    const uint8_t *ciphertext;
+    const uint8_t *shared;
+    const uint8_t *rejected;
+};
+
+static TestVector const testVectorMLKEM512 = {
+    "ML-KEM-512",
+    MLKEM::MLKEM512,
+    mlkem512_keygen_seed,
+    mlkem512_encaps_seed,
+    mlkem512_public,
+    mlkem512_ciphertext,
+    mlkem512_shared,
+    mlkem512_rejected
+};
+
+static TestVector const testVectorMLKEM768 = {
+    "ML-KEM-768",
+    MLKEM::MLKEM768,
+    mlkem768_keygen_seed,
+    mlkem768_encaps_seed,
+    mlkem768_public,
+    mlkem768_ciphertext,
+    mlkem768_shared,
+    mlkem768_rejected
+};
+
+uint8_t public_key[MLKEM768_PUBLICKEYBYTES];
+uint8_t private_key[MLKEM768_PRIVATEKEYBYTES];
+uint8_t ciphertext[MLKEM768_CIPHERTEXTBYTES];
+uint8_t random_data[64];
+uint8_t shared_a[MLKEM_SHAREDBYTES];
+uint8_t shared_b[MLKEM_SHAREDBYTES];
+
+void testMLKEMFixed(const struct TestVector *test)
+{
+    unsigned long start;
+    unsigned long elapsed;
+    size_t pklen = MLKEM::publicKeySize(test->variant);
+    size_t ctlen = MLKEM::ciphertextSize(test->variant);
+
+    Serial.print(test->name);
+    Serial.println(":");
+
+    Serial.print("keygen ... ");
+    memcpy_P(random_data, test->keygen_seed, 64);
+    start = micros();
+    MLKEM::keygen(public_key, private_key, test->variant, random_data);
+    elapsed = micros() - start;
+    if (memcmp_P(public_key, test->public_key, pklen) == 0)
+        Serial.print("ok ... ");
+    else
+        Serial.print("fail ... ");
+    Serial.print(elapsed);
+    Serial.println(" us");
+
+    Serial.print("encaps ... ");
+    memcpy_P(random_data, test->encaps_seed, 32);
+    start = micros();
+    bool ok = MLKEM::encaps(shared_b, ciphertext, public_key,
+                            test->variant, random_data);
+    elapsed = micros() - start;
+    if (!ok) {
+        Serial.print("public key fail ... ");
+    } else {
+        if (memcmp_P(ciphertext, test->ciphertext, ctlen) != 0) {
+            Serial.print("ciphertext fail ... ");
+            ok = false;
+        }
+        if (memcmp_P(shared_b, test->shared, MLKEM_SHAREDBYTES) != 0) {
+            Serial.print("shared fail ... ");
+            ok = false;
+        }
+    }
+    if (ok)
+        Serial.print("ok ... ");
+    Serial.print(elapsed);
+    Serial.println(" us");
+
+    Serial.print("decaps ... ");
+    start = micros();
+    ok = MLKEM::decaps(shared_a, ciphertext, private_key, test->variant);
+    elapsed = micros() - start;
+    if (ok && memcmp_P(shared_a, test->shared, MLKEM_SHAREDBYTES) == 0)
+        Serial.print("ok ... ");
+    else
+        Serial.print("fail ... ");
+    Serial.print(elapsed);
+    Serial.println(" us");
+
+    Serial.print("decaps rejected ... ");
+    ciphertext[5] ^= 0x10;
+    ok = MLKEM::decaps(shared_a, ciphertext, private_key, test->variant);
+    if (ok && memcmp_P(shared_a, test->rejected, MLKEM_SHAREDBYTES) == 0)
+        Serial.println("ok");
+    else
+        Serial.println("fail");
+
+    Serial.print("bad public key ... ");
+    public_key[0] = 0xFF;
+    public_key[1] |= 0x0F;
+    if (!MLKEM::encaps(shared_b, ciphertext, public_key, test->variant))
+        Serial.println("ok");
+    else
+        Serial.println("fail");
+
+    Serial.println();
+}
+
+void testMLKEMRandom(MLKEM::Variant variant)
+{
+    Serial.print("random key exchange ... ");
+    MLKEM::keygen(public_key, private_key, variant);
+    bool ok = MLKEM::encaps(shared_b, ciphertext, public_key, variant);
+    if (ok)
+        ok = MLKEM::decaps(shared_a, ciphertext, private_key, variant);
+    if (ok && memcmp(shared_a, shared_b, MLKEM_SHAREDBYTES) == 0)
+        Serial.println("ok");
+    else
+        Serial.println("fail");
+}
+
+void setup()
+{
+    Serial.begin(9600);
+
+    // Start the random number generator.  We don't initialise a noise
+    // source here because we don't need one for testing purposes.
+    // Real applications should of course use a proper noise source.
+    RNG.begin("TestMLKEM 1.0");
+
+    // Perform the tests.
+    Serial.println();
+    testMLKEMFixed(&testVectorMLKEM512);
+    testMLKEMRandom(MLKEM::MLKEM512);
+    Serial.println();
+    testMLKEMFixed(&testVectorMLKEM768);
+    testMLKEMRandom(MLKEM::MLKEM768);
+}
+
+void loop()
+{
+}
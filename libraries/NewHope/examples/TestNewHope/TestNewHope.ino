@@ -27,6 +27,7 @@ This example runs tests on the NewHope class to verify correct behaviour.
 #include <Crypto.h>
 #include <NewHope.h>
 #include <RNG.h>
+#include <SHA256.h>
 #include <string.h>
 #if defined(ESP8266) || defined(ESP32)
 #include <pgmspace.h>
@@ -739,6 +740,15 @@ static uint8_t const shared_secret_torref[] PROGMEM = {
     0x3c, 0xfb, 0x28, 0xcc, 0xda, 0xe6, 0x36, 0x0c
 };
 
+// SHA-256 of the RefX4 expansion of "a" for alice_random_data_ref, with
+// the coefficients in little-endian byte order.  Generated with the
+// SHAKE128 and SHA3-256 implementations in Python's hashlib.
+static uint8_t const public_params_hash_refx4[] PROGMEM = {
+    0xa1, 0xd8, 0xd5, 0xf9, 0x5b, 0x81, 0xad, 0x38, 0xd9, 0xd0, 0x7e, 0x4d,
+    0x1e, 0xe9, 0x52, 0x2e, 0xcd, 0x37, 0x57, 0x18, 0x9b, 0x3e, 0x9e, 0xef,
+    0xf8, 0x7e, 0xeb, 0x62, 0x62, 0x07, 0x20, 0x3f
+};
+
 uint8_t buffer[2048];
 uint8_t random_data[64];
 NewHopePrivateKey alice_private;
@@ -804,6 +814,33 @@ void testNewHopeRandom()
     else
         Serial.println("shared secrets do not match");
     Serial.println();
+
+    Serial.print("keygen refx4 ... ");
+    start = micros();
+    NewHope::keygen(buffer, alice_private, NewHope::RefX4);
+    elapsed = micros() - start;
+    Serial.print(elapsed);
+    Serial.println(" us");
+
+    Serial.print("sharedb ... ");
+    start = micros();
+    NewHope::sharedb(random_data, buffer, buffer, NewHope::RefX4);
+    elapsed = micros() - start;
+    Serial.print(elapsed);
+    Serial.println(" us");
+
+    Serial.print("shareda ... ");
+    start = micros();
+    NewHope::shareda(buffer, alice_private, buffer);
+    elapsed = micros() - start;
+    Serial.print(elapsed);
+    Serial.println(" us");
+
+    if (memcmp(random_data, buffer, 32) == 0)
+        Serial.println("shared secrets match");
+    else
+        Serial.println("shared secrets do not match");
+    Serial.println();
 }
 
 void testNewHopeFixed()
@@ -905,6 +942,136 @@ void testNewHopeFixed()
     Serial.println(" us");
 }
 
+void testNewHopeWorkspace()
+{
+    Serial.println();
+    Serial.println("Workspace tests:");
+    Serial.println();
+
+    NewHopeWorkspace *ws = new NewHopeWorkspace();
+    if (!ws) {
+        Serial.println("could not allocate workspace");
+        return;
+    }
+
+    Serial.print("keygen ref ... ");
+    memcpy_P(random_data, alice_random_data_ref, 64);
+    NewHope::keygen(buffer, alice_private, *ws, NewHope::Ref, random_data);
+    if (memcmp_P(buffer, alice_public_ref, 1824) == 0)
+        Serial.println("ok");
+    else
+        Serial.println("fail");
+
+    Serial.print("sharedb ... ");
+    memcpy_P(random_data, bob_random_data_ref, 32);
+    memcpy_P(buffer, alice_public_ref, 1824);
+    NewHope::sharedb(random_data, buffer, buffer, *ws, NewHope::Ref, random_data);
+    if (memcmp_P(buffer, bob_public_ref, 2048) == 0 &&
+            memcmp_P(random_data, shared_secret_ref, 32) == 0)
+        Serial.println("ok");
+    else
+        Serial.println("fail");
+
+    Serial.print("shareda ... ");
+    memcpy_P(buffer, bob_public_ref, 2048);
+    NewHope::shareda(buffer, alice_private, buffer, *ws);
+    if (memcmp_P(buffer, shared_secret_ref, 32) == 0)
+        Serial.println("ok");
+    else
+        Serial.println("fail");
+
+    delete ws;
+}
+
+void testNewHopePublicParams()
+{
+    Serial.println();
+    Serial.println("Cached public parameter tests:");
+    Serial.println();
+
+    NewHopePublicParams *params = new NewHopePublicParams();
+    if (!params) {
+        Serial.println("could not allocate public parameters");
+        return;
+    }
+
+    Serial.print("keygen ref ... ");
+    memcpy_P(random_data, alice_random_data_ref, 64);
+    NewHope::generatePublicParams(*params, 60000, NewHope::Ref, random_data);
+    NewHope::keygen(buffer, alice_private, *params, random_data + 32);
+    if (memcmp_P(buffer, alice_public_ref, 1824) == 0)
+        Serial.println("ok");
+    else
+        Serial.println("fail");
+
+    Serial.print("shareda ... ");
+    memcpy_P(buffer, bob_public_ref, 2048);
+    NewHope::shareda(buffer, alice_private, buffer);
+    if (memcmp_P(buffer, shared_secret_ref, 32) == 0)
+        Serial.println("ok");
+    else
+        Serial.println("fail");
+
+    Serial.print("keygen torref ... ");
+    memcpy_P(random_data, alice_random_data_torref, 64);
+    NewHope::generatePublicParams(*params, 60000, NewHope::Torref, random_data);
+    NewHope::keygen(buffer, alice_private, *params, random_data + 32);
+    if (memcmp_P(buffer, alice_public_torref, 1824) == 0)
+        Serial.println("ok");
+    else
+        Serial.println("fail");
+
+    Serial.print("random key exchange ... ");
+    NewHope::keygen(buffer, alice_private, *params);
+    NewHope::sharedb(random_data, buffer, buffer, NewHope::Torref);
+    NewHope::shareda(buffer, alice_private, buffer);
+    if (memcmp(random_data, buffer, 32) == 0)
+        Serial.println("ok");
+    else
+        Serial.println("fail");
+
+    // The RefX4 expansion of "a" must match the independently computed
+    // hash, and keygen() must produce the same public key with and
+    // without the cached parameter.
+    Serial.print("expand refx4 ... ");
+    memcpy_P(random_data, alice_random_data_ref, 64);
+    NewHope::generatePublicParams(*params, 60000, NewHope::RefX4, random_data);
+    SHA256 sha256;
+    uint8_t hash[32];
+    uint8_t hash2[32];
+    sha256.update(params->coeffs, sizeof(params->coeffs));
+    sha256.finalize(hash, sizeof(hash));
+    if (memcmp_P(hash, public_params_hash_refx4, 32) == 0)
+        Serial.println("ok");
+    else
+        Serial.println("fail");
+
+    Serial.print("keygen refx4 ... ");
+    NewHope::keygen(buffer, alice_private, *params, random_data + 32);
+    sha256.reset();
+    sha256.update(buffer, NEWHOPE_SENDABYTES);
+    sha256.finalize(hash, sizeof(hash));
+    NewHope::keygen(buffer, alice_private, NewHope::RefX4, random_data);
+    sha256.reset();
+    sha256.update(buffer, NEWHOPE_SENDABYTES);
+    sha256.finalize(hash2, sizeof(hash2));
+    if (memcmp(hash, hash2, 32) == 0)
+        Serial.println("ok");
+    else
+        Serial.println("fail");
+
+    Serial.print("refx4 key exchange ... ");
+    NewHope::keygen(buffer, alice_private, *params);
+    NewHope::sharedb(random_data, buffer, buffer, NewHope::RefX4);
+    NewHope::shareda(buffer, alice_private, buffer);
+    if (memcmp(random_data, buffer, 32) == 0)
+        Serial.println("ok");
+    else
+        Serial.println("fail");
+
+    delete params;
+}
+
 void setup()
 {
     Serial.begin(9600);
@@ -918,6 +1085,8 @@ void setup()
     Serial.println();
     testNewHopeRandom();
     testNewHopeFixed();
+    testNewHopeWorkspace();
+    testNewHopePublicParams();
 }
 
 void loop()
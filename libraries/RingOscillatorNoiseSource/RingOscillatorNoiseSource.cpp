@@ -130,6 +130,11 @@ RingOscillatorNoiseSource::RingOscillatorNoiseSource()
     : calState(NOISE_CALIBRATING)
     , lastSignal(millis())
 {
+    // The health tests see the raw jitter bits eight to a byte.  We only
+    // credit 1 bit of entropy for every 8 bits of debiased output, so
+    // claim the minimum of 1 bit of entropy per byte.
+    setHealthEntropy(1);
+
     // Initialize the bit collection routines.
     restart();
 
@@ -172,12 +177,12 @@ RingOscillatorNoiseSource::~RingOscillatorNoiseSource()
 #endif
 
     // Clean up.
-    clean(buffer);
+    extractor.reset();
 }
 
 bool RingOscillatorNoiseSource::calibrating() const
 {
-    return calState == NOISE_CALIBRATING;
+    return calState == NOISE_CALIBRATING || !healthy();
 }
 
 static uint16_t volatile out = 0;
@@ -205,28 +210,20 @@ void RingOscillatorNoiseSource::stir()
     unsigned long now = millis();
     cli();
     if (outBits >= 16) {
-        uint16_t bits = out;
+        uint8_t bits[2];
+        bits[0] = (uint8_t)(out >> 8);
+        bits[1] = (uint8_t)out;
         outBits = 0;
         sei();
-        for (uint8_t index = 0; index < 8; ++index) {
-            // Collect two bits of input and remove bias using the Von Neumann
-            // method.  If both bits are the same, then discard both.
-            // Otherwise choose one of the bits and output that one.
-            // We have to do this carefully so that instruction timing does
-            // not reveal the value of the bit that is chosen.
-            if ((bits ^ (bits << 1)) & 0x8000) {
-                // The bits are different: add the top-most to the buffer.
-                if (posn < sizeof(buffer)) {
-                    buffer[posn] = (buffer[posn] >> 1) |
-                                   (((uint8_t)(bits >> 8)) & (uint8_t)0x80);
-                    if (++bitNum >= 8) {
-                        ++posn;
-                        bitNum = 0;
-                    }
-                }
-            }
-            bits = bits << 2;
-        }
+
+        // Run the continuous health tests on the raw jitter bits and
+        // discard everything collected so far if they fail.  Otherwise
+        // remove bias from the bits using the Von Neumann method.
+        if (checkHealth(bits, sizeof(bits)))
+            extractor.extract(bits, sizeof(bits));
+        else
+            restart();
+        clean(bits);
     } else {
         // The "out" buffer isn't full yet.  Re-enable interrupts.
         sei();
@@ -246,8 +243,8 @@ void RingOscillatorNoiseSource::stir()
     // We credit 1 bit of entropy for every 8 bits of output because
     // ring oscillators aren't quite as good as a true noise source.
     // We have to collect a lot more data to get something random enough.
-    if (posn >= sizeof(buffer)) {
-        output(buffer, posn, posn);
+    if (extractor.full()) {
+        output(extractor.data(), extractor.size(), extractor.size());
         restart();
         calState = NOISE_NOT_CALIBRATING;
         lastSignal = now;
@@ -256,8 +253,5 @@ void RingOscillatorNoiseSource::stir()
 
 void RingOscillatorNoiseSource::restart()
 {
-    clean(buffer);
-    prevBit = 0;
-    posn = 0;
-    bitNum = 0;
+    extractor.reset();
 }
@@ -25,6 +25,7 @@
 
 #include <inttypes.h>
 #include "NoiseSource.h"
+#include "NoiseExtractor.h"
 
 class RingOscillatorNoiseSource : public NoiseSource
 {
@@ -37,11 +38,8 @@ public:
     void stir();
 
 private:
-    uint8_t prevBit;
-    uint8_t posn;
-    uint8_t bitNum;
     uint8_t calState;
-    uint8_t buffer[32];
+    NoiseExtractor extractor;
     unsigned long lastSignal;
 
     void restart();
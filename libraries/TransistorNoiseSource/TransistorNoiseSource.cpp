@@ -24,6 +24,10 @@
 #include "RNG.h"
 #include "Crypto.h"
 #include <Arduino.h>
+#if defined(__AVR__)
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#endif
 
 /**
  * \class TransistorNoiseSource TransistorNoiseSource.h <TransistorNoiseSource.h>
@@ -72,6 +76,27 @@
  * }
  * \endcode
  *
+ * By default the noise source is polled: every call to stir() performs a
+ * single analogRead() and it takes 1024 calls to produce a bucket of output.
+ * On AVR platforms the ADC can instead be placed into free-running mode
+ * by calling startSampling().  The ADC interrupt then collects samples
+ * in the background and stir() only needs to perform debiasing and
+ * threshold tracking on the samples that have already been collected:
+ *
+ * \code
+ * void setup() {
+ *     RNG.begin("MyApp 1.0");
+ *     RNG.addNoiseSource(noise);
+ *     noise.startSampling();
+ * }
+ * \endcode
+ *
+ * The interrupt mode takes over the ADC, so analogRead() should not be
+ * used on other pins until stopSampling() is called.  If the application
+ * needs its own ADC interrupt handler, then define
+ * TRANSISTOR_NOISE_NO_ISR when compiling the library and pass the
+ * conversion results to sampleInterrupt() from the application's handler.
+ *
  * \sa \link RNGClass RNG\endlink, NoiseSource, RingOscillatorNoiseSource
  */
 
@@ -101,6 +126,13 @@ then the delta between the minimum and maximum samples in the bucket will
 be quite small.  This is used to detect disconnection of the noise source.
 No output is generated when the noise source is disconnected.
 
+The raw samples are converted into threshold bits as they arrive and
+are packed into a ring of two 128-sample chunks.  One chunk is filled by
+stir() or the ADC interrupt while the other waits for stir() to debias
+it and update the statistics for the bucket.  If the application does
+not call stir() often enough in interrupt mode, then samples are dropped
+until a chunk becomes free.  Dropping samples does not bias the output.
+
 With 1024 raw input samples we get roughly 256 output bits after
 Von Neumann debiasing.  As a further check, the output will be discarded
 if less than 192 bits are generated.  This can happen when the noise source
@@ -126,10 +158,37 @@ to the new median level as the circuit's properties change.
 // the noise source to be considered as operating correctly.
 #define NOISE_SPREAD        (ADC_NUM / 8)
 
+// Number of bytes of packed threshold bits in a chunk.
+#define CHUNK_BYTES         (TRANSISTOR_NOISE_CHUNK / 8)
+
+// Determine if we can drive the ADC in free-running mode from an interrupt.
+#if defined(__AVR__) && defined(ADCSRA) && defined(ADATE)
+#define NOISE_ADC_AVR 1
+#elif defined(HOST_BUILD)
+#define NOISE_ADC_HOST 1
+#endif
+
 // Calibration states.
 #define NOISE_NOT_CALIBRATING   0
 #define NOISE_CALIBRATING       1
 
+// Compiler barrier for handing a chunk between addSample() and stir().
+// Only chunkReady[] is volatile, so without this the compiler could move
+// accesses to the chunk's bits and extremes across the flag update.
+#define NOISE_BARRIER() __asm__ __volatile__ ("" ::: "memory")
+
+// Noise source that currently owns the ADC interrupt.
+static TransistorNoiseSource *volatile activeSource = 0;
+
+#if defined(NOISE_ADC_AVR) && !defined(TRANSISTOR_NOISE_NO_ISR)
+
+ISR(ADC_vect)
+{
+    TransistorNoiseSource::sampleInterrupt(ADC);
+}
+
+#endif
+
 /**
  * \brief Constructs a new transitor-based noise source handler.
  *
@@ -139,61 +198,214 @@ TransistorNoiseSource::TransistorNoiseSource(uint8_t pin)
     : threshold(ADC_NUM / 2)
     , _pin(pin)
     , calState(NOISE_CALIBRATING)
+    , interruptMode(false)
 {
     // Configure the pin as an analog input with no pull-up.
     pinMode(pin, INPUT);
     digitalWrite(pin, LOW);
 
+    // The raw threshold bits are packed eight to a byte for the health
+    // tests.  Von Neumann debiasing keeps about a quarter of them and we
+    // credit half of what is left, so claim 1 bit of entropy per byte.
+    setHealthEntropy(1);
+
     // Start the bit collection routines.
+    resetSamples();
     restart();
 }
 
 TransistorNoiseSource::~TransistorNoiseSource()
 {
+    stopSampling();
+    resetSamples();
     restart();
 }
 
 bool TransistorNoiseSource::calibrating() const
 {
-    return calState != NOISE_NOT_CALIBRATING;
+    return calState != NOISE_NOT_CALIBRATING || !healthy();
 }
 
 void TransistorNoiseSource::stir()
 {
+    // In polled mode, take a single sample from the ADC on each call.
+    if (!interruptMode)
+        addSample(analogRead(_pin));
+
+    // Process any chunks that have been completely filled with samples.
+    while (chunkReady[drainChunk]) {
+        processChunk(drainChunk);
+        drainChunk ^= 1;
+    }
+}
+
+/**
+ * \brief Starts sampling the noise source from the ADC interrupt.
+ *
+ * \return Returns true if interrupt-driven sampling was started, or false
+ * if the platform does not support it or the ADC is already being used
+ * by another noise source.  Polled sampling continues if this function
+ * returns false.
+ *
+ * On AVR platforms this places the ADC into free-running mode with the
+ * same reference voltage and clock prescaler as analogRead().  The
+ * current bucket is discarded and collection restarts.
+ *
+ * \sa stopSampling(), sampling()
+ */
+bool TransistorNoiseSource::startSampling()
+{
+#if defined(NOISE_ADC_AVR) || defined(NOISE_ADC_HOST)
+    if (interruptMode)
+        return true;
+    if (activeSource)
+        return false;
+    resetSamples();
+    restart();
+    interruptMode = true;
+    activeSource = this;
+#if defined(NOISE_ADC_AVR)
+    uint8_t channel = _pin;
+#if defined(analogPinToChannel)
+    channel = analogPinToChannel(channel);
+#else
+    if (channel >= A0)
+        channel -= A0;
+#endif
+#if defined(MUX5)
+    ADCSRB = (channel & 0x08) ? (1 << MUX5) : 0;
+#elif defined(ADCSRB)
+    ADCSRB = 0;
+#endif
+    ADMUX = (1 << REFS0) | (channel & 0x07);
+    ADCSRA = (1 << ADEN) | (1 << ADSC) | (1 << ADATE) | (1 << ADIE) |
+             (1 << ADPS2) | (1 << ADPS1) | (1 << ADPS0);
+#else
+    analogStartFreeRunning(_pin, sampleInterrupt);
+#endif
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * \brief Stops sampling the noise source from the ADC interrupt and
+ * returns to polled sampling.
+ *
+ * \sa startSampling()
+ */
+void TransistorNoiseSource::stopSampling()
+{
+    if (!interruptMode)
+        return;
+#if defined(NOISE_ADC_AVR)
+    ADCSRA &= ~((1 << ADATE) | (1 << ADIE));
+#elif defined(NOISE_ADC_HOST)
+    analogStopFreeRunning();
+#endif
+    activeSource = 0;
+    interruptMode = false;
+    resetSamples();
+    restart();
+}
+
+/**
+ * \fn bool TransistorNoiseSource::sampling() const
+ * \brief Determine if the noise source is being sampled from the ADC
+ * interrupt.
+ *
+ * \sa startSampling()
+ */
+
+/**
+ * \brief Passes a conversion result from the ADC interrupt to the noise
+ * source that called startSampling().
+ *
+ * \param value The 10-bit conversion result.
+ *
+ * This is called automatically by the library's ADC interrupt handler.
+ * It only needs to be called by the application if the library was
+ * compiled with TRANSISTOR_NOISE_NO_ISR.
+ */
+void TransistorNoiseSource::sampleInterrupt(int value)
+{
+    TransistorNoiseSource *source = activeSource;
+    if (source)
+        source->addSample(value);
+}
+
+/**
+ * \brief Adds a raw sample to the chunk that is currently being filled.
+ *
+ * \param value The raw ADC value.
+ *
+ * This may be called from interrupt context so it does no more than
+ * convert the sample into a threshold bit and track the extremes.
+ */
+void TransistorNoiseSource::addSample(int value)
+{
+    // Drop the sample if stir() has not caught up with the ring yet.
+    uint8_t index = fillChunk;
+    if (chunkReady[index])
+        return;
+    NOISE_BARRIER();
+
     // Keep track of the minimum and maximum while generating data
     // so that we can detect when the input voltage falls too low
     // for the circuit to generate noise.
-    int value = analogRead(_pin);
-    if (value < minValue)
-        minValue = value;
-    if (value > maxValue)
-        maxValue = value;
-
-    // Collect two bits of input and remove bias using the Von Neumann method.
-    // If both bits are the same, then discard both.  Otherwise choose one
-    // of the bits and output that one.  We have to do this carefully so that
-    // instruction timing does not reveal the value of the bit that is chosen.
+    if (value < chunkMin[index])
+        chunkMin[index] = value;
+    if (value > chunkMax[index])
+        chunkMax[index] = value;
+
+    // Pack the threshold bit into the chunk, MSB first.
     uint8_t bit = ((threshold - value) >> 15) & 1; // Subtract and extract sign.
-    if (count & 1) {
-        if (prevBit ^ bit) {
-            // The bits are different: add the new bit to the buffer.
-            if (posn < sizeof(buffer)) {
-                buffer[posn] = (buffer[posn] << 1) | bit;
-                if (++bitNum >= 8) {
-                    ++posn;
-                    bitNum = 0;
-                }
-            }
-        }
-    } else {
-        prevBit = bit;
+    uint8_t *ptr = &(chunk[index][fillPosn / 8]);
+    *ptr = (*ptr << 1) | bit;
+    if (++fillPosn >= TRANSISTOR_NOISE_CHUNK) {
+        fillPosn = 0;
+        fillChunk = index ^ 1;
+        NOISE_BARRIER();
+        chunkReady[index] = 1;
     }
+}
 
-    // Keep a count of the number of raw 1 bits.
-    ones += bit;
+/**
+ * \brief Debiases a completed chunk of samples and updates the bucket.
+ *
+ * \param index The index of the chunk to process.
+ */
+void TransistorNoiseSource::processChunk(uint8_t index)
+{
+    // The caller has seen chunkReady[index] set.  Read the chunk after it.
+    NOISE_BARRIER();
+    if (chunkMin[index] < minValue)
+        minValue = chunkMin[index];
+    if (chunkMax[index] > maxValue)
+        maxValue = chunkMax[index];
+
+    // Run the continuous health tests on the raw threshold bits.
+    // The bucket is still used to adjust the threshold if they fail,
+    // but its output is discarded.
+    if (!checkHealth(chunk[index], CHUNK_BYTES))
+        healthOk = false;
+
+    // Remove bias from the bits using the Von Neumann method and
+    // keep a count of the number of raw 1 bits.
+    ones += extractor.extract(chunk[index], CHUNK_BYTES);
+
+    // Hand the chunk back to the sampler.  The extremes must be reset
+    // before the ready flag is cleared in case the interrupt fires.
+    clean(chunk[index]);
+    chunkMin[index] = ADC_NUM - 1;
+    chunkMax[index] = 0;
+    NOISE_BARRIER();
+    chunkReady[index] = 0;
 
     // Bail out if we haven't collected enough samples for a full bucket yet.
-    if (++count < SAMPLES_NUM)
+    count += TRANSISTOR_NOISE_CHUNK;
+    if (count < SAMPLES_NUM)
         return;
 
     // If the maximum minus the minimum is too small, then there probably
@@ -202,19 +414,20 @@ void TransistorNoiseSource::stir()
     if ((maxValue - minValue) < NOISE_SPREAD) {
         restart();
         calState = NOISE_CALIBRATING;
-        threshold = ADC_NUM / 2; // Reacquire threshold when the signal returns.
+        setThreshold(ADC_NUM / 2); // Reacquire threshold when the signal returns.
         return;
     }
 
     // If the number of 1's is between 45% and 55% of the total count,
     // then we have a good bucket.  The threshold is at an appropriate level.
     if (ones >= SAMPLES_PCT(45) && ones <= SAMPLES_PCT(55)) {
-        if (posn >= (sizeof(buffer) * 3 / 4)) {
+        size_t posn = extractor.size();
+        if (posn >= (NOISE_EXTRACTOR_SIZE * 3 / 4) && healthOk) {
             // The buffer is at least three-quarters full of debiased bits
             // so pass them onto output().  There may be less bits if we
             // lost or gained the signal half-way through the bucket.
             // Credit 4 bits of entropy for every 8 bits of output.
-            output(buffer, posn, posn * 4);
+            output(extractor.data(), posn, posn * 4);
         }
         restart();
         calState = NOISE_NOT_CALIBRATING;
@@ -223,36 +436,72 @@ void TransistorNoiseSource::stir()
 
     // The threshold is not close enough to the mid-point of the signal.
     // Adjust the threshold, discard the bucket, and try again.
+    int newThreshold = threshold;
     if (ones < SAMPLES_PCT(25) || ones > SAMPLES_PCT(75)) {
         // We are a long way away from the mid-point, so move the threshold
         // by a large amount based on the delta to get closer quicker.
-        threshold -= (SAMPLES_PCT(50) - ones) / 8;
+        newThreshold -= (SAMPLES_PCT(50) - ones) / 8;
     } else if (ones < SAMPLES_PCT(50)) {
         // Not enough ones so move the threshold down a bit.
-        --threshold;
+        --newThreshold;
     } else {
         // Too many ones so move the threshold up a bit.
-        ++threshold;
+        ++newThreshold;
     }
-    if (threshold < 0)
-        threshold = 0;
-    else if (threshold >= ADC_NUM)
-        threshold = ADC_NUM - 1;
+    if (newThreshold < 0)
+        newThreshold = 0;
+    else if (newThreshold >= ADC_NUM)
+        newThreshold = ADC_NUM - 1;
+    setThreshold(newThreshold);
     restart();
     calState = NOISE_CALIBRATING;
 }
 
+/**
+ * \brief Sets the threshold that is used by the sampler.
+ *
+ * \param value The new threshold.
+ *
+ * The threshold is larger than a byte, so the ADC interrupt must be
+ * blocked while it is updated on 8-bit platforms.
+ */
+void TransistorNoiseSource::setThreshold(int value)
+{
+#if defined(__AVR__)
+    uint8_t sreg = SREG;
+    cli();
+    threshold = value;
+    SREG = sreg;
+#else
+    threshold = value;
+#endif
+}
+
+/**
+ * \brief Discards all samples in the double-buffered sample ring.
+ */
+void TransistorNoiseSource::resetSamples()
+{
+    clean(chunk);
+    for (uint8_t index = 0; index < 2; ++index) {
+        chunkMin[index] = ADC_NUM - 1;
+        chunkMax[index] = 0;
+        chunkReady[index] = 0;
+    }
+    fillChunk = 0;
+    fillPosn = 0;
+    drainChunk = 0;
+}
+
 /**
  * \brief Restarts the bit collection process for the next bucket.
  */
 void TransistorNoiseSource::restart()
 {
-    clean(buffer);
-    prevBit = 0;
-    posn = 0;
-    bitNum = 0;
+    extractor.reset();
     minValue = ADC_NUM - 1;
     maxValue = 0;
     count = 0;
     ones = 0;
+    healthOk = true;
 }
@@ -25,6 +25,10 @@
 
 #include <inttypes.h>
 #include "NoiseSource.h"
+#include "NoiseExtractor.h"
+
+// Number of raw samples in each half of the double-buffered sample ring.
+#define TRANSISTOR_NOISE_CHUNK  128
 
 class TransistorNoiseSource : public NoiseSource
 {
@@ -36,19 +40,38 @@ public:
 
     void stir();
 
+    bool startSampling();
+    void stopSampling();
+    bool sampling() const { return interruptMode; }
+
+    static void sampleInterrupt(int value);
+
 private:
     int threshold;
     uint8_t _pin;
-    uint8_t prevBit;
-    uint8_t posn;
-    uint8_t bitNum;
     uint8_t calState;
-    uint8_t buffer[32];
+    NoiseExtractor extractor;
     int minValue;
     int maxValue;
     int count;
     int ones;
+    bool healthOk;
+
+    // Double-buffered ring of packed threshold bits.  One chunk is filled
+    // by stir() or the ADC interrupt while the other waits to be processed.
+    uint8_t chunk[2][TRANSISTOR_NOISE_CHUNK / 8];
+    int chunkMin[2];
+    int chunkMax[2];
+    volatile uint8_t chunkReady[2];
+    uint8_t fillChunk;
+    uint8_t fillPosn;
+    uint8_t drainChunk;
+    bool interruptMode;
 
+    void addSample(int value);
+    void processChunk(uint8_t index);
+    void setThreshold(int value);
+    void resetSamples();
     void restart();
 };
 
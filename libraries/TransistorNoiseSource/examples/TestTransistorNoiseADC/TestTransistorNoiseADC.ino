@@ -0,0 +1,219 @@
+/*
+ * Copyright (C) 2015 Southern Storm Software, Pty Ltd.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+/*
+This example runs regression tests on the TransistorNoiseSource class
+using the emulated ADC in the host build.  It checks that interrupt-driven
+sampling produces the same output as polled sampling for the same input,
+and that the health tests reject a signal that is not noisy.
+*/
+
+#include <Crypto.h>
+#include <TransistorNoiseSource.h>
+#include <string.h>
+
+#if defined(HOST_BUILD)
+
+#define MAX_CAPTURE 512
+
+class CaptureNoiseSource : public TransistorNoiseSource
+{
+public:
+    CaptureNoiseSource(uint8_t pin)
+        : TransistorNoiseSource(pin), len(0), outputs(0) {}
+
+    uint8_t data[MAX_CAPTURE];
+    size_t len;
+    unsigned outputs;
+
+protected:
+    void output(const uint8_t *data, size_t len, unsigned int credit)
+    {
+        if (len > (MAX_CAPTURE - this->len))
+            len = MAX_CAPTURE - this->len;
+        memcpy(this->data + this->len, data, len);
+        this->len += len;
+        ++outputs;
+    }
+};
+
+static uint32_t feedState;
+
+// Pseudo-random signal centred on the middle of the ADC range.
+int noiseFeed(uint8_t pin)
+{
+    int value = 0;
+    for (uint8_t index = 0; index < 4; ++index) {
+        feedState ^= feedState << 13;
+        feedState ^= feedState >> 17;
+        feedState ^= feedState << 5;
+        value += feedState & 0xFF;
+    }
+    return value;
+}
+
+// Disconnected noise source with no variation in the signal.
+int flatFeed(uint8_t pin)
+{
+    return 600;
+}
+
+// Square wave that swings across the whole ADC range.  The threshold bits
+// are perfectly balanced, but follow a fixed pattern.
+int squareFeed(uint8_t pin)
+{
+    static bool high = false;
+    high = !high;
+    return high ? 1000 : 24;
+}
+
+CaptureNoiseSource polled(A1);
+CaptureNoiseSource sampled(A1);
+CaptureNoiseSource other(A2);
+
+void testPolled()
+{
+    Serial.print("Polled ... ");
+    feedState = 0x12345678;
+    analogSetFeed(noiseFeed);
+    for (int count = 0; count < 16384; ++count)
+        polled.stir();
+    if (polled.outputs >= 8 && !polled.calibrating() && !polled.sampling()) {
+        Serial.println("Passed");
+    } else {
+        Serial.println("Failed");
+    }
+}
+
+void testInterrupt()
+{
+    Serial.print("Interrupt ... ");
+    feedState = 0x12345678;
+    analogSetFeed(noiseFeed);
+    bool ok = sampled.startSampling() && sampled.sampling();
+    if (other.startSampling())
+        ok = false;
+    for (int count = 0; count < (16384 / TRANSISTOR_NOISE_CHUNK); ++count) {
+        analogConvert(TRANSISTOR_NOISE_CHUNK);
+        sampled.stir();
+    }
+    if (sampled.outputs != polled.outputs || sampled.len != polled.len ||
+            memcmp(sampled.data, polled.data, polled.len) != 0)
+        ok = false;
+    if (sampled.calibrating())
+        ok = false;
+    if (ok) {
+        Serial.println("Passed");
+    } else {
+        Serial.println("Failed");
+    }
+}
+
+void testOverrun()
+{
+    Serial.print("Overrun ... ");
+    analogSetFeed(noiseFeed);
+    unsigned outputs = sampled.outputs;
+    bool ok = true;
+    for (int count = 0; count < 32; ++count) {
+        // Deliver four chunks of samples between stir() calls.
+        // The ring holds two, so the rest must be dropped.
+        analogConvert(TRANSISTOR_NOISE_CHUNK * 4);
+        sampled.stir();
+    }
+    if (sampled.outputs != (outputs + 8))
+        ok = false;
+    if (ok) {
+        Serial.println("Passed");
+    } else {
+        Serial.println("Failed");
+    }
+}
+
+void testDisconnect()
+{
+    Serial.print("Disconnect ... ");
+    analogSetFeed(flatFeed);
+    unsigned outputs = sampled.outputs;
+    for (int count = 0; count < 32; ++count) {
+        analogConvert(TRANSISTOR_NOISE_CHUNK);
+        sampled.stir();
+    }
+    bool ok = sampled.calibrating() && sampled.outputs == outputs;
+    sampled.stopSampling();
+    if (sampled.sampling() || !other.startSampling())
+        ok = false;
+    other.stopSampling();
+    if (ok) {
+        Serial.println("Passed");
+    } else {
+        Serial.println("Failed");
+    }
+}
+
+void testPattern()
+{
+    Serial.print("Pattern ... ");
+    CaptureNoiseSource pattern(A3);
+    analogSetFeed(squareFeed);
+    for (int count = 0; count < 16384; ++count)
+        pattern.stir();
+    bool ok = pattern.calibrating() && !pattern.healthy() &&
+              pattern.outputs == 0;
+
+    // The source should recover once the noise returns.
+    feedState = 0x12345678;
+    analogSetFeed(noiseFeed);
+    for (int count = 0; count < 16384; ++count)
+        pattern.stir();
+    if (pattern.calibrating() || !pattern.healthy() || pattern.outputs == 0)
+        ok = false;
+    if (ok) {
+        Serial.println("Passed");
+    } else {
+        Serial.println("Failed");
+    }
+}
+
+#endif
+
+void setup()
+{
+    Serial.begin(9600);
+
+    Serial.println();
+
+#if defined(HOST_BUILD)
+    testPolled();
+    testInterrupt();
+    testOverrun();
+    testDisconnect();
+    testPattern();
+#else
+    Serial.println("This test requires the emulated ADC in the host build");
+#endif
+}
+
+void loop()
+{
+}